@@ -6,6 +6,9 @@
 #include "pch.h"
 #include "AquariumApp.h"
 #include <MainFrame.h>
+#include <AssetPreloader.h>
+#include <SpritePack.h>
+#include <wx/cmdline.h>
 
 bool AquariumApp::OnInit()
 {
@@ -15,9 +18,52 @@ bool AquariumApp::OnInit()
     // Add image type handlers
     wxInitAllImageHandlers();
 
+    if (mHeadless.IsEnabled())
+    {
+        // No window, OnRun does the work
+        return true;
+    }
+
+    // Decode the images the sprite pack does not have up to date
+    // copies of, in the background while the window opens
+    auto files = AssetPreloader::ReadManifest(AssetManifestName);
+    SpritePack pack;
+    if (pack.Open(SpritePackName))
+    {
+        std::erase_if(files, [&pack](const std::wstring& file) { return pack.Find(file) != nullptr; });
+    }
+    AssetPreloader::Get().Start(files);
+
     auto frame = new MainFrame();
     frame->Initialize();
     frame->Show(true);
 
     return true;
 }
+
+void AquariumApp::OnInitCmdLine(wxCmdLineParser& parser)
+{
+    wxApp::OnInitCmdLine(parser);
+    HeadlessRunner::AddOptions(parser);
+}
+
+bool AquariumApp::OnCmdLineParsed(wxCmdLineParser& parser)
+{
+    return wxApp::OnCmdLineParsed(parser) && mHeadless.ParseOptions(parser);
+}
+
+int AquariumApp::OnRun()
+{
+    if (mHeadless.IsEnabled())
+    {
+        return mHeadless.Run();
+    }
+
+    return wxApp::OnRun();
+}
+
+int AquariumApp::OnExit()
+{
+    AssetPreloader::Get().Stop();
+    return wxApp::OnExit();
+}
@@ -9,6 +9,7 @@
 #define AQUARIUMAPP_H
 
 #include <wx/wx.h>
+#include <HeadlessRunner.h>
 
 /**
  * @class AquariumApp
@@ -21,6 +22,10 @@
 
 
 class AquariumApp : public wxApp {
+private:
+ /// Runs the aquarium without a window if asked to on the command line
+ HeadlessRunner mHeadless;
+
 public:
  /**
  * @brief Initializes the Aquarium application.
@@ -31,6 +36,31 @@ public:
  */
  bool OnInit() override;
 
+ /**
+  * @brief Add our options to the command line parser.
+  * @param parser The application's command line parser
+  */
+ void OnInitCmdLine(wxCmdLineParser& parser) override;
+
+ /**
+  * @brief Read our options from the parsed command line.
+  * @param parser The application's command line parser
+  * @return False if the options are invalid
+  */
+ bool OnCmdLineParsed(wxCmdLineParser& parser) override;
+
+ /**
+  * @brief Run the main loop, or the headless runner if one was requested.
+  * @return Process exit code
+  */
+ int OnRun() override;
+
+ /**
+  * @brief Release the preloaded images before the application exits.
+  * @return Process exit code
+  */
+ int OnExit() override;
+
 };
 
 
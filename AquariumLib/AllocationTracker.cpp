@@ -0,0 +1,331 @@
+/**
+ * @file AllocationTracker.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "AllocationTracker.h"
+#include <cstdlib>
+#include <new>
+
+thread_local AllocationSubsystem AllocationTracker::sSubsystem = AllocationSubsystem::Other;
+
+/// Names of the subsystems, in AllocationSubsystem order
+static const wchar_t* SubsystemNames[AllocationSubsystemCount] = {L"Other", L"Update", L"Draw", L"Input", L"File"};
+
+/**
+ * Get the total over every subsystem
+ * @return Allocations and bytes of all subsystems together
+ */
+AllocationCount AllocationCounts::GetTotal() const
+{
+    AllocationCount total;
+    for (const auto& count : subsystems)
+    {
+        total.allocations += count.allocations;
+        total.bytes += count.bytes;
+    }
+
+    return total;
+}
+
+/**
+ * Get the allocations made between two moments
+ * @param other The earlier counts
+ * @return The difference for each subsystem
+ */
+AllocationCounts AllocationCounts::operator-(const AllocationCounts& other) const
+{
+    AllocationCounts difference;
+    for (int i = 0; i < AllocationSubsystemCount; i++)
+    {
+        difference.subsystems[i].allocations = subsystems[i].allocations - other.subsystems[i].allocations;
+        difference.subsystems[i].bytes = subsystems[i].bytes - other.subsystems[i].bytes;
+    }
+
+    return difference;
+}
+
+/**
+ * Start counting allocations. Counts carry on from where they were.
+ */
+void AllocationTracker::Start()
+{
+    sEnabled = true;
+}
+
+/**
+ * Stop counting allocations. The counts are kept.
+ */
+void AllocationTracker::Stop()
+{
+    sEnabled = false;
+}
+
+/**
+ * Set every count back to zero
+ */
+void AllocationTracker::Reset()
+{
+    for (int i = 0; i < AllocationSubsystemCount; i++)
+    {
+        sAllocations[i] = 0;
+        sBytes[i] = 0;
+    }
+}
+
+/**
+ * Count an allocation against the calling thread's subsystem
+ * @param bytes Size of the allocation
+ */
+void AllocationTracker::Count(size_t bytes)
+{
+    if (IsEnabled())
+    {
+        auto subsystem = (int)sSubsystem;
+        sAllocations[subsystem].fetch_add(1, std::memory_order_relaxed);
+        sBytes[subsystem].fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Make the calling thread count allocations against a subsystem
+ * @param subsystem The subsystem
+ * @return The subsystem the thread was in before
+ */
+AllocationSubsystem AllocationTracker::Enter(AllocationSubsystem subsystem)
+{
+    auto previous = sSubsystem;
+    sSubsystem = subsystem;
+    return previous;
+}
+
+/**
+ * Get the allocations counted against a subsystem
+ * @param subsystem The subsystem
+ * @return Allocations and bytes
+ */
+AllocationCount AllocationTracker::Get(AllocationSubsystem subsystem)
+{
+    AllocationCount count;
+    count.allocations = sAllocations[(int)subsystem].load(std::memory_order_relaxed);
+    count.bytes = sBytes[(int)subsystem].load(std::memory_order_relaxed);
+    return count;
+}
+
+/**
+ * Get the allocations counted against every subsystem
+ * @return The counts
+ */
+AllocationCounts AllocationTracker::GetCounts()
+{
+    AllocationCounts counts;
+    for (int i = 0; i < AllocationSubsystemCount; i++)
+    {
+        counts.subsystems[i] = Get((AllocationSubsystem)i);
+    }
+
+    return counts;
+}
+
+/**
+ * Get the name of a subsystem
+ * @param subsystem The subsystem
+ * @return Name to show the user
+ */
+const wchar_t* AllocationTracker::GetName(AllocationSubsystem subsystem)
+{
+    return SubsystemNames[(int)subsystem];
+}
+
+/**
+ * Format counts for the status bar, listing only
+ * the subsystems that allocated anything
+ * @param counts Counts to format, usually for one frame
+ * @return Text like "3 allocs, 96 B (Draw 3)"
+ */
+wxString AllocationTracker::Format(const AllocationCounts& counts)
+{
+    auto total = counts.GetTotal();
+    auto text = wxString::Format(L"%llu allocs, %llu B",
+                                 (unsigned long long)total.allocations, (unsigned long long)total.bytes);
+
+    wxString details;
+    for (int i = 0; i < AllocationSubsystemCount; i++)
+    {
+        if (counts.subsystems[i].allocations > 0)
+        {
+            details += details.IsEmpty() ? L" (" : L", ";
+            details += wxString::Format(L"%ls %llu", SubsystemNames[i],
+                                        (unsigned long long)counts.subsystems[i].allocations);
+        }
+    }
+
+    if (!details.IsEmpty())
+    {
+        text += details + L")";
+    }
+
+    return text;
+}
+
+#ifdef AQUARIUM_ALLOCATION_TRACKING
+
+//
+// Replacements for the global allocation functions. Each counts
+// the allocation, then hands it to the C runtime.
+//
+
+/**
+ * Allocate and count a block
+ * @param size Bytes needed
+ * @return The block, nullptr if out of memory
+ */
+static void* Allocate(size_t size)
+{
+    AllocationTracker::Count(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+/**
+ * Allocate and count an aligned block
+ * @param size Bytes needed
+ * @param alignment Alignment, a power of two
+ * @return The block, nullptr if out of memory
+ */
+static void* AllocateAligned(size_t size, std::align_val_t alignment)
+{
+    AllocationTracker::Count(size);
+    auto align = (size_t)alignment;
+#ifdef _MSC_VER
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+/**
+ * Free an aligned block
+ * @param block Block from AllocateAligned
+ */
+static void FreeAligned(void* block)
+{
+#ifdef _MSC_VER
+    _aligned_free(block);
+#else
+    std::free(block);
+#endif
+}
+
+void* operator new(size_t size)
+{
+    auto block = Allocate(size);
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return Allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    auto block = AllocateAligned(size, alignment);
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept
+{
+    std::free(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept
+{
+    FreeAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept
+{
+    FreeAligned(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept
+{
+    FreeAligned(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept
+{
+    FreeAligned(block);
+}
+
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(block);
+}
+
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    FreeAligned(block);
+}
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file AllocationTracker.h
+ * @author Josh Thomas
+ * @brief Header file for the AllocationTracker class and the allocation scope macro.
+ *
+ * When the library is built with AQUARIUM_ALLOCATION_TRACKING, the
+ * global operator new is replaced with one that counts every heap
+ * allocation while the tracker is started. Mark the scope of a
+ * subsystem with AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::Draw)
+ * so its allocations are counted separately.
+ */
+
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * The parts of the program allocations are counted against
+ */
+enum class AllocationSubsystem
+{
+    Other,
+    Update,
+    Draw,
+    Input,
+    File,
+    Count
+};
+
+/// Number of subsystems allocations are counted against
+const int AllocationSubsystemCount = (int)AllocationSubsystem::Count;
+
+/**
+ * @struct AllocationCount
+ * @brief Allocations made and the bytes they asked for.
+ */
+struct AllocationCount
+{
+    /// Number of allocations
+    uint64_t allocations = 0;
+
+    /// Total bytes asked for
+    uint64_t bytes = 0;
+};
+
+/**
+ * @struct AllocationCounts
+ * @brief The allocation count of every subsystem at one moment.
+ *
+ * Take one at the start and end of a frame and subtract
+ * them to get the allocations made during the frame.
+ */
+struct AllocationCounts
+{
+    /// Count for each subsystem
+    AllocationCount subsystems[AllocationSubsystemCount];
+
+    AllocationCount GetTotal() const;
+    AllocationCounts operator-(const AllocationCounts& other) const;
+};
+
+/**
+ * @class AllocationTracker
+ * @brief Counts heap allocations per subsystem.
+ *
+ * Counting is off until Start is called, so a build with tracking
+ * compiled in only pays for a relaxed atomic load per allocation.
+ * Frees are not counted, since a steady-state frame should not
+ * allocate at all.
+ */
+class AllocationTracker
+{
+private:
+    /// Subsystem the calling thread is in
+    static thread_local AllocationSubsystem sSubsystem;
+
+    /// True while counting
+    inline static std::atomic<bool> sEnabled{false};
+
+    /// Allocations made by each subsystem
+    inline static std::atomic<uint64_t> sAllocations[AllocationSubsystemCount];
+
+    /// Bytes asked for by each subsystem
+    inline static std::atomic<uint64_t> sBytes[AllocationSubsystemCount];
+
+public:
+    /**
+     * Is allocation tracking compiled in?
+     * @return true if Start will count anything
+     */
+    static constexpr bool IsBuiltIn()
+    {
+#ifdef AQUARIUM_ALLOCATION_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * Are allocations being counted?
+     * @return true if counting
+     */
+    static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    static void Start();
+    static void Stop();
+    static void Reset();
+    static void Count(size_t bytes);
+    static AllocationSubsystem Enter(AllocationSubsystem subsystem);
+    static AllocationCount Get(AllocationSubsystem subsystem);
+    static AllocationCounts GetCounts();
+    static const wchar_t* GetName(AllocationSubsystem subsystem);
+    static wxString Format(const AllocationCounts& counts);
+};
+
+/**
+ * @class AllocationScope
+ * @brief Counts allocations against a subsystem until destroyed.
+ *
+ * Scopes nest. The innermost one wins and the outer
+ * subsystem is restored when it ends.
+ */
+class AllocationScope
+{
+private:
+    /// Subsystem to go back to
+    AllocationSubsystem mPrevious;
+
+public:
+    /**
+     * Constructor
+     * @param subsystem Subsystem to count allocations against
+     */
+    explicit AllocationScope(AllocationSubsystem subsystem) : mPrevious(AllocationTracker::Enter(subsystem)) {}
+
+    /**
+     * Destructor. Goes back to the enclosing subsystem.
+     */
+    ~AllocationScope() { AllocationTracker::Enter(mPrevious); }
+
+    /// Copy constructor (disabled)
+    AllocationScope(const AllocationScope&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AllocationScope&) = delete;
+};
+
+/// Helpers that give each scope variable a unique name
+#define AQUARIUM_ALLOCATION_JOIN2(a, b) a##b
+#define AQUARIUM_ALLOCATION_JOIN(a, b) AQUARIUM_ALLOCATION_JOIN2(a, b)
+
+/**
+ * Count allocations in the rest of the enclosing scope against a subsystem
+ * @param subsystem An AllocationSubsystem
+ */
+#ifdef AQUARIUM_ALLOCATION_TRACKING
+#define AQUARIUM_ALLOCATION_SCOPE(subsystem) \
+    AllocationScope AQUARIUM_ALLOCATION_JOIN(allocationScope, __LINE__)(subsystem)
+#else
+#define AQUARIUM_ALLOCATION_SCOPE(subsystem) ((void)0)
+#endif
+
+#endif //ALLOCATIONTRACKER_H
@@ -0,0 +1,161 @@
+/**
+ * @file AquaBinary.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "AquaBinary.h"
+#include "MappedFile.h"
+#include <wx/stream.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * Does a block of data start with the binary .aqua magic bytes?
+ * @param data Start of the data
+ * @param size Size of the data in bytes
+ * @return true if this is a binary .aqua file
+ */
+bool AquaBinary::IsBinary(const char* data, size_t size)
+{
+    return size >= sizeof(AquaBinaryMagic) && memcmp(data, AquaBinaryMagic, sizeof(AquaBinaryMagic)) == 0;
+}
+
+/**
+ * Should a file of this name be saved in the binary format?
+ * @param filename File name
+ * @return true if the name ends in BinaryExtension
+ */
+bool AquaBinary::IsBinaryName(const wxString& filename)
+{
+    return filename.Lower().EndsWith(BinaryExtension);
+}
+
+/**
+ * Write a snapshot in the binary .aqua format
+ * @param stream Stream to write to
+ * @param snapshot Items to write
+ * @param progress Optional, called as the records are written
+ * @return true if successful
+ */
+bool AquaBinary::Write(wxOutputStream& stream, const AquaSnapshot& snapshot, const SnapshotProgress& progress)
+{
+    string table;
+    for (const auto& name : snapshot.species)
+    {
+        table += wxString(name).ToUTF8().data();
+        table += '\0';
+    }
+
+    // Pad so the records that follow are 8 byte aligned
+    table.resize((table.size() + 7) / 8 * 8, '\0');
+
+    AquaBinaryHeader header;
+    memcpy(header.magic, AquaBinaryMagic, sizeof(header.magic));
+    header.version = AquaBinaryVersion;
+    header.recordSize = sizeof(ItemRecord);
+    header.speciesCount = (uint32_t)snapshot.species.size();
+    header.speciesBytes = (uint32_t)table.size();
+    header.itemCount = snapshot.records.size();
+
+    if (stream.Write(&header, sizeof(header)).LastWrite() != sizeof(header) ||
+        stream.Write(table.data(), table.size()).LastWrite() != table.size())
+    {
+        return false;
+    }
+
+    // The records go out in chunks so we can report progress
+    auto total = snapshot.records.size();
+    for (size_t written = 0; written < total;)
+    {
+        auto count = min(total - written, SnapshotProgressInterval);
+        auto bytes = count * sizeof(ItemRecord);
+        if (stream.Write(snapshot.records.data() + written, bytes).LastWrite() != bytes)
+        {
+            return false;
+        }
+
+        written += count;
+        if (progress)
+        {
+            progress(written, total);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Read a binary .aqua file.
+ *
+ * The records are not copied; they point into the mapped file
+ * and remain valid only as long as the file stays open.
+ *
+ * @param file The mapped file to read
+ * @param species Receives the species table
+ * @param records Receives a pointer to the first record
+ * @param count Receives the number of records
+ * @return false if the file is not a valid binary .aqua file
+ */
+bool AquaBinary::Read(const MappedFile& file, std::vector<std::wstring>* species,
+                      const ItemRecord** records, size_t* count)
+{
+    return Read(file.GetData(), file.GetSize(), species, records, count);
+}
+
+/**
+ * Read binary .aqua data already in memory.
+ *
+ * The data must be 8 byte aligned. The records point into it.
+ *
+ * @param data Start of the data
+ * @param size Size of the data in bytes
+ * @param species Receives the species table
+ * @param records Receives a pointer to the first record
+ * @param count Receives the number of records
+ * @return false if the data is not valid binary .aqua data
+ */
+bool AquaBinary::Read(const char* data, size_t size, std::vector<std::wstring>* species,
+                      const ItemRecord** records, size_t* count)
+{
+    if (!IsBinary(data, size) || size < sizeof(AquaBinaryHeader))
+    {
+        return false;
+    }
+
+    AquaBinaryHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.version != AquaBinaryVersion || header.recordSize != sizeof(ItemRecord) ||
+        header.speciesBytes % 8 != 0)
+    {
+        return false;
+    }
+
+    // Make sure the file is as big as the header says before we touch anything
+    auto tableEnd = sizeof(header) + (size_t)header.speciesBytes;
+    if (tableEnd > size || header.itemCount > (size - tableEnd) / sizeof(ItemRecord))
+    {
+        return false;
+    }
+
+    species->clear();
+    auto name = data + sizeof(header);
+    auto end = data + tableEnd;
+    for (uint32_t i = 0; i < header.speciesCount; i++)
+    {
+        auto length = strnlen(name, end - name);
+        if (name + length >= end)
+        {
+            return false;
+        }
+
+        species->push_back(wxString::FromUTF8(name, length).ToStdWstring());
+        name += length + 1;
+    }
+
+    *records = reinterpret_cast<const ItemRecord*>(end);
+    *count = (size_t)header.itemCount;
+    return true;
+}
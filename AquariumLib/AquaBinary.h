@@ -0,0 +1,75 @@
+/**
+ * @file AquaBinary.h
+ * @author Josh Thomas
+ * @brief Header file for the binary .aqua format.
+ *
+ * Layout, all little-endian:
+ *  - AquaBinaryHeader
+ *  - species table: speciesCount NUL terminated UTF-8 type
+ *    names, zero padded to speciesBytes (a multiple of 8)
+ *  - itemCount ItemRecord structures
+ */
+
+#ifndef AQUABINARY_H
+#define AQUABINARY_H
+
+#include "ItemRecord.h"
+
+class MappedFile;
+class wxOutputStream;
+
+/// Magic bytes at the start of every binary .aqua file
+const char AquaBinaryMagic[8] = {'A', 'Q', 'U', 'A', 'B', 'I', 'N', '\x1a'};
+
+/// Extension of binary aquarium files. Loading goes by the
+/// magic bytes, so the extension is only for people to see.
+const wchar_t BinaryExtension[] = L".aqb";
+
+/// Current version of the binary format
+const uint32_t AquaBinaryVersion = 1;
+
+/**
+ * @struct AquaBinaryHeader
+ * @brief The header at the start of a binary .aqua file.
+ */
+struct AquaBinaryHeader
+{
+    /// Always AquaBinaryMagic
+    char magic[8];
+
+    /// Format version, AquaBinaryVersion when written
+    uint32_t version;
+
+    /// sizeof(ItemRecord) when written
+    uint32_t recordSize;
+
+    /// Number of names in the species table
+    uint32_t speciesCount;
+
+    /// Size of the species table in bytes
+    uint32_t speciesBytes;
+
+    /// Number of item records
+    uint64_t itemCount;
+};
+
+static_assert(sizeof(AquaBinaryHeader) == 32, "AquaBinaryHeader is an on-disk format");
+
+/**
+ * @class AquaBinary
+ * @brief Reads and writes the binary .aqua format.
+ */
+class AquaBinary
+{
+public:
+    static bool IsBinary(const char* data, size_t size);
+    static bool IsBinaryName(const wxString& filename);
+    static bool Write(wxOutputStream& stream, const AquaSnapshot& snapshot,
+                      const SnapshotProgress& progress = nullptr);
+    static bool Read(const MappedFile& file, std::vector<std::wstring>* species,
+                     const ItemRecord** records, size_t* count);
+    static bool Read(const char* data, size_t size, std::vector<std::wstring>* species,
+                     const ItemRecord** records, size_t* count);
+};
+
+#endif //AQUABINARY_H
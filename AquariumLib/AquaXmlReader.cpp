@@ -0,0 +1,198 @@
+/**
+ * @file AquaXmlReader.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "AquaXmlReader.h"
+#include <wx/stream.h>
+#include <wx/strconv.h>
+#include <expat.h>
+#include <cstring>
+
+using namespace std;
+
+static_assert(sizeof(XML_Char) == sizeof(char), "The reader expects expat to pass UTF-8");
+
+/// Name of the elements we hand to the handler
+const char ItemElement[] = "item";
+
+/**
+ * Tell expat how to read an encoding it does not know itself.
+ *
+ * Expat only knows UTF-8, UTF-16, ISO-8859-1 and US-ASCII. Any
+ * other single byte encoding wxWidgets can convert is mapped a
+ * byte at a time, the same way wxXmlDocument does it.
+ *
+ * @param data Unused
+ * @param name Name of the encoding from the XML declaration
+ * @param info Receives the map from bytes to code points
+ * @return XML_STATUS_OK if the encoding can be read
+ */
+static int UnknownEncoding(void* data, const XML_Char* name, XML_Encoding* info)
+{
+    wxCSConv conv(wxString::FromUTF8(name));
+    if (!conv.IsOk())
+    {
+        return XML_STATUS_ERROR;
+    }
+
+    char in[2] = {0, 0};
+    wchar_t out[2];
+    for (int i = 0; i < 256; i++)
+    {
+        in[0] = (char)i;
+        info->map[i] = conv.MB2WC(out, in, 2) == wxCONV_FAILED ? -1 : (int)out[0];
+    }
+
+    info->data = nullptr;
+    info->convert = nullptr;
+    info->release = nullptr;
+    return XML_STATUS_OK;
+}
+
+/**
+ * Read a document, calling the handler for each item.
+ * @param stream Stream to read from
+ * @param handler Called with each <item> child of the root as it closes
+ * @return false if the document is not well formed
+ */
+bool AquaXmlReader::Read(wxInputStream& stream, const ItemHandler& handler)
+{
+    mParser = XML_ParserCreate(nullptr);
+    if (mParser == nullptr)
+    {
+        return false;
+    }
+
+    mHandler = &handler;
+    mDepth = 0;
+    mAttributes.clear();
+    mStopped = false;
+
+    XML_SetUserData(mParser, this);
+    XML_SetElementHandler(mParser, StartElement, EndElement);
+    XML_SetUnknownEncodingHandler(mParser, UnknownEncoding, nullptr);
+
+    bool parsed = true;
+    for (;;)
+    {
+        stream.Read(mBuffer, BufferSize);
+        auto read = stream.LastRead();
+        bool last = read == 0;
+        if (XML_Parse(mParser, mBuffer, (int)read, last) != XML_STATUS_OK)
+        {
+            parsed = false;
+            break;
+        }
+
+        if (last)
+        {
+            break;
+        }
+    }
+
+    XML_ParserFree(mParser);
+    mParser = nullptr;
+    mHandler = nullptr;
+    return parsed && !mStopped && stream.GetLastError() != wxSTREAM_READ_ERROR;
+}
+
+/**
+ * Stop reading. Call from the item handler; Read returns false.
+ */
+void AquaXmlReader::Stop()
+{
+    mStopped = true;
+    if (mParser != nullptr)
+    {
+        XML_StopParser(mParser, XML_FALSE);
+    }
+}
+
+/**
+ * Does a block of data start with the gzip magic bytes?
+ * @param data Start of the data
+ * @param size Size of the data in bytes
+ * @return true if this is a gzip compressed file
+ */
+bool AquaXmlReader::IsCompressed(const char* data, size_t size)
+{
+    return size >= 2 && (unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b;
+}
+
+/**
+ * Read the state of an item from its node.
+ *
+ * The attributes are the ones AquaXmlWriter writes, x and y, and
+ * speedx and speedy for fish. Every XML load reads items this way,
+ * whether it builds them at once or hands the records to another
+ * thread. The species is left to the caller.
+ *
+ * @param node Item node as passed to an ItemHandler
+ * @param record Record to fill in
+ */
+void AquaXmlReader::ReadRecord(wxXmlNode* node, ItemRecord* record)
+{
+    node->GetAttribute(L"x", L"0").ToDouble(&record->x);
+    node->GetAttribute(L"y", L"0").ToDouble(&record->y);
+    if (node->HasAttribute(L"speedx") || node->HasAttribute(L"speedy"))
+    {
+        node->GetAttribute(L"speedx", L"0").ToDouble(&record->speedX);
+        node->GetAttribute(L"speedy", L"0").ToDouble(&record->speedY);
+        record->flags |= ItemRecord::Swims;
+    }
+}
+
+/**
+ * Expat handler for the start of an element
+ * @param data The reader
+ * @param name Element name
+ * @param attributes Attribute names and values, alternating, ending with nullptr
+ */
+void AquaXmlReader::StartElement(void* data, const char* name, const char** attributes)
+{
+    auto reader = (AquaXmlReader*)data;
+
+    // Attributes are only kept for items directly inside the root
+    if (reader->mDepth == 1 && strcmp(name, ItemElement) == 0)
+    {
+        reader->mAttributes.clear();
+        for (; attributes[0] != nullptr; attributes += 2)
+        {
+            reader->mAttributes.emplace_back(attributes[0], attributes[1]);
+        }
+    }
+
+    reader->mDepth++;
+}
+
+/**
+ * Expat handler for the end of an element
+ * @param data The reader
+ * @param name Element name
+ */
+void AquaXmlReader::EndElement(void* data, const char* name)
+{
+    auto reader = (AquaXmlReader*)data;
+    reader->mDepth--;
+    if (reader->mDepth == 1 && strcmp(name, ItemElement) == 0)
+    {
+        reader->EmitItem();
+    }
+}
+
+/**
+ * Hand the item we have just finished to the handler
+ */
+void AquaXmlReader::EmitItem()
+{
+    wxXmlNode node(wxXML_ELEMENT_NODE, ItemElement);
+    for (const auto& attribute : mAttributes)
+    {
+        node.AddAttribute(wxString::FromUTF8(attribute.first.data(), attribute.first.size()),
+                          wxString::FromUTF8(attribute.second.data(), attribute.second.size()));
+    }
+
+    (*mHandler)(&node);
+}
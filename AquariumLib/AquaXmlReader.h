@@ -0,0 +1,86 @@
+/**
+ * @file AquaXmlReader.h
+ * @author Josh Thomas
+ * @brief Header file for the AquaXmlReader class.
+ */
+
+#ifndef AQUAXMLREADER_H
+#define AQUAXMLREADER_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "ItemRecord.h"
+
+class wxInputStream;
+struct XML_ParserStruct;
+
+/**
+ * @class AquaXmlReader
+ * @brief Streaming reader for .aqua XML files.
+ *
+ * Pushes the file a buffer at a time through expat, the parser
+ * wxXmlDocument is built on, and calls a handler as each <item>
+ * child of the root element closes, so memory use does not grow
+ * with the size of the file and no DOM is ever built.
+ *
+ * The handler receives a wxXmlNode holding just the item's attributes,
+ * which ReadRecord turns into an ItemRecord. Well-formedness is checked as
+ * we go. If the file turns out to be malformed, Read returns false,
+ * but any items already handed to the handler have been seen, so the
+ * caller should stage them until Read succeeds.
+ *
+ * Files are read in whatever encoding they declare, as wxXmlDocument
+ * reads them. Compressed .aqua.gz files are read by handing Read a
+ * wxZlibInputStream.
+ */
+class AquaXmlReader
+{
+public:
+    /// Called with each item node as it closes
+    typedef std::function<void(wxXmlNode* node)> ItemHandler;
+
+private:
+    /// Size of the read buffer in bytes
+    static const size_t BufferSize = 64 * 1024;
+
+    /// The read buffer
+    char mBuffer[BufferSize];
+
+    /// The parser, while Read is running
+    XML_ParserStruct* mParser = nullptr;
+
+    /// The handler passed to Read
+    const ItemHandler* mHandler = nullptr;
+
+    /// Number of elements currently open
+    int mDepth = 0;
+
+    /// Attributes of the item element currently open
+    std::vector<std::pair<std::string, std::string>> mAttributes;
+
+    /// Set by Stop to end Read early
+    bool mStopped = false;
+
+    static void StartElement(void* data, const char* name, const char** attributes);
+    static void EndElement(void* data, const char* name);
+    void EmitItem();
+
+public:
+    AquaXmlReader() = default;
+
+    /// Copy constructor (disabled)
+    AquaXmlReader(const AquaXmlReader&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AquaXmlReader&) = delete;
+
+    bool Read(wxInputStream& stream, const ItemHandler& handler);
+    void Stop();
+
+    static bool IsCompressed(const char* data, size_t size);
+    static void ReadRecord(wxXmlNode* node, ItemRecord* record);
+};
+
+#endif //AQUAXMLREADER_H
@@ -0,0 +1,236 @@
+/**
+ * @file AquaXmlWriter.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "AquaXmlWriter.h"
+#include <wx/stream.h>
+#include <wx/zstream.h>
+#include <charconv>
+#include <cstring>
+
+using namespace std;
+
+/// Decimal places written for every number, to match "%.6f"
+const int Precision = 6;
+
+/// Longest a formatted double can be: sign, 309 digits, point, 6 places
+const size_t MaxDoubleLength = 320;
+
+/**
+ * Write a snapshot as a .aqua XML document
+ * @param stream Stream to write to
+ * @param snapshot The items to write
+ * @param progress Optional, called as the records are written
+ * @return false if writing to the stream failed
+ */
+bool AquaXmlWriter::Write(wxOutputStream& stream, const AquaSnapshot& snapshot, const SnapshotProgress& progress)
+{
+    mStream = &stream;
+    mUsed = 0;
+    mOk = true;
+
+    // Everything that goes between the type attribute's quotes,
+    // worked out once per species instead of once per item
+    vector<string> types;
+    for (const auto& name : snapshot.species)
+    {
+        types.push_back(EscapeAttribute(wxString(name).ToUTF8().data()));
+    }
+
+    const char declaration[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    Append(declaration, sizeof(declaration) - 1);
+
+    if (snapshot.records.empty())
+    {
+        const char empty[] = "<aqua/>\n";
+        Append(empty, sizeof(empty) - 1);
+        Flush();
+        return mOk;
+    }
+
+    const char open[] = "<aqua>";
+    Append(open, sizeof(open) - 1);
+
+    auto total = snapshot.records.size();
+    for (size_t i = 0; i < total && mOk; i++)
+    {
+        if (progress && i > 0 && i % SnapshotProgressInterval == 0)
+        {
+            progress(i, total);
+        }
+
+        const auto& record = snapshot.records[i];
+        const char x[] = "<item x=\"";
+        const char y[] = "\" y=\"";
+        const char type[] = "\" type=\"";
+        Append(x, sizeof(x) - 1);
+        AppendDouble(record.x);
+        Append(y, sizeof(y) - 1);
+        AppendDouble(record.y);
+        Append(type, sizeof(type) - 1);
+        Append(types[record.species]);
+
+        if (record.flags & ItemRecord::Swims)
+        {
+            const char speedX[] = "\" speedx=\"";
+            const char speedY[] = "\" speedy=\"";
+            Append(speedX, sizeof(speedX) - 1);
+            AppendDouble(record.speedX);
+            Append(speedY, sizeof(speedY) - 1);
+            AppendDouble(record.speedY);
+        }
+
+        const char close[] = "\"/>";
+        Append(close, sizeof(close) - 1);
+    }
+
+    const char end[] = "</aqua>\n";
+    Append(end, sizeof(end) - 1);
+    Flush();
+
+    if (progress)
+    {
+        progress(total, total);
+    }
+
+    return mOk;
+}
+
+/**
+ * Escape text for use as an attribute value, as wxXmlDocument does
+ * @param value UTF-8 text
+ * @return The escaped text
+ */
+std::string AquaXmlWriter::EscapeAttribute(const std::string& value)
+{
+    string escaped;
+    for (auto c : value)
+    {
+        switch (c)
+        {
+        case '<':
+            escaped += "&lt;";
+            break;
+
+        case '>':
+            escaped += "&gt;";
+            break;
+
+        case '&':
+            escaped += "&amp;";
+            break;
+
+        case '"':
+            escaped += "&quot;";
+            break;
+
+        case '\t':
+            escaped += "&#x9;";
+            break;
+
+        case '\n':
+            escaped += "&#xA;";
+            break;
+
+        case '\r':
+            escaped += "&#xD;";
+            break;
+
+        default:
+            escaped += c;
+            break;
+        }
+    }
+
+    return escaped;
+}
+
+/**
+ * Write a snapshot as a gzip compressed .aqua XML document.
+ *
+ * The document is compressed as it is written, a buffer at a time.
+ *
+ * @param stream Stream to write the compressed data to
+ * @param snapshot The items to write
+ * @param progress Optional, called as the records are written
+ * @return false if writing to the stream failed
+ */
+bool AquaXmlWriter::WriteCompressed(wxOutputStream& stream, const AquaSnapshot& snapshot,
+                                    const SnapshotProgress& progress)
+{
+    wxZlibOutputStream compressor(stream, wxZ_DEFAULT_COMPRESSION, wxZLIB_GZIP);
+    return Write(compressor, snapshot, progress) && compressor.Close() && stream.IsOk();
+}
+
+/**
+ * Should a file of this name be gzip compressed?
+ * @param filename File name, .aqua.gz for compressed files
+ * @return true if the name ends in CompressedExtension
+ */
+bool AquaXmlWriter::IsCompressedName(const wxString& filename)
+{
+    return filename.Lower().EndsWith(CompressedExtension);
+}
+
+/**
+ * Append a number formatted with six decimal places
+ * @param value Number to append
+ */
+void AquaXmlWriter::AppendDouble(double value)
+{
+    if (BufferSize - mUsed < MaxDoubleLength)
+    {
+        Flush();
+    }
+
+    auto begin = mBuffer + mUsed;
+    auto result = to_chars(begin, mBuffer + BufferSize, value, chars_format::fixed, Precision);
+    mUsed += result.ptr - begin;
+}
+
+/**
+ * Append text to the buffer
+ * @param text Text to append
+ */
+void AquaXmlWriter::Append(const std::string& text)
+{
+    Append(text.data(), text.size());
+}
+
+/**
+ * Append text to the buffer
+ * @param text Text to append
+ * @param length Number of bytes to append
+ */
+void AquaXmlWriter::Append(const char* text, size_t length)
+{
+    while (length > 0)
+    {
+        if (mUsed == BufferSize)
+        {
+            Flush();
+        }
+
+        auto count = min(length, BufferSize - mUsed);
+        memcpy(mBuffer + mUsed, text, count);
+        mUsed += count;
+        text += count;
+        length -= count;
+    }
+}
+
+/**
+ * Write the buffer out to the stream
+ */
+void AquaXmlWriter::Flush()
+{
+    if (mUsed > 0 && mOk)
+    {
+        mStream->Write(mBuffer, mUsed);
+        mOk = mStream->LastWrite() == mUsed;
+    }
+
+    mUsed = 0;
+}
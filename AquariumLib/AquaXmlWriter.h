@@ -0,0 +1,79 @@
+/**
+ * @file AquaXmlWriter.h
+ * @author Josh Thomas
+ * @brief Header file for the AquaXmlWriter class.
+ */
+
+#ifndef AQUAXMLWRITER_H
+#define AQUAXMLWRITER_H
+
+#include <string>
+#include <vector>
+#include "ItemRecord.h"
+
+class wxOutputStream;
+class wxString;
+
+/// Extension that marks a gzip compressed .aqua file
+const wchar_t CompressedExtension[] = L".gz";
+
+/**
+ * @class AquaXmlWriter
+ * @brief Streaming writer for .aqua XML files.
+ *
+ * Writes a snapshot straight to a stream through a fixed size buffer,
+ * formatting numbers with std::to_chars. No DOM is built and there is
+ * no per-attribute allocation.
+ *
+ * The output is byte for byte what wxXmlDocument::Save produces for the
+ * same items with wxXML_NO_INDENTATION: an XML declaration, a newline,
+ * the <aqua> root with one <item> per record, and a final newline.
+ * Attributes are written in the order x, y, type, then speedx and
+ * speedy for fish, with values formatted as "%.6f" does in the C locale.
+ *
+ * WriteCompressed gzips the document on the fly through wx's bundled
+ * zlib, so the uncompressed text never exists in memory as a whole.
+ */
+class AquaXmlWriter
+{
+private:
+    /// Size of the write buffer in bytes
+    static const size_t BufferSize = 64 * 1024;
+
+    /// The stream we are writing
+    wxOutputStream* mStream = nullptr;
+
+    /// The write buffer
+    char mBuffer[BufferSize];
+
+    /// Bytes used in mBuffer
+    size_t mUsed = 0;
+
+    /// False once a write to the stream has failed
+    bool mOk = true;
+
+    void Append(const char* text, size_t length);
+    void Append(const std::string& text);
+    void AppendDouble(double value);
+    void Flush();
+
+public:
+    AquaXmlWriter() = default;
+
+    /// Copy constructor (disabled)
+    AquaXmlWriter(const AquaXmlWriter&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AquaXmlWriter&) = delete;
+
+    bool Write(wxOutputStream& stream, const AquaSnapshot& snapshot,
+               const SnapshotProgress& progress = nullptr);
+    bool WriteCompressed(wxOutputStream& stream, const AquaSnapshot& snapshot,
+                         const SnapshotProgress& progress = nullptr);
+
+    static bool IsCompressedName(const wxString& filename);
+
+    static std::string EscapeAttribute(const std::string& value);
+};
+
+#endif //AQUAXMLWRITER_H
@@ -6,41 +6,160 @@
  */
 #include "pch.h"
 #include "Aquarium.h"
-#include "FishBeta.h"
-#include "DecorCastle.h"
-#include "FishCatfish.h"
-#include "FishCarp.h"
+#include "SpeciesRegistry.h"
+#include "AtlasRenderer.h"
+#include "AquaBinary.h"
+#include "MappedFile.h"
+#include "AquaXmlReader.h"
+#include "AquaXmlWriter.h"
+#include "Tracer.h"
+#include "AllocationTracker.h"
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+#include <chrono>
 #include <cmath>
+#include <numbers>
 
 
 using namespace std;
 
 Aquarium::Aquarium()
 {
-    mBackground = std::make_unique<wxBitmap>(L"images/background1.png", wxBITMAP_TYPE_ANY);
+    // Without a pack the sprites are loaded from the images
+    mSprites.OpenPack(SpritePackName);
+    mBackground = mSprites.Load(L"images/background1.png");
     // We use the constant here to indicate how
     // many rows we want to create
     // Seed the random number generator
     std::random_device rd;
-    mRandom.seed(rd());
+    Seed(rd());
+}
+
+/**
+ * Restart the random number generator, so everything the
+ * items do from now on can be reproduced from the seed
+ * @param seed The seed
+ */
+void Aquarium::Seed(unsigned int seed)
+{
+    mSeed = seed;
+    mRandom.seed(seed);
+}
+
+/**
+ * Get a random number with equal chance anywhere in a range.
+ *
+ * Built from the generator's bits directly rather than with
+ * std::uniform_real_distribution, whose output differs between
+ * standard libraries, so a seed gives the same numbers everywhere.
+ *
+ * @param min Smallest value
+ * @param max Largest value, never quite reached
+ * @return The number
+ */
+double Aquarium::Random(double min, double max)
+{
+    // 27 + 26 bits fill the mantissa of a double in [0, 1)
+    double high = mRandom() >> 5;
+    double low = mRandom() >> 6;
+    return min + (high * 0x1p26 + low) * 0x1p-53 * (max - min);
+}
+
+/**
+ * Get a normally distributed random number centred on 0.
+ *
+ * A Box-Muller transform of two uniform numbers, for the same
+ * reason Random does not use the standard distributions.
+ *
+ * @param deviation Standard deviation
+ * @return The number
+ */
+double Aquarium::RandomNormal(double deviation)
+{
+    // 1 - Random keeps the radius finite
+    double radius = sqrt(-2 * log(1 - Random(0, 1)));
+    return radius * cos(2 * numbers::pi * Random(0, 1)) * deviation;
 }
 
 void Aquarium::OnDraw(wxDC* dc)
 {
-    dc->DrawBitmap(*mBackground, 0, 0);
+    AQUARIUM_TRACE_ZONE("Aquarium::OnDraw");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::Draw);
+    RecordDrawList();
+
+    // The atlas is only up to date once the frame is recorded
+    AtlasRenderer renderer(dc, &mSprites.GetAtlas());
+    renderer.Render(mDrawList);
+}
+
+/**
+ * Record the current frame and play it back through a renderer
+ * other than the default one
+ * @param renderer Renderer to draw the frame with
+ */
+void Aquarium::OnDraw(DrawListRenderer* renderer)
+{
+    AQUARIUM_TRACE_ZONE("Aquarium::OnDraw");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::Draw);
+    RecordDrawList();
+    renderer->Render(mDrawList);
+}
+
+/**
+ * Record the current frame into a draw list without drawing it.
+ *
+ * The list is batched and ready to hand to a DrawListRenderer.
+ * It stays valid until the next call.
+ *
+ * @return The recorded frame
+ */
+const DrawList& Aquarium::RecordDrawList()
+{
+    AQUARIUM_TRACE_ZONE("Aquarium::RecordDrawList");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::Draw);
+    // Pick up any sprites that have finished preloading.
+    // Sprites that are still loading are left out of the frame.
+    mSprites.Update();
+
+    mDrawList.Clear();
+    if (mBackground->ready)
+    {
+        mDrawList.Add(mBackground->id, false, 0, 0);
+    }
+
     for (const auto& item : mItems)
     {
-        item->Draw(dc);
+        auto sprite = item->GetSprite();
+        if (!sprite->ready)
+        {
+            continue;
+        }
+
+        auto bounds = item->GetBounds();
+        mDrawList.Add(sprite->id, item->GetMirror(), bounds.GetLeft(), bounds.GetTop());
     }
+
+    mDrawList.Batch(mSprites);
+    return mDrawList;
 }
 
 void Aquarium::Add(std::shared_ptr<Item> item)
 {
+    if (item->IsAnimated())
+    {
+        mAnimatedCount++;
+    }
+
+    item->SetId(mNextId++);
     mItems.push_back(item);
+    mGridStale = true;
+    Journal(JournalOp::Add, mItems.size() - 1, item.get());
 }
 
 std::shared_ptr<Item> Aquarium::HitTest(int x, int y)
 {
+    AQUARIUM_TRACE_ZONE("Aquarium::HitTest");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::Input);
     for (auto i = mItems.rbegin(); i != mItems.rend(); ++i)
     {
         if ((*i)->HitTest(x, y))
@@ -56,11 +175,171 @@ void Aquarium::MoveToEnd(std::shared_ptr<Item> item)
     auto loc = std::find(mItems.begin(), mItems.end(), item);
     if (loc != mItems.end())
     {
+        Journal(JournalOp::MoveToEnd, loc - mItems.begin());
         mItems.erase(loc);
         mItems.push_back(item);
     }
 }
 
+/**
+ * Bring every selected item to the front, keeping their order
+ * among themselves and the order of everything else.
+ *
+ * One pass over the items, however many are selected.
+ *
+ * @param selection The items to bring to the front
+ */
+void Aquarium::MoveToEnd(const ItemSelection& selection)
+{
+    if (selection.IsEmpty())
+    {
+        return;
+    }
+
+    vector<shared_ptr<Item>> selected;
+    selected.reserve(selection.GetCount());
+
+    // Journaled as the moves to the end that would do the same, each
+    // made after the ones before it, and committed together once the
+    // items are all back in place.
+    bool journal = mJournal.IsOpen() && !mLoading;
+    size_t kept = 0;
+    for (size_t i = 0; i < mItems.size(); i++)
+    {
+        if (selection.Contains(mItems[i]->GetId()))
+        {
+            if (journal)
+            {
+                mJournal.Queue(JournalOp::MoveToEnd, i - selected.size());
+            }
+            selected.push_back(std::move(mItems[i]));
+        }
+        else
+        {
+            mItems[kept++] = std::move(mItems[i]);
+        }
+    }
+
+    std::move(selected.begin(), selected.end(), mItems.begin() + kept);
+
+    if (journal)
+    {
+        mJournal.Commit();
+        if (mJournal.NeedsCheckpoint())
+        {
+            CheckpointJournal();
+        }
+    }
+}
+
+/**
+ * Select the items whose bounds overlap a rectangle
+ * @param rect Rectangle in pixels
+ * @param selection Selection to add the items to
+ * @return Number of items found in the rectangle
+ */
+size_t Aquarium::Select(const wxRect& rect, ItemSelection* selection)
+{
+    AQUARIUM_TRACE_ZONE("Aquarium::Select");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::Input);
+
+    // The grid is built at most once for all the queries between moves
+    if (mGridStale)
+    {
+        mGrid.Build(mItems);
+        mGridStale = false;
+    }
+
+    mFound.clear();
+    mGrid.Query(rect, &mFound);
+    for (auto id : mFound)
+    {
+        selection->Add(id);
+    }
+
+    return mFound.size();
+}
+
+/**
+ * Move every selected item by the same amount, in one pass
+ * @param selection The items to move
+ * @param dx Distance to move right in pixels
+ * @param dy Distance to move down in pixels
+ */
+void Aquarium::MoveBy(const ItemSelection& selection, double dx, double dy)
+{
+    AQUARIUM_TRACE_ZONE("Aquarium::MoveBy");
+    if (selection.IsEmpty())
+    {
+        return;
+    }
+
+    for (const auto& item : mItems)
+    {
+        if (selection.Contains(item->GetId()))
+        {
+            item->SetLocation(item->GetX() + dx, item->GetY() + dy);
+        }
+    }
+
+    mGridStale = true;
+}
+
+/**
+ * Tell the aquarium a group of items has been dragged
+ * to new locations. Call when the drag ends.
+ * @param selection The items that moved
+ */
+void Aquarium::ItemsMoved(const ItemSelection& selection)
+{
+    mGridStale = true;
+    if (!mJournal.IsOpen() || mLoading || selection.IsEmpty())
+    {
+        return;
+    }
+
+    // One write for the whole group, and a checkpoint only once it is all in
+    for (size_t i = 0; i < mItems.size(); i++)
+    {
+        if (selection.Contains(mItems[i]->GetId()))
+        {
+            ItemRecord record;
+            mItems[i]->SaveRecord(&record);
+            mJournal.Queue(JournalOp::Update, i, record);
+        }
+    }
+
+    mJournal.Commit();
+    if (mJournal.NeedsCheckpoint())
+    {
+        CheckpointJournal();
+    }
+}
+
+/**
+ * Get the rectangle the selected items are drawn in
+ * @param selection The items
+ * @return Bounds of every selected item, empty if none are
+ */
+wxRect Aquarium::GetBounds(const ItemSelection& selection) const
+{
+    wxRect bounds;
+    if (selection.IsEmpty())
+    {
+        return bounds;
+    }
+
+    for (const auto& item : mItems)
+    {
+        if (selection.Contains(item->GetId()))
+        {
+            bounds.Union(item->GetBounds());
+        }
+    }
+
+    return bounds;
+}
+
 void Aquarium::PullFishTowards(Item* magnemo, double distance)
 {
     for (const auto& item : mItems)
@@ -85,103 +364,513 @@ void Aquarium::PullFishTowards(Item* magnemo, double distance)
  *
  * Open an XML file and stream the aquarium data to it.
  *
+ * Reports nothing itself, so the caller decides whether a failure
+ * is a message box or a line on stderr.
+ *
  * @param filename The filename of the file to save the aquarium to
+ * @return false if the file could not be written
  */
-void Aquarium::Save(const wxString& filename)
+bool Aquarium::Save(const wxString& filename)
 {
-    wxXmlDocument xmlDoc;
+    AQUARIUM_TRACE_ZONE("Aquarium::Save");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::File);
+    // Copy the items into plain records and stream them
+    // out; the output is the same as saving a wxXmlDocument
+    // of the items would give, without building it.
+    AquaSnapshot snapshot;
+    TakeSnapshot(&snapshot);
 
-    auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
-    xmlDoc.SetRoot(root);
-    // Iterate over all items and save them
-    for (auto item : mItems)
-    {
-        item->XmlSave(root);
-    }
-    if (!xmlDoc.Save(filename, wxXML_NO_INDENTATION))
+    // A .aqua.gz name gets the same XML, gzipped as it is written
+    wxFFileOutputStream stream(filename);
+    AquaXmlWriter writer;
+    bool compress = AquaXmlWriter::IsCompressedName(filename);
+    return stream.IsOk() && (compress ? writer.WriteCompressed(stream, snapshot) : writer.Write(stream, snapshot)) &&
+           stream.Close();
+}
+
+/**
+ * Save the aquarium as a binary .aqua file.
+ *
+ * Much smaller and faster to load than XML for big aquariums.
+ * Load tells the two formats apart automatically.
+ *
+ * @param filename The filename of the file to save the aquarium to
+ * @return false if the file could not be written
+ */
+bool Aquarium::SaveBinary(const wxString& filename)
+{
+    AQUARIUM_TRACE_ZONE("Aquarium::SaveBinary");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::File);
+    AquaSnapshot snapshot;
+    TakeSnapshot(&snapshot);
+
+    wxFFileOutputStream stream(filename);
+    return stream.IsOk() && AquaBinary::Write(stream, snapshot) && stream.Close();
+}
+
+/**
+ * Copy the state of every item into plain records.
+ * @param snapshot Snapshot to fill in, replacing anything already there
+ */
+void Aquarium::TakeSnapshot(AquaSnapshot* snapshot) const
+{
+    snapshot->species.clear();
+    snapshot->records.clear();
+    snapshot->records.reserve(mItems.size());
+
+    // Index in the snapshot species table for each species id
+    auto& registry = SpeciesRegistry::Get();
+    vector<uint16_t> speciesIndex(registry.GetCount(), UnknownSpecies);
+    for (const auto& item : mItems)
     {
-        wxMessageBox(L"Write to XML failed");
-        return;
+        auto id = item->GetSpecies();
+        if (id >= speciesIndex.size())
+        {
+            speciesIndex.resize(id + 1, UnknownSpecies);
+        }
+
+        if (speciesIndex[id] == UnknownSpecies)
+        {
+            speciesIndex[id] = (uint16_t)snapshot->species.size();
+            snapshot->species.push_back(registry.GetTag(id));
+        }
+
+        ItemRecord record;
+        record.species = speciesIndex[id];
+        item->SaveRecord(&record);
+        snapshot->records.push_back(record);
     }
 }
 
 /**
- * Load the aquarium from a .aqua XML file.
+ * Load the aquarium from a .aqua file.
+ *
+ * Binary files and autosave journals are recognized by their magic bytes
+ * and mapped straight into memory. Anything else is read as XML, creating
+ * items as appropriate. Gzip compressed XML is decompressed as it is read.
  *
- * Opens the XML file and reads the nodes, creating items as appropriate.
+ * Reports nothing itself, so the caller decides whether a failure
+ * is a message box or a line on stderr.
  *
  * @param filename The filename of the file to load the aquarium from.
+ * @return false if the file could not be read, leaving the aquarium as it was
  */
-void Aquarium::Load(const wxString& filename)
+bool Aquarium::Load(const wxString& filename)
 {
-    wxXmlDocument xmlDoc;
-    if (!xmlDoc.Load(filename))
+    AQUARIUM_TRACE_ZONE("Aquarium::Load");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::File);
+    // Loading is not journaled edit by edit. If it changed
+    // anything, a new checkpoint records the result.
+    mLoading = true;
+    bool loaded = LoadFile(filename);
+    mLoading = false;
+
+    if (loaded)
     {
-        wxMessageBox(L"Unable to load Aquarium file");
-        return;
+        CheckpointJournal();
     }
 
+    return loaded;
+}
+
+/**
+ * Start a load that adds items a batch at a time.
+ *
+ * Clears the aquarium. Items are then added with AddRecords
+ * as they arrive, and can be drawn and clicked meanwhile.
+ * Call EndLoad when they have all arrived.
+ */
+void Aquarium::BeginLoad()
+{
+    mLoading = true;
     Clear();
-    // Get the XML document root node
-    auto root = xmlDoc.GetRoot();
+}
+
+/**
+ * Finish a load started with BeginLoad
+ */
+void Aquarium::EndLoad()
+{
+    if (mLoading)
+    {
+        mLoading = false;
+        CheckpointJournal();
+    }
+}
+
+/**
+ * Create items from records and add them to the aquarium.
+ *
+ * Records of a species we do not know are skipped.
+ *
+ * @param species Species table the records index
+ * @param records The first record
+ * @param count Number of records
+ */
+void Aquarium::AddRecords(const std::vector<std::wstring>& species, const ItemRecord* records, size_t count)
+{
+    // Look each name up once, not once per item
+    auto& registry = SpeciesRegistry::Get();
+    vector<SpeciesId> ids;
+    for (const auto& name : species)
+    {
+        ids.push_back(registry.Find(name));
+    }
+
+    mItems.reserve(mItems.size() + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        auto item = records[i].species < ids.size() ? registry.Create(ids[records[i].species], this) : nullptr;
+        if (item != nullptr)
+        {
+            item->LoadRecord(records[i]);
+            Add(item);
+        }
+    }
+}
+
+/**
+ * Load the aquarium from a file of any format.
+ * @param filename The filename of the file to load the aquarium from.
+ * @return false if the file could not be read, leaving the aquarium as it was
+ */
+bool Aquarium::LoadFile(const wxString& filename)
+{
+    MappedFile file;
+    bool compressed = false;
+    if (file.Open(filename))
+    {
+        if (AquaBinary::IsBinary(file.GetData(), file.GetSize()))
+        {
+            return LoadBinary(file.GetData(), file.GetSize());
+        }
+
+        if (EditJournal::IsJournal(file.GetData(), file.GetSize()))
+        {
+            return LoadJournal(file);
+        }
+
+        compressed = AquaXmlReader::IsCompressed(file.GetData(), file.GetSize());
+    }
+    file.Close();
 
     //
-    // Traverse the children of the root
-    // node of the XML document in memory!!!!
+    // Stream the XML, creating each item as its element closes.
+    // Items are staged until the whole file has been read so a
+    // malformed file leaves the aquarium as it was.
     //
-    auto child = root->GetChildren();
-    for (; child; child = child->GetNext())
+    wxFFileInputStream fileStream(filename);
+    unique_ptr<wxZlibInputStream> decompressor;
+    wxInputStream* stream = &fileStream;
+    if (compressed)
     {
-        auto name = child->GetName();
-        if (name == L"item")
+        decompressor = make_unique<wxZlibInputStream>(fileStream, wxZLIB_GZIP);
+        stream = decompressor.get();
+    }
+
+    vector<shared_ptr<Item>> loaded;
+    AquaXmlReader reader;
+    if (!fileStream.IsOk() || !reader.Read(*stream, [this, &loaded](wxXmlNode* node) {
+        auto item = XmlItem(node);
+        if (item != nullptr)
         {
-            XmlItem(child);
+            loaded.push_back(item);
         }
+    }))
+    {
+        return false;
     }
+
+    Clear();
+    mItems.reserve(loaded.size());
+    for (const auto& item : loaded)
+    {
+        Add(item);
+    }
+
+    return true;
 }
 
 /**
  * Handle a node of type item.
  * @param node XML node
+ * @return The loaded item, not yet added, or nullptr if the type is unknown
  */
-void Aquarium::XmlItem(wxXmlNode* node)
+std::shared_ptr<Item> Aquarium::XmlItem(wxXmlNode* node)
 {
-    // A pointer for the item we are loading
-    shared_ptr<Item> item;
-
     // We have an item. What type?
-    auto type = node->GetAttribute(L"type");
-    if (type == L"beta")
+    auto item = NewItem(node->GetAttribute(L"type"));
+
+    // The same record a progressive load would build
+    if (item != nullptr)
     {
-        item = make_shared<FishBeta>(this);
+        ItemRecord record;
+        AquaXmlReader::ReadRecord(node, &record);
+        item->LoadRecord(record);
     }
-    else if (type == L"carp")
+
+    return item;
+}
+
+/**
+ * Load the items from binary .aqua data, usually a mapped file.
+ *
+ * The data is checked before anything is changed, so
+ * bad data leaves the aquarium as it was.
+ *
+ * @param data Start of the data
+ * @param size Size of the data in bytes
+ * @return false if the data is not valid
+ */
+bool Aquarium::LoadBinary(const char* data, size_t size)
+{
+    vector<wstring> species;
+    const ItemRecord* records;
+    size_t count;
+    if (!AquaBinary::Read(data, size, &species, &records, &count))
     {
-        item = make_shared<FishCarp>(this);
+        return false;
     }
-    else if (type == L"catfish")
+
+    for (size_t i = 0; i < count; i++)
     {
-        item = make_shared<FishCatfish>(this);
+        if (records[i].species >= species.size())
+        {
+            return false;
+        }
     }
-    else if (type == L"castle")
+
+    Clear();
+    AddRecords(species, records, count);
+    return true;
+}
+
+/**
+ * Load a journal file: its checkpoint, then the edits made since.
+ * @param file The mapped journal file
+ * @return false if the checkpoint is not valid
+ */
+bool Aquarium::LoadJournal(const MappedFile& file)
+{
+    const char* snapshot;
+    size_t snapshotSize;
+    vector<JournalEdit> edits;
+    if (!EditJournal::Read(file.GetData(), file.GetSize(), &snapshot, &snapshotSize, &edits) ||
+        !LoadBinary(snapshot, snapshotSize))
+    {
+        return false;
+    }
+
+    // An edit that makes no sense can only follow a damaged
+    // entry, so everything from there on is dropped
+    for (const auto& edit : edits)
     {
-        item = make_shared<DecorCastle>(this);
+        if (!ApplyEdit(edit))
+        {
+            break;
+        }
     }
 
+    return true;
+}
 
-    if (item != nullptr)
+/**
+ * Redo one edit read from a journal
+ * @param edit The edit
+ * @return false if the edit could not be applied
+ */
+bool Aquarium::ApplyEdit(const JournalEdit& edit)
+{
+    switch (edit.op)
+    {
+    case JournalOp::Add:
     {
+        auto item = NewItem(edit.species);
+        if (item == nullptr)
+        {
+            return false;
+        }
+
+        item->LoadRecord(edit.record);
         Add(item);
-        item->XmlLoad(node);
+        return true;
     }
+
+    case JournalOp::Clear:
+        Clear();
+        return true;
+
+    case JournalOp::Update:
+        if (edit.index >= mItems.size())
+        {
+            return false;
+        }
+
+        mItems[edit.index]->LoadRecord(edit.record);
+        mGridStale = true;
+        return true;
+
+    case JournalOp::MoveToEnd:
+        if (edit.index >= mItems.size())
+        {
+            return false;
+        }
+
+        MoveToEnd(mItems[edit.index]);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Create a new item given its type name.
+ * @param type Type name, a tag in the SpeciesRegistry
+ * @return The new item, or nullptr if the type is unknown
+ */
+std::shared_ptr<Item> Aquarium::NewItem(const wxString& type)
+{
+    auto& registry = SpeciesRegistry::Get();
+    return registry.Create(registry.Find(type.ToStdWstring()), this);
 }
 
 /**
- * Clears out mItems
+ * Clears out mItems.
+ *
+ * Item ids start again from 0, so a selection
+ * of the old items has to be cleared as well.
  */
 void Aquarium::Clear()
 {
     mItems.clear();
+    mAnimatedCount = 0;
+    mNextId = 0;
+    mGridStale = true;
+    Journal(JournalOp::Clear, 0);
+}
+
+/**
+ * Toggle the state of an item, such as a darting catfish
+ * @param item The item to toggle
+ */
+void Aquarium::ToggleState(std::shared_ptr<Item> item)
+{
+    item->ToggleState();
+    Journal(JournalOp::Update, IndexOf(item.get()), item.get());
+}
+
+/**
+ * Tell the aquarium an item has been dragged to a new location.
+ *
+ * Call when the drag ends. The intermediate locations are not
+ * interesting enough to record.
+ *
+ * @param item The item that moved
+ */
+void Aquarium::ItemMoved(std::shared_ptr<Item> item)
+{
+    mGridStale = true;
+    Journal(JournalOp::Update, IndexOf(item.get()), item.get());
+}
+
+/**
+ * Start recording every edit in a journal file for autosave.
+ *
+ * The file starts with a checkpoint of the aquarium as it is now.
+ * Loading the file later restores the aquarium as of the last edit.
+ *
+ * @param filename Journal file name, replaced if it exists
+ * @return true if the journal is recording
+ */
+bool Aquarium::StartJournal(const wxString& filename)
+{
+    AquaSnapshot snapshot;
+    TakeSnapshot(&snapshot);
+    return mJournal.Open(filename, std::move(snapshot));
+}
+
+/**
+ * Stop recording edits. The journal file is left as it is.
+ */
+void Aquarium::StopJournal()
+{
+    mJournal.Close();
+}
+
+/**
+ * Record an edit in the journal, if we are keeping one.
+ *
+ * Writes a new checkpoint once the edits since the
+ * last one are bigger than the checkpoint itself, so
+ * the journal never grows without bound.
+ *
+ * @param op What the edit does
+ * @param index Index of the item in mItems
+ * @param item The item whose state to record, for Add and Update
+ */
+void Aquarium::Journal(JournalOp op, size_t index, const Item* item)
+{
+    if (!mJournal.IsOpen() || mLoading || (index == mItems.size() && op != JournalOp::Clear))
+    {
+        return;
+    }
+
+    ItemRecord record;
+    wstring species;
+    if (item != nullptr)
+    {
+        item->SaveRecord(&record);
+        if (op == JournalOp::Add)
+        {
+            species = SpeciesRegistry::Get().GetTag(item->GetSpecies());
+        }
+    }
+
+    mJournal.Append(op, index, record, species);
+
+    if (mJournal.NeedsCheckpoint())
+    {
+        CheckpointJournal();
+    }
+}
+
+/**
+ * Start a new journal checkpoint of the whole aquarium, if we are journaling.
+ *
+ * Only the snapshot is taken here. The journal writes and syncs it on
+ * a worker thread and switches over to it from Update once it is done.
+ */
+void Aquarium::CheckpointJournal()
+{
+    if (mJournal.IsOpen())
+    {
+        AquaSnapshot snapshot;
+        TakeSnapshot(&snapshot);
+        mJournal.Checkpoint(std::move(snapshot));
+    }
+}
+
+/**
+ * Find the index of an item in drawing order.
+ *
+ * This looks at every item in turn. It is only used to journal
+ * a single edit the user makes, a click or a drop, so it never
+ * runs more than once per input event.
+ *
+ * @param item The item to look for
+ * @return Its index in mItems, or the number of items if it is not there
+ */
+size_t Aquarium::IndexOf(const Item* item) const
+{
+    for (size_t i = 0; i < mItems.size(); i++)
+    {
+        if (mItems[i].get() == item)
+        {
+            return i;
+        }
+    }
+
+    return mItems.size();
 }
 
 /**
@@ -190,9 +879,110 @@ void Aquarium::Clear()
  */
 void Aquarium::Update(double elapsed)
 {
-    for (auto item : mItems)
+    AQUARIUM_TRACE_ZONE("Aquarium::Update");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::Update);
+
+    // Pick up a journal checkpoint the worker has finished
+    mJournal.Poll();
+
+    if (mPaused)
+    {
+        mUpdateTime = 0;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    mGridStale = true;
+    if (mHashing)
     {
-        item->Update(elapsed);
+        // Each item is hashed while it is still in cache
+        mTickHash.Clear();
+        for (const auto& item : mItems)
+        {
+            item->Update(elapsed);
+
+            ItemRecord record;
+            item->SaveRecord(&record);
+            mTickHash.Add(item->GetSpecies(), record);
+        }
+    }
+    else
+    {
+        for (const auto& item : mItems)
+        {
+            item->Update(elapsed);
+        }
+    }
+
+    mUpdateTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Hash the state of every item, in any order.
+ *
+ * Aquariums whose items are all in the same state hash the same,
+ * even if the items are stored in a different order.
+ *
+ * @return The hash
+ */
+uint64_t Aquarium::GetStateHash() const
+{
+    StateHash hash;
+    for (const auto& item : mItems)
+    {
+        ItemRecord record;
+        item->SaveRecord(&record);
+        hash.Add(item->GetSpecies(), record);
+    }
+
+    return hash.GetValue();
+}
+
+/**
+ * Estimate where the aquarium's memory goes.
+ *
+ * Walks the items once, so it is cheap enough to call a few
+ * times a second even for very large tanks.
+ *
+ * @return The memory broken down by species, kind and cache
+ */
+MemoryReport Aquarium::GetMemoryReport() const
+{
+    MemoryReport report;
+
+    auto& registry = SpeciesRegistry::Get();
+    vector<size_t> counts(registry.GetCount());
+    for (const auto& item : mItems)
+    {
+        auto species = item->GetSpecies();
+        if (species < counts.size())
+        {
+            counts[species]++;
+        }
+    }
+
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        if (counts[i] == 0)
+        {
+            continue;
+        }
+
+        auto id = (SpeciesId)i;
+        auto size = registry.GetSize(id);
+
+        SpeciesMemory memory;
+        memory.tag = registry.GetTag(id);
+        memory.count = counts[i];
+        memory.itemBytes = (size > 0 ? size : sizeof(Item)) + SharedControlBytes;
+        memory.bytes = memory.count * memory.itemBytes;
+        report.entities += memory.bytes;
+        report.species.push_back(memory);
     }
 
+    report.containers += sizeof(Aquarium) + mItems.capacity() * sizeof(shared_ptr<Item>);
+    report.drawList += mDrawList.GetMemorySize();
+    report.containers += mGrid.GetMemorySize() + mFound.capacity() * sizeof(uint32_t);
+    mSprites.AddMemory(&report);
+    return report;
 }
@@ -9,6 +9,17 @@
 #include <memory>
 #include <random>
 #include "Item.h"
+#include "SpriteLibrary.h"
+#include "DrawList.h"
+#include "ItemRecord.h"
+#include "EditJournal.h"
+#include "MemoryReport.h"
+#include "StateHash.h"
+#include "SpatialGrid.h"
+#include "ItemSelection.h"
+
+class MappedFile;
+class DrawListRenderer;
 
 /**
  * @class Aquarium
@@ -22,12 +33,65 @@
 class Aquarium
 {
 private:
-    std::unique_ptr<wxBitmap> mBackground; ///< Background image to use
+    /// Sprites shared by the items. Declared before mItems
+    /// so the items are destroyed first.
+    SpriteLibrary mSprites;
+
+    const Sprite* mBackground; ///< Background image to use
     std::vector<std::shared_ptr<Item>> mItems; ///< All the items in the aquarium
-    void XmlItem(wxXmlNode* node);
+
+    /// The most recently recorded frame
+    DrawList mDrawList;
+
+    std::shared_ptr<Item> XmlItem(wxXmlNode* node);
+    std::shared_ptr<Item> NewItem(const wxString& type);
+    bool LoadFile(const wxString& filename);
+    bool LoadBinary(const char* data, size_t size);
+    bool LoadJournal(const MappedFile& file);
+    bool ApplyEdit(const JournalEdit& edit);
+    void Journal(JournalOp op, size_t index, const Item* item = nullptr);
+    size_t IndexOf(const Item* item) const;
+    void CheckpointJournal();
     /// Random number generator
     std::mt19937 mRandom;
 
+    /// Seed mRandom was last given
+    unsigned int mSeed = 0;
+
+    /// Number of items in mItems that animate
+    int mAnimatedCount = 0;
+
+    /// True if the simulation is paused
+    bool mPaused = false;
+
+    /// Records edits for autosave, when open
+    EditJournal mJournal;
+
+    /// Time the last Update took in milliseconds
+    double mUpdateTime = 0;
+
+    /// True to hash the state of every item as it updates
+    bool mHashing = false;
+
+    /// Hash of every item's state after the last Update, while hashing
+    StateHash mTickHash;
+
+    /// True while loading, when edits are not journaled.
+    /// A checkpoint is written when the load ends.
+    bool mLoading = false;
+
+    /// Id to give the next item added
+    uint32_t mNextId = 0;
+
+    /// Where the items are, for finding the items in a rectangle
+    SpatialGrid mGrid;
+
+    /// True if items have moved since mGrid was built
+    bool mGridStale = true;
+
+    /// Scratch space for Select, kept to avoid reallocating each query
+    std::vector<uint32_t> mFound;
+
 public:
     Aquarium();
 
@@ -36,6 +100,15 @@ public:
      * @param dc Pointer to the wxDC object where the image will be drawn.
      */
     void OnDraw(wxDC* dc);
+    void OnDraw(DrawListRenderer* renderer);
+
+    const DrawList& RecordDrawList();
+
+    /**
+     * Get the sprites used by this aquarium
+     * @return The sprite library
+     */
+    SpriteLibrary& GetSprites() { return mSprites; }
 
     /**
      * @brief Adds a new item to the aquarium.
@@ -56,6 +129,11 @@ public:
      * @param item The item to move to the end.
      */
     void MoveToEnd(std::shared_ptr<Item> item);
+    void MoveToEnd(const ItemSelection& selection);
+    size_t Select(const wxRect& rect, ItemSelection* selection);
+    void MoveBy(const ItemSelection& selection, double dx, double dy);
+    void ItemsMoved(const ItemSelection& selection);
+    wxRect GetBounds(const ItemSelection& selection) const;
 
     /**
      * @brief Moves other fish towards the given Magnemo fish when active.
@@ -63,26 +141,107 @@ public:
      * @param distance The distance to pull other fish.
      */
     void PullFishTowards(Item* fish, double distance);
-    void Save(const wxString& filename);
-    void Load(const wxString& filename);
+    bool Save(const wxString& filename);
+    bool SaveBinary(const wxString& filename);
+    void TakeSnapshot(AquaSnapshot* snapshot) const;
+    bool Load(const wxString& filename);
+    void BeginLoad();
+    void AddRecords(const std::vector<std::wstring>& species, const ItemRecord* records, size_t count);
+    void EndLoad();
     void Clear();
+    void ToggleState(std::shared_ptr<Item> item);
+    void ItemMoved(std::shared_ptr<Item> item);
+    bool StartJournal(const wxString& filename);
+    void StopJournal();
+
+    /**
+     * Is every edit being recorded in a journal?
+     * @return true if a journal is open
+     */
+    bool IsJournaling() const { return mJournal.IsOpen(); }
+
     void Update(double elapsed);
+
+    /**
+     * Get how long the last Update took
+     * @return Time in milliseconds
+     */
+    double GetUpdateTime() const { return mUpdateTime; }
+
+    /**
+     * Get the number of items in the aquarium
+     * @return Item count
+     */
+    size_t GetItemCount() const { return mItems.size(); }
+
+    MemoryReport GetMemoryReport() const;
+    uint64_t GetStateHash() const;
+
+    /**
+     * Hash the state of every item each Update, as it is updated.
+     *
+     * Costs one record copy per item per tick, so it is off
+     * unless something is checking for divergence.
+     * @param hashing True to hash
+     */
+    void SetStateHashing(bool hashing) { mHashing = hashing; }
+
+    /**
+     * Get the hash of every item's state after the last Update.
+     *
+     * The same as GetStateHash would give, without another pass
+     * over the items. Only kept while state hashing is on.
+     * @return The hash
+     */
+    uint64_t GetTickHash() const { return mTickHash.GetValue(); }
+
     /**
    * Get the random number generator
    * @return Pointer to the random number generator
    */
     std::mt19937& GetRandom() { return mRandom; }
+
+    void Seed(unsigned int seed);
+    double Random(double min, double max);
+    double RandomNormal(double deviation);
+
+    /**
+     * Get the seed the random number generator was last given
+     * @return The seed
+     */
+    unsigned int GetSeed() const { return mSeed; }
+
     /**
     * Get the width of the aquarium
     * @return Aquarium width in pixels
     */
-    int GetWidth() const { return mBackground->GetWidth(); }
+    int GetWidth() const { return mBackground->width; }
 
     /**
      * Get the height of the aquarium
      * @return Aquarium height in pixels
      */
-    int GetHeight() const { return mBackground->GetHeight(); }
+    int GetHeight() const { return mBackground->height; }
+
+    /**
+     * Pause or resume the simulation
+     * @param paused True to pause
+     */
+    void SetPaused(bool paused) { mPaused = paused; }
+
+    /**
+     * Is the simulation paused?
+     * @return true if paused
+     */
+    bool IsPaused() const { return mPaused; }
+
+    /**
+     * Is anything in the aquarium moving?
+     *
+     * False if the simulation is paused or every item is decor.
+     * @return true if the aquarium needs to keep repainting
+     */
+    bool IsAnimating() const { return !mPaused && mAnimatedCount > 0; }
 };
 
 #endif //AQUARIUM_H
@@ -0,0 +1,232 @@
+/**
+ * @file AquariumInput.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "AquariumInput.h"
+#include "Aquarium.h"
+#include <algorithm>
+#include <cstdlib>
+
+/**
+ * The left button went down: grab the item under the mouse, or
+ * the whole selection if the item is selected, or start a rubber
+ * band if there is nothing under the mouse
+ * @param x Mouse X in pixels
+ * @param y Mouse Y in pixels
+ * @return true if the aquarium needs redrawing
+ */
+bool AquariumInput::LeftDown(int x, int y)
+{
+    ApplyMove();
+    auto item = mAquarium->HitTest(x, y);
+
+    if (item != nullptr && mSelection.Contains(item->GetId()))
+    {
+        // Move the selection to the end of the list, all together
+        mAquarium->MoveToEnd(mSelection);
+        mGroupDrag = true;
+        mDragX = x;
+        mDragY = y;
+        return true;
+    }
+
+    bool deselected = !mSelection.IsEmpty();
+    mSelection.Clear();
+    mGrabbedItem = item;
+
+    if (mGrabbedItem != nullptr)
+    {
+        // Move the grabbed item to the end of the list
+        mAquarium->MoveToEnd(mGrabbedItem);
+    }
+    else
+    {
+        mBanding = true;
+        mBandX = x;
+        mBandY = y;
+        mBand = wxRect(x, y, 0, 0);
+    }
+
+    return deselected;
+}
+
+/**
+ * The left button came up: drop the item being dragged and
+ * put an active item under the mouse back to its dormant state
+ * @param x Mouse X in pixels
+ * @param y Mouse Y in pixels
+ * @return true if the aquarium needs redrawing
+ */
+bool AquariumInput::LeftUp(int x, int y)
+{
+    // The band and the selection's outline are drawn over the aquarium
+    bool redraw = mBanding || mGroupDrag;
+    EndDrag();
+
+    auto clickedItem = mAquarium->HitTest(x, y);
+
+    // Use polymorphism to call IsActive and ToggleState
+    if (clickedItem != nullptr && clickedItem->IsActive())
+    {
+        mAquarium->ToggleState(clickedItem);  // Set back to dormant state on single click
+        return true;
+    }
+
+    return redraw;
+}
+
+/**
+ * The mouse moved: drag the grabbed item or the selection along
+ * with it, or stretch the rubber band
+ * @param x Mouse X in pixels
+ * @param y Mouse Y in pixels
+ * @param leftDown True if the left button is down
+ * @return true if the aquarium needs redrawing
+ */
+bool AquariumInput::MouseMove(int x, int y, bool leftDown)
+{
+    wxRect dirty;
+    if (!QueueMove(x, y, leftDown, &dirty))
+    {
+        return false;
+    }
+
+    ApplyMove();
+    return true;
+}
+
+/**
+ * The left button was double clicked: toggle the state of the item under the mouse
+ * @param x Mouse X in pixels
+ * @param y Mouse Y in pixels
+ * @return true if the aquarium needs redrawing
+ */
+bool AquariumInput::LeftDClick(int x, int y)
+{
+    auto clickedItem = mAquarium->HitTest(x, y);
+
+    if (clickedItem != nullptr)
+    {
+        // Call the virtual ToggleState method on the clicked item
+        mAquarium->ToggleState(clickedItem);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * The mouse moved: remember where the grabbed item, the selection
+ * or the rubber band should go, to be applied by ApplyMove once
+ * per frame.
+ *
+ * Releasing the button is not deferred, since the drop
+ * has to happen before any click that follows it.
+ *
+ * @param x Mouse X in pixels
+ * @param y Mouse Y in pixels
+ * @param leftDown True if the left button is down
+ * @param dirty Receives the area of the aquarium the move changes:
+ * the item's bounds where it is now and where it is going. Empty
+ * if the whole aquarium can change, for the selection and the band.
+ * @return true if the aquarium needs redrawing
+ */
+bool AquariumInput::QueueMove(int x, int y, bool leftDown, wxRect* dirty)
+{
+    if (!IsDragging())
+    {
+        return false;
+    }
+
+    *dirty = wxRect();
+    if (!leftDown)
+    {
+        // The item drops where the last queued move put it
+        ApplyMove();
+        if (mGrabbedItem != nullptr)
+        {
+            *dirty = mGrabbedItem->GetBounds();
+        }
+        EndDrag();
+        return true;
+    }
+
+    if (mGrabbedItem != nullptr)
+    {
+        // Rounded the same way as Item::GetBounds
+        auto sprite = mGrabbedItem->GetSprite();
+        *dirty = mGrabbedItem->GetBounds();
+        dirty->Union(wxRect(int(x - sprite->width / 2.0), int(y - sprite->height / 2.0), sprite->width, sprite->height));
+    }
+
+    mMoveX = x;
+    mMoveY = y;
+    mMovePending = true;
+    return true;
+}
+
+/**
+ * Apply the latest move queued by QueueMove. The grabbed item or
+ * the selection moves there, or the band stretches there and
+ * selects what it covers.
+ * @return true if there was a move to apply
+ */
+bool AquariumInput::ApplyMove()
+{
+    if (!mMovePending)
+    {
+        return false;
+    }
+
+    mMovePending = false;
+    if (mGrabbedItem != nullptr)
+    {
+        mGrabbedItem->SetLocation(mMoveX, mMoveY);
+    }
+    else if (mGroupDrag)
+    {
+        // Every selected item in one pass, however many moves were queued
+        mAquarium->MoveBy(mSelection, mMoveX - mDragX, mMoveY - mDragY);
+        mDragX = mMoveX;
+        mDragY = mMoveY;
+    }
+    else if (mBanding)
+    {
+        mBand = wxRect(std::min(mBandX, mMoveX), std::min(mBandY, mMoveY), std::abs(mMoveX - mBandX),
+                       std::abs(mMoveY - mBandY));
+        mSelection.Clear();
+        mAquarium->Select(mBand, &mSelection);
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Let go of the item or selection being dragged, if any, and
+ * tell the aquarium where it ended up. A rubber band stops,
+ * leaving what it covered selected.
+ */
+void AquariumInput::EndDrag()
+{
+    ApplyMove();
+    if (mGrabbedItem != nullptr)
+    {
+        mAquarium->ItemMoved(mGrabbedItem);
+        mGrabbedItem = nullptr;
+    }
+
+    if (mGroupDrag)
+    {
+        mAquarium->ItemsMoved(mSelection);
+        mGroupDrag = false;
+    }
+
+    mBanding = false;
+    mBand = wxRect();
+}
@@ -0,0 +1,141 @@
+/**
+ * @file AquariumInput.h
+ * @author Josh Thomas
+ * @brief Header file for the AquariumInput class.
+ */
+
+#ifndef AQUARIUMINPUT_H
+#define AQUARIUMINPUT_H
+
+#include <memory>
+#include "ItemSelection.h"
+
+class Aquarium;
+class Item;
+
+/**
+ * @class AquariumInput
+ * @brief What the mouse does to an aquarium: picking, dragging and toggling items.
+ *
+ * Kept apart from the window, so the view and a headless
+ * replay of recorded input run exactly the same code.
+ * Each handler returns true if the aquarium needs redrawing.
+ *
+ * Pressing the button over nothing starts a rubber band, and
+ * every item the band overlaps is selected. Grabbing any selected
+ * item brings the whole selection to the front and drags it.
+ *
+ * Drag moves can be applied as they arrive with MouseMove, or
+ * queued with QueueMove and applied once a frame with ApplyMove,
+ * so a mouse that reports hundreds of moves a second costs one
+ * move per frame. Either way the item ends up in the same place,
+ * since only the latest location of a drag matters.
+ */
+class AquariumInput
+{
+private:
+    /// The aquarium the input goes to
+    Aquarium* mAquarium;
+
+    /// Item currently being dragged, if any
+    std::shared_ptr<Item> mGrabbedItem;
+
+    /// True if a drag move has been queued and not yet applied
+    bool mMovePending = false;
+
+    /// Latest queued X location of the dragged item
+    int mMoveX = 0;
+
+    /// Latest queued Y location of the dragged item
+    int mMoveY = 0;
+
+    /// The selected items
+    ItemSelection mSelection;
+
+    /// True while the selection is being dragged
+    bool mGroupDrag = false;
+
+    /// X location the selection has been dragged to so far
+    int mDragX = 0;
+
+    /// Y location the selection has been dragged to so far
+    int mDragY = 0;
+
+    /// True while a rubber band is being drawn
+    bool mBanding = false;
+
+    /// X location where the rubber band started
+    int mBandX = 0;
+
+    /// Y location where the rubber band started
+    int mBandY = 0;
+
+    /// The rubber band as of the last applied move
+    wxRect mBand;
+
+public:
+    /**
+     * Constructor
+     * @param aquarium The aquarium the input goes to
+     */
+    explicit AquariumInput(Aquarium* aquarium) : mAquarium(aquarium) {}
+
+    /// Copy constructor (disabled)
+    AquariumInput(const AquariumInput&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AquariumInput&) = delete;
+
+    bool LeftDown(int x, int y);
+    bool LeftUp(int x, int y);
+    bool MouseMove(int x, int y, bool leftDown);
+    bool LeftDClick(int x, int y);
+    bool QueueMove(int x, int y, bool leftDown, wxRect* dirty);
+    bool ApplyMove();
+    void EndDrag();
+
+    /**
+     * Forget the item being dragged without telling the
+     * aquarium, for when the aquarium is replaced
+     */
+    void Release()
+    {
+        mGrabbedItem = nullptr;
+        mMovePending = false;
+        mGroupDrag = false;
+        mBanding = false;
+        mSelection.Clear();
+    }
+
+    /**
+     * Is there a queued drag move that ApplyMove has not applied?
+     * @return true if a move is waiting
+     */
+    bool IsMovePending() const { return mMovePending; }
+
+    /**
+     * Is an item or the selection being dragged, or a rubber band drawn?
+     * @return true if mouse moves change anything
+     */
+    bool IsDragging() const { return mGrabbedItem != nullptr || mGroupDrag || mBanding; }
+
+    /**
+     * Is a rubber band being drawn?
+     * @return true if banding
+     */
+    bool IsBanding() const { return mBanding; }
+
+    /**
+     * Get the rubber band being drawn
+     * @return The band in pixels
+     */
+    const wxRect& GetBand() const { return mBand; }
+
+    /**
+     * Get the selected items
+     * @return The selection
+     */
+    const ItemSelection& GetSelection() const { return mSelection; }
+};
+
+#endif //AQUARIUMINPUT_H
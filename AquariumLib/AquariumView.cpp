@@ -4,24 +4,74 @@
  */
 #include "pch.h"
 #include "AquariumView.h"
-#include <wx/dcbuffer.h>
 #include "Aquarium.h"
+#include "AtlasRenderer.h"
+#include "AssetPreloader.h"
+#include "Tracer.h"
+#include "AquaXmlWriter.h"
+#include "AquaBinary.h"
 #include "FishBeta.h"
 #include "ids.h"
 #include <algorithm>
+#include <chrono>
 #include "FishCarp.h"
 #include "FishCatfish.h"
 #include "DecorCastle.h"
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
 
 using namespace std;
 
-/// Frame duration in milliseconds
-const int FrameDuration = 30;
+/// Longest time step we will simulate in one frame in seconds.
+/// Keeps fish from jumping after the view has been idle.
+const double MaxElapsed = 0.1;
+
+/// Most items we build from a progressive load in one frame.
+/// Keeps the view responsive while a big file loads.
+const size_t MaxLoadedPerFrame = 5000;
+
+/// How often the frame statistics in the status bar are refreshed in milliseconds
+const long StatsInterval = 500;
+
+/// Status bar field the frame statistics are shown in
+const int StatsField = 1;
+
+/// Margin around the frame statistics overlay in pixels
+const int StatsMargin = 6;
+
+/// Margin between the selected items and their outline in pixels
+const int SelectionMargin = 2;
+
+/// Name of the autosave journal in the user's data directory
+const wchar_t AutosaveName[] = L"autosave.aqua";
+
+/// Suffix an autosave journal that could not be recovered is renamed with
+const wchar_t AutosaveBadSuffix[] = L".bad";
+
+/// Name of the lock that says which instance owns the autosave journal
+const wchar_t AutosaveLockName[] = L"autosave.lock";
+
+/**
+ * Destructor. On a clean exit the autosave journal is no longer needed.
+ */
+AquariumView::~AquariumView()
+{
+    AssetPreloader::Get().SetHandler(nullptr);
+    mLoader.Cancel();
+    if (mAquarium.IsJournaling())
+    {
+        mAquarium.StopJournal();
+        wxRemoveFile(mAutosaveFile);
+    }
+}
 
 void AquariumView::Initialize(wxFrame* parent)
 {
+    mParentFrame = parent;
     mTimer.SetOwner(this);
-    mTimer.Start(FrameDuration);
+    mSaver.SetHandler(this);
+    mLoader.SetHandler(this);
+    AssetPreloader::Get().SetHandler(this);
     Create(parent, wxID_ANY);
     SetBackgroundStyle(wxBG_STYLE_PAINT);
     Bind(wxEVT_PAINT, &AquariumView::OnPaint, this);
@@ -30,148 +80,725 @@ void AquariumView::Initialize(wxFrame* parent)
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddFishCatFish, this, IDM_ADDFISHCATFISH);  // New binding for Catfish
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAddDecorCastle, this, IDM_ADDDECORCASTLE);  // Binding for Castle
     parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileSaveAs, this,wxID_SAVEAS);  // Binding for Castle
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFileOpen, this, wxID_OPEN);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnPause, this, IDM_PAUSE);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnFrameStats, this, IDM_FRAMESTATS);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnTrace, this, IDM_TRACE);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnSaveTrace, this, IDM_SAVETRACE);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnAllocations, this, IDM_ALLOCATIONS);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnMemoryUsage, this, IDM_MEMORYUSAGE);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnRecordInput, this, IDM_RECORDINPUT);
+    parent->Bind(wxEVT_COMMAND_MENU_SELECTED, &AquariumView::OnSaveInput, this, IDM_SAVEINPUT);
     Bind(wxEVT_LEFT_DCLICK, &AquariumView::OnLeftDClick, this); // Bind the double-click event
 
     Bind(wxEVT_LEFT_DOWN, &AquariumView::OnLeftDown, this);
     Bind(wxEVT_LEFT_UP, &AquariumView::OnLeftUp, this);
     Bind(wxEVT_MOTION, &AquariumView::OnMouseMove, this);
     Bind(wxEVT_TIMER, &AquariumView::OnTimerEvent, this);
+    Bind(EVT_SAVE_PROGRESS, &AquariumView::OnSaveProgress, this);
+    Bind(EVT_SAVE_COMPLETE, &AquariumView::OnSaveComplete, this);
+    Bind(EVT_LOAD_PROGRESS, &AquariumView::OnLoadProgress, this);
+    Bind(EVT_ASSET_READY, &AquariumView::OnAssetReady, this);
     mStopWatch.Start();
+    StartAutosave();
+    ScheduleFrame();
+}
+
+/**
+ * Recover the aquarium from the autosave journal, if the last run
+ * did not exit cleanly, then start journaling every edit to it.
+ *
+ * Only one running instance owns the journal. Any others run
+ * without autosave, rather than overwrite the first one's file.
+ */
+void AquariumView::StartAutosave()
+{
+    auto directory = wxStandardPaths::Get().GetUserLocalDataDir();
+    if (!wxFileName::DirExists(directory))
+    {
+        wxFileName::Mkdir(directory, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+
+    if (!mAutosaveOwner.Create(AutosaveLockName, directory) || mAutosaveOwner.IsAnotherRunning())
+    {
+        wxMessageBox(L"Another Aquarium is running, so this one will not autosave.");
+        return;
+    }
+
+    mAutosaveFile = directory + wxFileName::GetPathSeparator() + AutosaveName;
+    if (wxFileName::FileExists(mAutosaveFile) && !mAquarium.Load(mAutosaveFile))
+    {
+        // Keep what could not be recovered, rather than start the new journal over it
+        auto bad = mAutosaveFile + AutosaveBadSuffix;
+        if (wxRenameFile(mAutosaveFile, bad, true))
+        {
+            wxMessageBox(L"Unable to recover the autosaved aquarium. It was kept as " + bad);
+        }
+        else
+        {
+            wxMessageBox(L"Unable to recover the autosaved aquarium. Autosave is off.");
+            mAutosaveFile.clear();
+            return;
+        }
+    }
+
+    mAquarium.StartJournal(mAutosaveFile);
 }
 
 void AquariumView::OnPaint(wxPaintEvent& event)
 {
+    AQUARIUM_TRACE_ZONE("AquariumView::OnPaint");
+
     // Compute the time that has elapsed
     // since the last call to OnPaint.
     auto newTime = mStopWatch.Time();
-    auto elapsed = (double)(newTime - mTime) * 0.001;
+    auto elapsed = std::min((double)(newTime - mTime) * 0.001, MaxElapsed);
     mTime = newTime;
+    mScheduler.BeginFrame(newTime);
+    auto frameStart = chrono::steady_clock::now();
+    auto allocationStart = AllocationTracker::GetCounts();
+
+    // However many drag moves arrived since the last frame, only the latest is applied
+    mInput.ApplyMove();
+    ReceiveLoadedItems();
     mAquarium.Update(elapsed);
-    wxAutoBufferedPaintDC dc(this);
+    auto drawStart = chrono::steady_clock::now();
+
+    // Only redraw the frame if it differs from the one we drew last time.
+    // Otherwise the retained bitmap is all we need to put on the screen.
+    const auto& drawList = mAquarium.RecordDrawList();
+    auto size = GetClientSize();
+    auto update = GetUpdateRegion().GetBox();
+    bool partial = false;
+    if (size.GetWidth() > 0 && size.GetHeight() > 0)
+    {
+        bool resized = !mFrame.IsOk() || mFrame.GetSize() != size;
+        if (resized)
+        {
+            mFrame.Create(size);
+        }
+
+        // A drag over a still aquarium only invalidates part of the view
+        partial = mPartialFrame && !resized && !update.Contains(wxRect(size));
+
+        if (resized || !(drawList == mLastDrawList))
+        {
+            wxMemoryDC frameDC(mFrame);
+            AtlasRenderer renderer(&frameDC, &mAquarium.GetSprites().GetAtlas());
+
+            if (partial)
+            {
+                frameDC.SetClippingRegion(update);
+                frameDC.SetPen(*wxTRANSPARENT_PEN);
+                frameDC.SetBrush(*wxWHITE_BRUSH);
+                frameDC.DrawRectangle(update);
+                renderer.SetClip(update);
+            }
+            else
+            {
+                frameDC.SetBackground(*wxWHITE_BRUSH);
+                frameDC.Clear();
+            }
+
+            renderer.Render(drawList);
+            mLastDrawList = drawList;
+        }
+    }
+
+    wxPaintDC dc(this);
+    if (mFrame.IsOk())
+    {
+        if (partial)
+        {
+            wxMemoryDC frameDC(mFrame);
+            dc.Blit(update.GetPosition(), update.GetSize(), &frameDC, update.GetPosition());
+        }
+        else
+        {
+            dc.DrawBitmap(mFrame, 0, 0);
+        }
+    }
+    mPartialFrame = false;
+
+    // The drag is on the screen once the frame is
+    if (mInputPending && !mInput.IsMovePending())
+    {
+        mStats.AddInputLatency(chrono::duration<double, milli>(chrono::steady_clock::now() - mInputTime).count());
+        mInputPending = false;
+    }
+
+    auto frameEnd = chrono::steady_clock::now();
+    mStats.AddFrame(chrono::duration<double, milli>(frameStart.time_since_epoch()).count(),
+                    mAquarium.GetUpdateTime(),
+                    chrono::duration<double, milli>(frameEnd - drawStart).count(),
+                    chrono::duration<double, milli>(frameEnd - frameStart).count(),
+                    mAquarium.GetItemCount());
+    mFrameAllocations = AllocationTracker::GetCounts() - allocationStart;
+    DrawSelection(&dc);
+    ShowStats(&dc);
+
+    mScheduler.EndFrame(mStopWatch.Time());
+    ScheduleFrame();
+}
+
+/**
+ * Show the frame statistics in the status bar and, if
+ * asked for, over the aquarium.
+ *
+ * The status bar is only refreshed every StatsInterval, since
+ * changing it every frame would cost more than the frame.
+ *
+ * @param dc Device context the frame was painted on
+ */
+void AquariumView::ShowStats(wxDC* dc)
+{
+    bool refresh = mTime - mStatsShown >= StatsInterval;
+    if (!refresh && !mShowStats)
+    {
+        // Nothing to show, so don't format the text
+        return;
+    }
+
+    // The memory report walks every item, so it is only
+    // taken as often as the status bar is refreshed
+    if (refresh)
+    {
+        mMemorySummary = mAquarium.GetMemoryReport().FormatSummary();
+    }
+
+    auto text = mStats.Format(1000.0 / mScheduler.GetFrameRate()) + L" | " + mMemorySummary;
+    if (AllocationTracker::IsEnabled())
+    {
+        text += L" | " + AllocationTracker::Format(mFrameAllocations);
+    }
+
+    if (refresh)
+    {
+        auto statusBar = mParentFrame != nullptr ? mParentFrame->GetStatusBar() : nullptr;
+        if (statusBar != nullptr)
+        {
+            statusBar->SetStatusText(text, StatsField);
+        }
+        mStatsShown = mTime;
+    }
+
+    if (!mShowStats)
+    {
+        return;
+    }
+
+    // Drawn on the window only, so it never ends up in the retained frame
+    auto size = dc->GetTextExtent(text);
+    mStatsRect = wxRect(0, 0, size.GetWidth() + StatsMargin * 2, size.GetHeight() + StatsMargin * 2);
+    dc->SetPen(*wxTRANSPARENT_PEN);
+    dc->SetBrush(*wxBLACK_BRUSH);
+    dc->DrawRectangle(mStatsRect);
+    dc->SetTextForeground(*wxWHITE);
+    dc->DrawText(text, StatsMargin, StatsMargin);
+}
+
+/**
+ * Outline the rubber band being drawn and the selected items.
+ *
+ * Drawn on the window only, like the statistics, so a
+ * selection never changes the retained frame.
+ *
+ * @param dc Device context the frame was painted on
+ */
+void AquariumView::DrawSelection(wxDC* dc)
+{
+    const auto& selection = mInput.GetSelection();
+    if (!mInput.IsBanding() && selection.IsEmpty())
+    {
+        return;
+    }
+
+    dc->SetBrush(*wxTRANSPARENT_BRUSH);
+    if (!selection.IsEmpty())
+    {
+        auto bounds = mAquarium.GetBounds(selection);
+        bounds.Inflate(SelectionMargin);
+        dc->SetPen(mSelectionPen);
+        dc->DrawRectangle(bounds);
+    }
+
+    if (mInput.IsBanding())
+    {
+        dc->SetPen(mBandPen);
+        dc->DrawRectangle(mInput.GetBand());
+    }
+}
+
+/**
+ * Frame statistics menu option handler
+ * @param event Menu event
+ */
+void AquariumView::OnFrameStats(wxCommandEvent& event)
+{
+    mShowStats = event.IsChecked();
+    RequestFrame();
+}
+
+/**
+ * Record trace menu option handler
+ * @param event Menu event
+ */
+void AquariumView::OnTrace(wxCommandEvent& event)
+{
+    if (event.IsChecked())
+    {
+        Tracer::Get().Start();
+        SetStatus(L"Recording trace");
+    }
+    else
+    {
+        Tracer::Get().Stop();
+        SetStatus(L"Stopped recording trace");
+    }
+}
+
+/**
+ * Save trace menu option handler
+ * @param event Menu event
+ */
+void AquariumView::OnSaveTrace(wxCommandEvent& event)
+{
+    wxFileDialog saveFileDialog(this, L"Save Trace", L"", L"aquarium-trace.json",
+        L"Trace Files (*.json)|*.json", wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
+    if (saveFileDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    auto filename = saveFileDialog.GetPath();
+    if (Tracer::Get().Write(filename))
+    {
+        SetStatus(L"Saved trace " + filename);
+    }
+    else
+    {
+        wxMessageBox(L"Unable to write " + filename, L"Save Trace", wxOK | wxICON_ERROR, this);
+    }
+}
+
+/**
+ * Count allocations menu option handler
+ * @param event Menu event
+ */
+void AquariumView::OnAllocations(wxCommandEvent& event)
+{
+    if (event.IsChecked())
+    {
+        AllocationTracker::Reset();
+        AllocationTracker::Start();
+    }
+    else
+    {
+        AllocationTracker::Stop();
+    }
+
+    RequestFrame();
+}
 
-    wxBrush background(*wxWHITE);
-    dc.SetBackground(background);
-    dc.Clear();
+/**
+ * Memory usage menu option handler
+ * @param event Menu event
+ */
+void AquariumView::OnMemoryUsage(wxCommandEvent& event)
+{
+    wxMessageBox(mAquarium.GetMemoryReport().Format(), L"Memory Usage", wxOK | wxICON_INFORMATION, this);
+}
+
+/**
+ * Record input menu option handler.
+ *
+ * Starting a recording reseeds the aquarium, so a
+ * replay sees the same random numbers the fish did.
+ * @param event Menu event
+ */
+void AquariumView::OnRecordInput(wxCommandEvent& event)
+{
+    if (event.IsChecked())
+    {
+        mInput.EndDrag();
+        mRecorder.Start(&mAquarium);
+        SetStatus(wxString::Format(L"Recording input, seed %u", mRecorder.GetSeed()));
+    }
+    else
+    {
+        mRecorder.Stop();
+        SetStatus(wxString::Format(L"Recorded %llu input events", (unsigned long long)mRecorder.GetEventCount()));
+    }
+}
+
+/**
+ * Save input recording menu option handler
+ * @param event Menu event
+ */
+void AquariumView::OnSaveInput(wxCommandEvent& event)
+{
+    wxFileDialog saveFileDialog(this, L"Save Input Recording", L"", L"aquarium-input.aqin",
+        L"Input Recordings (*.aqin)|*.aqin", wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
+    if (saveFileDialog.ShowModal() == wxID_CANCEL)
+    {
+        return;
+    }
+
+    auto filename = saveFileDialog.GetPath();
+    if (mRecorder.Save(filename))
+    {
+        SetStatus(L"Saved input recording " + filename);
+    }
+    else
+    {
+        wxMessageBox(L"Unable to write " + filename, L"Save Input Recording", wxOK | wxICON_ERROR, this);
+    }
+}
+
+/**
+ * Start the frame timer if the scheduler wants another frame.
+ *
+ * Does nothing if the timer is already running or the scene
+ * is static, so an idle aquarium uses no CPU.
+ */
+void AquariumView::ScheduleFrame()
+{
+    auto delay = mScheduler.NextDelay(mStopWatch.Time(), IsAnimating());
+    if (delay >= 0 && !mTimer.IsRunning())
+    {
+        mTimer.StartOnce((int)delay);
+    }
+}
 
-    mAquarium.OnDraw(&dc);
+/**
+ * Ask for the view to be redrawn on the next frame.
+ *
+ * Use this instead of Refresh() so repaints are coalesced
+ * by the frame scheduler.
+ */
+void AquariumView::RequestFrame()
+{
+    mFullRepaint = true;
+    mScheduler.Invalidate();
+    ScheduleFrame();
+}
+
+/**
+ * Ask for part of the view to be redrawn on the next frame,
+ * for a drag that changes nothing else.
+ *
+ * Requests are coalesced like RequestFrame's. If nothing
+ * else needs a repaint by the time the frame comes round,
+ * only the areas the drags changed are repainted.
+ *
+ * @param dirty Area of the view the drag changed
+ */
+void AquariumView::RequestDragFrame(const wxRect& dirty)
+{
+    mDirty.Union(dirty);
+    mScheduler.Invalidate();
+    ScheduleFrame();
 }
 
 void AquariumView::OnAddFishBetaFish(wxCommandEvent& event)
 {
     auto fish = make_shared<FishBeta>(&mAquarium);
     mAquarium.Add(fish);
-    Refresh();
+    RequestFrame();
 }
 
 void AquariumView::OnAddFishCarp(wxCommandEvent& event)
 {
     auto fish = std::make_shared<FishCarp>(&mAquarium);  // Create the new carp fish
     mAquarium.Add(fish);  // Add to the aquarium
-    Refresh();  // Redraw the view
+    RequestFrame();  // Redraw the view
 }
 
 void AquariumView::OnAddFishCatFish(wxCommandEvent& event)
 {
     auto fish = std::make_shared<FishCatfish>(&mAquarium);  // Create the new catfish
     mAquarium.Add(fish);  // Add to the aquarium
-    Refresh();  // Redraw the view
+    RequestFrame();  // Redraw the view
 }
 void AquariumView::OnAddDecorCastle(wxCommandEvent& event)
 {
     auto castle = std::make_shared<DecorCastle>(&mAquarium);  // Create the new castle
     mAquarium.Add(castle);  // Add to the aquarium
-    Refresh();  // Redraw the view
+    RequestFrame();  // Redraw the view
 }
 
 void AquariumView::OnFileSaveAs(wxCommandEvent& event)
 {
+    if (mSaver.IsBusy())
+    {
+        wxMessageBox(L"The last save has not finished yet.", L"Save Aquarium file", wxOK, this);
+        return;
+    }
+
     wxFileDialog saveFileDialog(this, L"Save Aquarium file", L"", L"",
-        L"Aquarium Files (*.aqua)|*.aqua", wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
+        L"Aquarium Files (*.aqua)|*.aqua|Binary Aquarium Files (*.aqb)|*.aqb|"
+        L"Compressed Aquarium Files (*.aqua.gz)|*.aqua.gz", wxFD_SAVE|wxFD_OVERWRITE_PROMPT);
     if (saveFileDialog.ShowModal() == wxID_CANCEL)
     {
         return;
     }
 
     auto filename = saveFileDialog.GetPath();
-    mAquarium.Save(filename);
+    if (saveFileDialog.GetFilterIndex() == 1 && !AquaBinary::IsBinaryName(filename))
+    {
+        filename += BinaryExtension;
+    }
+    else if (saveFileDialog.GetFilterIndex() == 2 && !AquaXmlWriter::IsCompressedName(filename))
+    {
+        filename += CompressedExtension;
+    }
+
+    // The format follows the name, so the file says what is in it
+    auto format = AquaBinary::IsBinaryName(filename) ?
+        BackgroundSaver::Format::Binary : BackgroundSaver::Format::Xml;
+
+    // The snapshot is all the saver needs, so the fish keep swimming
+    AquaSnapshot snapshot;
+    mAquarium.TakeSnapshot(&snapshot);
+    mSaver.Start(filename, format, std::move(snapshot));
+    SetStatus(L"Saving " + filename);
+}
+
+/**
+ * Show progress of a background save
+ * @param event Thread event, GetInt() is the percent complete
+ */
+void AquariumView::OnSaveProgress(wxThreadEvent& event)
+{
+    SetStatus(wxString::Format(L"Saving... %d%%", event.GetInt()));
+}
+
+/**
+ * Report the end of a background save
+ * @param event Thread event, GetInt() is nonzero on success
+ */
+void AquariumView::OnSaveComplete(wxThreadEvent& event)
+{
+    if (event.GetInt() != 0)
+    {
+        SetStatus(L"Saved " + event.GetString());
+    }
+    else
+    {
+        SetStatus(L"");
+        wxMessageBox(L"Unable to save " + event.GetString(), L"Save Aquarium file", wxOK | wxICON_ERROR, this);
+    }
+}
+
+/**
+ * Show a message in the frame's status bar, if it has one
+ * @param text Message to show
+ */
+void AquariumView::SetStatus(const wxString& text)
+{
+    auto statusBar = mParentFrame != nullptr ? mParentFrame->GetStatusBar() : nullptr;
+    if (statusBar != nullptr)
+    {
+        statusBar->SetStatusText(text);
+    }
 }
 void AquariumView::OnFileOpen(wxCommandEvent& event)
 {
     wxFileDialog loadFileDialog(this, L"Load Aquarium file", L"", L"",
-            L"Aquarium Files (*.aqua)|*.aqua", wxFD_OPEN);
+            L"Aquarium Files (*.aqua;*.aqua.gz;*.aqb)|*.aqua;*.aqua.gz;*.aqb", wxFD_OPEN);
     if (loadFileDialog.ShowModal() == wxID_CANCEL)
     {
         return;
     }
 
     auto filename = loadFileDialog.GetPath();
-    mAquarium.Load(filename);
-    Refresh();
+    StopLoading();
+    mInput.Release();
+
+    // Most files load in the background, with items appearing
+    // as they arrive. Journals have to be replayed in one go.
+    if (ProgressiveLoader::CanLoad(filename) && mLoader.Start(filename))
+    {
+        mAquarium.BeginLoad();
+        mReceiving = true;
+        mLoadingFile = filename;
+        mLoadBatch = AquaSnapshot();
+        SetStatus(L"Loading " + filename);
+    }
+    else if (!mAquarium.Load(filename))
+    {
+        wxMessageBox(L"Unable to load Aquarium file");
+    }
 
+    RequestFrame();
 }
 
+/**
+ * Build the next batch of items from a progressive load.
+ *
+ * Called once a frame while a load is in progress.
+ */
+void AquariumView::ReceiveLoadedItems()
+{
+    if (!mReceiving)
+    {
+        return;
+    }
 
+    mLoader.Take(MaxLoadedPerFrame, &mLoadBatch);
+    mAquarium.AddRecords(mLoadBatch.species, mLoadBatch.records.data(), mLoadBatch.records.size());
 
-void AquariumView::OnLeftDown(wxMouseEvent& event)
+    if (mLoader.IsLoading())
+    {
+        SetStatus(wxString::Format(L"Loading... %d%%", mLoader.GetPercent()));
+        return;
+    }
+
+    // Everything has arrived
+    mReceiving = false;
+    mAquarium.EndLoad();
+    if (mLoader.Failed())
+    {
+        // We are inside a paint, so report it once that is over
+        SetStatus(L"");
+        auto message = L"Unable to load " + mLoadingFile + L". Only part of it was loaded.";
+        CallAfter([this, message]() {
+            wxMessageBox(message, L"Load Aquarium file", wxOK | wxICON_ERROR, this);
+        });
+    }
+    else
+    {
+        SetStatus(L"Loaded " + mLoadingFile);
+    }
+}
+
+/**
+ * Abandon any progressive load, keeping the items loaded so far
+ */
+void AquariumView::StopLoading()
 {
-    mGrabbedItem = mAquarium.HitTest(event.GetX(), event.GetY());
+    if (mReceiving)
+    {
+        mLoader.Cancel();
+        mReceiving = false;
+        mAquarium.EndLoad();
+        SetStatus(L"");
+    }
+}
 
-    if (mGrabbedItem != nullptr)
+/**
+ * Does the view need to keep drawing frames?
+ * @return true if anything is moving or items are still loading
+ */
+bool AquariumView::IsAnimating()
+{
+    return mAquarium.IsAnimating() || mReceiving;
+}
+
+/**
+ * The progressive loader has items ready, or has finished
+ * @param event Thread event
+ */
+void AquariumView::OnLoadProgress(wxThreadEvent& event)
+{
+    RequestFrame();
+}
+
+/**
+ * An image has finished preloading. Redraw so the
+ * items waiting on it appear.
+ * @param event Thread event
+ */
+void AquariumView::OnAssetReady(wxThreadEvent& event)
+{
+    RequestFrame();
+}
+
+void AquariumView::OnLeftDown(wxMouseEvent& event)
+{
+    mRecorder.Record(InputEventType::LeftDown, event.GetX(), event.GetY(), event.LeftIsDown());
+    if (mInput.LeftDown(event.GetX(), event.GetY()))
     {
-        // Move the grabbed item to the end of the list
-        mAquarium.MoveToEnd(mGrabbedItem);
+        RequestFrame();
     }
 }
 
 void AquariumView::OnLeftUp(wxMouseEvent& event)
 {
-    auto clickedItem = mAquarium.HitTest(event.GetX(), event.GetY());
-
-    if (clickedItem != nullptr) {
-        // Use polymorphism to call IsActive and ToggleState
-        if (clickedItem->IsActive()) {
-            clickedItem->ToggleState();  // Set back to dormant state on single click
-            Refresh();  // Redraw the view
-        }
+    mRecorder.Record(InputEventType::LeftUp, event.GetX(), event.GetY(), event.LeftIsDown());
+    if (mInput.LeftUp(event.GetX(), event.GetY()))
+    {
+        RequestFrame();  // Redraw the view
     }
 }
 
 void AquariumView::OnMouseMove(wxMouseEvent& event)
 {
-    // See if an item is currently being moved by the mouse
-    if (mGrabbedItem != nullptr)
+    // Moves with nothing grabbed change nothing, so are not worth recording
+    if (mInput.IsDragging())
+    {
+        mRecorder.Record(InputEventType::MouseMove, event.GetX(), event.GetY(), event.LeftIsDown());
+    }
+
+    // The move is applied when the frame is drawn, so a
+    // burst of moves between frames costs only one
+    wxRect dirty;
+    if (mInput.QueueMove(event.GetX(), event.GetY(), event.LeftIsDown(), &dirty))
     {
-        // If an item is being moved, we only continue to move it while the left button is down.
-        if (event.LeftIsDown())
+        if (!mInputPending)
+        {
+            mInputTime = chrono::steady_clock::now();
+            mInputPending = true;
+        }
+
+        // Moving the selection or the band can change the whole view
+        if (dirty.IsEmpty())
         {
-            mGrabbedItem->SetLocation(event.GetX(), event.GetY());
+            RequestFrame();
         }
         else
         {
-            // When the left button is released, we release the item.
-            mGrabbedItem = nullptr;
+            RequestDragFrame(dirty);
         }
-
-        // Force the screen to redraw
-        Refresh();
     }
 }
 
 void AquariumView::OnLeftDClick(wxMouseEvent& event)
 {
-    auto clickedItem = mAquarium.HitTest(event.GetX(), event.GetY());
+    mRecorder.Record(InputEventType::LeftDClick, event.GetX(), event.GetY(), event.LeftIsDown());
+    if (mInput.LeftDClick(event.GetX(), event.GetY()))
+    {
+        // Redraw the view after the state is toggled
+        RequestFrame();
+    }
+}
 
-    if (clickedItem != nullptr)
+void AquariumView::OnTimerEvent(wxTimerEvent& event)
+{
+    if (mScheduler.RequestRepaint(IsAnimating()))
     {
-        // Call the virtual ToggleState method on the clicked item
-        clickedItem->ToggleState();
+        if (mFullRepaint || mDirty.IsEmpty() || IsAnimating())
+        {
+            Refresh();
+        }
+        else
+        {
+            // Only a drag changed, so only its old and new bounds are repainted
+            if (mShowStats)
+            {
+                mDirty.Union(mStatsRect);
+            }
+            mPartialFrame = true;
+            RefreshRect(mDirty, false);
+        }
 
-        // Redraw the view after the state is toggled (if necessary)
-        Refresh();  // Ensure the screen refreshes to display the new state
+        mFullRepaint = false;
+        mDirty = wxRect();
     }
 }
 
-void AquariumView::OnTimerEvent(wxTimerEvent& event)
+void AquariumView::OnPause(wxCommandEvent& event)
 {
-    Refresh();
+    mAquarium.SetPaused(event.IsChecked());
+    RequestFrame();
 }
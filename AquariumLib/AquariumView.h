@@ -10,7 +10,16 @@
 #ifndef AQUARIUMVIEW_H
 #define AQUARIUMVIEW_H
 #include <wx/wx.h>
+#include <wx/snglinst.h>
+#include <chrono>
 #include "Aquarium.h"
+#include "AquariumInput.h"
+#include "BackgroundSaver.h"
+#include "FrameScheduler.h"
+#include "FrameStats.h"
+#include "InputRecorder.h"
+#include "AllocationTracker.h"
+#include "ProgressiveLoader.h"
 
 /**
  * @class AquariumView
@@ -33,17 +42,119 @@ private:
     /// Aquarium object managing the aquarium state.
     Aquarium mAquarium;
 
-    /// Currently grabbed item for dragging.
-    std::shared_ptr<Item> mGrabbedItem;
+    /// Picks, drags and toggles items under the mouse
+    AquariumInput mInput{&mAquarium};
+
+    /// Records the mouse input, while recording input
+    InputRecorder mRecorder;
+
     /// The timer that allows for animation
     wxTimer mTimer;
+
+    /// Decides when the next frame should be drawn
+    FrameScheduler mScheduler;
+
     /// Stopwatch used to measure elapsed time
     wxStopWatch mStopWatch;
 
     /// The last stopwatch time
     long mTime = 0;
 
+    /// What the recent frames cost
+    FrameStats mStats;
+
+    /// Stopwatch time the frame statistics were last shown
+    long mStatsShown = 0;
+
+    /// True to draw the frame statistics over the aquarium
+    bool mShowStats = false;
+
+    /// Where the frame statistics were last drawn over the aquarium
+    wxRect mStatsRect;
+
+    /// True if the next frame has to repaint the whole view
+    bool mFullRepaint = true;
+
+    /// Area of the view drags have changed since the last frame
+    wxRect mDirty;
+
+    /// True if the frame being painted was asked for by drags alone
+    bool mPartialFrame = false;
+
+    /// True if a drag move has arrived that is not on the screen yet
+    bool mInputPending = false;
+
+    /// When the oldest drag move not on the screen yet arrived
+    std::chrono::steady_clock::time_point mInputTime;
+
+    /// Allocations made by the last frame, while counting allocations
+    AllocationCounts mFrameAllocations;
+
+    /// Memory summary shown with the frame statistics
+    wxString mMemorySummary;
+
+    /// The last frame we drew, kept so an unchanged frame is not redrawn
+    wxBitmap mFrame;
+
+    /// The draw list mFrame was drawn from
+    DrawList mLastDrawList;
+
+    /// Pen the selection bounds are drawn with
+    wxPen mSelectionPen{*wxBLUE, 1, wxPENSTYLE_SOLID};
+
+    /// Pen the rubber band is drawn with
+    wxPen mBandPen{*wxBLACK, 1, wxPENSTYLE_SHORT_DASH};
+
+    /// The frame we are in, used for the status bar
+    wxFrame* mParentFrame = nullptr;
+
+    /// Writes saved files without stopping the animation
+    BackgroundSaver mSaver;
+
+    /// Journal file every edit is autosaved to, empty if autosave is off
+    wxString mAutosaveFile;
+
+    /// Held while this instance owns the autosave journal
+    wxSingleInstanceChecker mAutosaveOwner;
+
+    /// Reads opened files in the background
+    ProgressiveLoader mLoader;
+
+    /// True while items from mLoader are still arriving
+    bool mReceiving = false;
+
+    /// The file mLoader is loading
+    wxString mLoadingFile;
+
+    /// Receives each batch from mLoader. Kept from frame to frame,
+    /// so the species table is only copied when it changes.
+    AquaSnapshot mLoadBatch;
+
+    void ScheduleFrame();
+    void RequestFrame();
+    void RequestDragFrame(const wxRect& dirty);
+    void StartAutosave();
+    void ReceiveLoadedItems();
+    void StopLoading();
+    bool IsAnimating();
+    void OnLoadProgress(wxThreadEvent& event);
+    void OnAssetReady(wxThreadEvent& event);
+    void OnFrameStats(wxCommandEvent& event);
+    void OnTrace(wxCommandEvent& event);
+    void OnSaveTrace(wxCommandEvent& event);
+    void OnAllocations(wxCommandEvent& event);
+    void OnMemoryUsage(wxCommandEvent& event);
+    void OnRecordInput(wxCommandEvent& event);
+    void OnSaveInput(wxCommandEvent& event);
+    void ShowStats(wxDC* dc);
+    void DrawSelection(wxDC* dc);
+    void SetStatus(const wxString& text);
+    void OnSaveProgress(wxThreadEvent& event);
+    void OnSaveComplete(wxThreadEvent& event);
+
 public:
+    ~AquariumView();
+
     /**
      * @brief Initializes the AquariumView.
      * @param parent Parent wxFrame object.
@@ -114,6 +225,12 @@ public:
      * @param event wxMouseEvent object for the event.
      */
     void OnTimerEvent(wxTimerEvent& event);
+
+    /**
+     * @brief Handles the pause menu option.
+     * @param event wxCommandEvent object for the event.
+     */
+    void OnPause(wxCommandEvent& event);
 };
 
 #endif // AQUARIUMVIEW_H
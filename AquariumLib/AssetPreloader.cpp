@@ -0,0 +1,199 @@
+/**
+ * @file AssetPreloader.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "AssetPreloader.h"
+#include <wx/filefn.h>
+#include <wx/textfile.h>
+#include <algorithm>
+
+using namespace std;
+
+wxDEFINE_EVENT(EVT_ASSET_READY, wxThreadEvent);
+
+/**
+ * Get the preloader
+ * @return The one asset preloader
+ */
+AssetPreloader& AssetPreloader::Get()
+{
+    static AssetPreloader preloader;
+    return preloader;
+}
+
+/**
+ * Destructor
+ */
+AssetPreloader::~AssetPreloader()
+{
+    Stop();
+}
+
+/**
+ * Read the list of files in an asset manifest.
+ *
+ * One filename per line. Blank lines and lines
+ * starting with '#' are ignored.
+ *
+ * @param filename The manifest file
+ * @return The files it lists, empty if it cannot be read
+ */
+std::vector<std::wstring> AssetPreloader::ReadManifest(const wxString& filename)
+{
+    vector<wstring> files;
+
+    wxTextFile manifest;
+    if (!wxFileExists(filename) || !manifest.Open(filename))
+    {
+        return files;
+    }
+
+    for (auto line = manifest.GetFirstLine(); !manifest.Eof(); line = manifest.GetNextLine())
+    {
+        line.Trim(true).Trim(false);
+        if (!line.IsEmpty() && !line.StartsWith(L"#"))
+        {
+            files.push_back(line.ToStdWstring());
+        }
+    }
+
+    return files;
+}
+
+/**
+ * Start decoding images. Image handlers must already be initialized.
+ * @param files Image files to decode
+ * @param threads Number of worker threads, 0 for one per core
+ */
+void AssetPreloader::Start(const std::vector<std::wstring>& files, int threads)
+{
+    Stop();
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        for (const auto& file : files)
+        {
+            if (mAssets.emplace(file, Asset()).second)
+            {
+                mQueue.push_back(file);
+                mPending++;
+            }
+        }
+    }
+
+    if (threads <= 0)
+    {
+        threads = (int)max(thread::hardware_concurrency(), 1u);
+    }
+
+    threads = min(threads, (int)mQueue.size());
+    for (int i = 0; i < threads; i++)
+    {
+        mWorkers.emplace_back(&AssetPreloader::Work, this);
+    }
+}
+
+/**
+ * Stop decoding, wait for the workers and release every image
+ */
+void AssetPreloader::Stop()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mQueue.clear();
+    }
+
+    for (auto& worker : mWorkers)
+    {
+        worker.join();
+    }
+
+    mWorkers.clear();
+    mAssets.clear();
+    mPending = 0;
+}
+
+/**
+ * Set the handler told when each image is ready
+ * @param handler Event handler, or nullptr for none
+ */
+void AssetPreloader::SetHandler(wxEvtHandler* handler)
+{
+    lock_guard<mutex> lock(mMutex);
+    mHandler = handler;
+}
+
+/**
+ * Get a preloaded image
+ * @param filename Image file
+ * @param image Receives the image if it is Ready
+ * @return Where the image is in preloading
+ */
+AssetPreloader::State AssetPreloader::Take(const std::wstring& filename, wxImage* image)
+{
+    lock_guard<mutex> lock(mMutex);
+    auto found = mAssets.find(filename);
+    if (found == mAssets.end())
+    {
+        return State::Unknown;
+    }
+
+    if (found->second.state == State::Ready)
+    {
+        *image = *found->second.image;
+    }
+
+    return found->second.state;
+}
+
+/**
+ * Are any images still being decoded?
+ * @return true if any are pending
+ */
+bool AssetPreloader::IsBusy()
+{
+    lock_guard<mutex> lock(mMutex);
+    return mPending > 0;
+}
+
+/**
+ * A worker thread. Decodes images until the queue is empty.
+ */
+void AssetPreloader::Work()
+{
+    for (;;)
+    {
+        wstring filename;
+        {
+            lock_guard<mutex> lock(mMutex);
+            if (mQueue.empty())
+            {
+                return;
+            }
+
+            filename = mQueue.front();
+            mQueue.pop_front();
+        }
+
+        auto image = make_unique<wxImage>();
+        bool ok = image->LoadFile(filename, wxBITMAP_TYPE_ANY);
+
+        // The image moves into the asset without its reference
+        // count being touched, so only the UI thread ever does
+        lock_guard<mutex> lock(mMutex);
+        auto& asset = mAssets[filename];
+        asset.state = ok ? State::Ready : State::Failed;
+        if (ok)
+        {
+            asset.image = std::move(image);
+        }
+        mPending--;
+
+        if (mHandler != nullptr)
+        {
+            wxQueueEvent(mHandler, new wxThreadEvent(EVT_ASSET_READY));
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file AssetPreloader.h
+ * @author Josh Thomas
+ * @brief Header file for the AssetPreloader class.
+ */
+
+#ifndef ASSETPRELOADER_H
+#define ASSETPRELOADER_H
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// Sent each time an image finishes decoding
+wxDECLARE_EVENT(EVT_ASSET_READY, wxThreadEvent);
+
+/// The manifest listing every image the aquarium uses
+const wchar_t AssetManifestName[] = L"images/manifest.txt";
+
+/**
+ * @class AssetPreloader
+ * @brief Decodes the images in the asset manifest on worker threads.
+ *
+ * Started once at startup, so no image decoding happens on the UI
+ * thread and the window can be shown right away. SpriteLibrary asks
+ * for each image as it is needed and hands out a placeholder sprite
+ * until the image is ready.
+ *
+ * Images are decoded into wxImages, which are not GUI objects and are
+ * safe to create on any thread. Bitmaps are made later, by SpriteLibrary
+ * on the UI thread. Decoded images are owned here until Stop and are
+ * only ever copied on the UI thread, since wx reference counting is
+ * not thread safe.
+ */
+class AssetPreloader
+{
+public:
+    /// Where an image is in preloading
+    enum class State
+    {
+        Unknown,    ///< Not in the manifest; load it directly
+        Pending,    ///< Waiting to be decoded or being decoded
+        Ready,      ///< Decoded and ready to use
+        Failed      ///< Could not be decoded
+    };
+
+private:
+    /**
+     * One image being preloaded
+     */
+    struct Asset
+    {
+        /// Where the image is in preloading
+        State state = State::Pending;
+
+        /// The decoded image once state is Ready
+        std::unique_ptr<wxImage> image;
+    };
+
+    /// Protects the members below it
+    std::mutex mMutex;
+
+    /// Every preloaded image, by filename
+    std::unordered_map<std::wstring, Asset> mAssets;
+
+    /// Files waiting for a worker
+    std::deque<std::wstring> mQueue;
+
+    /// Number of images not yet Ready or Failed
+    size_t mPending = 0;
+
+    /// Handler that receives our events, may be nullptr
+    wxEvtHandler* mHandler = nullptr;
+
+    /// The worker threads
+    std::vector<std::thread> mWorkers;
+
+    AssetPreloader() = default;
+    void Work();
+
+public:
+    /// Copy constructor (disabled)
+    AssetPreloader(const AssetPreloader&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const AssetPreloader&) = delete;
+
+    ~AssetPreloader();
+
+    static AssetPreloader& Get();
+    static std::vector<std::wstring> ReadManifest(const wxString& filename);
+
+    void Start(const std::vector<std::wstring>& files, int threads = 0);
+    void Stop();
+    void SetHandler(wxEvtHandler* handler);
+    State Take(const std::wstring& filename, wxImage* image);
+    bool IsBusy();
+};
+
+#endif //ASSETPRELOADER_H
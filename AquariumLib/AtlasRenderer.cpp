@@ -0,0 +1,61 @@
+/**
+ * @file AtlasRenderer.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "AtlasRenderer.h"
+#include "DrawList.h"
+#include "SpriteAtlas.h"
+#include "Tracer.h"
+#include <wx/dcmemory.h>
+
+/**
+ * Constructor
+ * @param dc Device context to draw on
+ * @param atlas Atlas the sprite ids are looked up in
+ */
+AtlasRenderer::AtlasRenderer(wxDC* dc, const SpriteAtlas* atlas) : mDC(dc), mAtlas(atlas)
+{
+}
+
+/**
+ * Draw every command in the list
+ * @param list The list to draw, already batched
+ */
+void AtlasRenderer::Render(const DrawList& list)
+{
+    AQUARIUM_TRACE_ZONE("AtlasRenderer::Render");
+    wxMemoryDC source;
+    int selected = -1;
+
+    const auto& commands = list.GetCommands();
+    for (const auto& batch : list.GetBatches())
+    {
+        const auto& region = mAtlas->GetRegion(batch.sprite, batch.mirror);
+        if (region.page < 0)
+        {
+            continue;
+        }
+
+        if (region.page != selected)
+        {
+            source.SelectObjectAsSource(mAtlas->GetPage(region.page));
+            selected = region.page;
+        }
+
+        const auto& rect = region.rect;
+        auto end = batch.first + batch.count;
+        for (auto i = batch.first; i < end; i++)
+        {
+            if (!mClip.IsEmpty() &&
+                !mClip.Intersects(wxRect(commands[i].x, commands[i].y, rect.GetWidth(), rect.GetHeight())))
+            {
+                continue;
+            }
+
+            mDC->Blit(commands[i].x, commands[i].y, rect.GetWidth(), rect.GetHeight(),
+                      &source, rect.GetLeft(), rect.GetTop(), wxCOPY, true);
+        }
+    }
+}
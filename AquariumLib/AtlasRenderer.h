@@ -0,0 +1,48 @@
+/**
+ * @file AtlasRenderer.h
+ * @author Josh Thomas
+ * @brief Header file for the AtlasRenderer class.
+ */
+
+#ifndef ATLASRENDERER_H
+#define ATLASRENDERER_H
+
+#include "DrawListRenderer.h"
+
+class SpriteAtlas;
+
+/**
+ * @class AtlasRenderer
+ * @brief Plays a DrawList back onto a wxDC, blitting from a sprite atlas.
+ *
+ * The source page is only selected again when a batch is on a
+ * different page from the last, which for most frames is never.
+ */
+class AtlasRenderer : public DrawListRenderer
+{
+private:
+    /// Device context we draw on
+    wxDC* mDC;
+
+    /// Atlas the sprite ids are looked up in
+    const SpriteAtlas* mAtlas;
+
+    /// Only sprites that overlap this are drawn, empty to draw everything
+    wxRect mClip;
+
+public:
+    AtlasRenderer(wxDC* dc, const SpriteAtlas* atlas);
+
+    void Render(const DrawList& list) override;
+
+    /**
+     * Only draw the sprites that overlap a rectangle.
+     *
+     * The device context should be clipped to the same
+     * rectangle, since sprites that overlap it are drawn whole.
+     * @param clip Rectangle to draw in, empty to draw everything
+     */
+    void SetClip(const wxRect& clip) { mClip = clip; }
+};
+
+#endif //ATLASRENDERER_H
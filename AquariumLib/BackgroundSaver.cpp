@@ -0,0 +1,193 @@
+/**
+ * @file BackgroundSaver.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "BackgroundSaver.h"
+#include "AquaBinary.h"
+#include "AquaXmlWriter.h"
+#include "Tracer.h"
+#include "AllocationTracker.h"
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/wfstream.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+wxDEFINE_EVENT(EVT_SAVE_PROGRESS, wxThreadEvent);
+wxDEFINE_EVENT(EVT_SAVE_COMPLETE, wxThreadEvent);
+
+/**
+ * Destructor. Waits for any save in flight, so it is never lost.
+ */
+BackgroundSaver::~BackgroundSaver()
+{
+    Wait();
+}
+
+/**
+ * Start saving a snapshot
+ * @param filename File to save to
+ * @param format File format to use
+ * @param snapshot The items to save, taken over by the saver
+ * @return false if a save is already running
+ */
+bool BackgroundSaver::Start(const wxString& filename, Format format, AquaSnapshot&& snapshot)
+{
+    if (mBusy)
+    {
+        return false;
+    }
+
+    // Reap the last save, which has already finished
+    Wait();
+
+    mBusy = true;
+    mThread = thread(&BackgroundSaver::Run, this, filename.ToStdWstring(), format, std::move(snapshot));
+    return true;
+}
+
+/**
+ * Block until any save in flight has finished
+ */
+void BackgroundSaver::Wait()
+{
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+/**
+ * The worker thread
+ * @param filename File to save to
+ * @param format File format to use
+ * @param snapshot The items to save
+ */
+void BackgroundSaver::Run(std::wstring filename, Format format, AquaSnapshot snapshot)
+{
+    int lastPercent = -1;
+    auto progress = [this, &lastPercent](size_t written, size_t total) {
+        int percent = total > 0 ? (int)(written * 100 / total) : 100;
+        if (percent != lastPercent && mHandler != nullptr)
+        {
+            lastPercent = percent;
+            auto event = new wxThreadEvent(EVT_SAVE_PROGRESS);
+            event->SetInt(percent);
+            wxQueueEvent(mHandler, event);
+        }
+    };
+
+    bool saved = WriteFile(filename, snapshot, format, progress);
+
+    // Let go of the snapshot memory before we report back
+    AquaSnapshot().records.swap(snapshot.records);
+    mBusy = false;
+
+    if (mHandler != nullptr)
+    {
+        auto event = new wxThreadEvent(EVT_SAVE_COMPLETE);
+        event->SetInt(saved ? 1 : 0);
+        event->SetString(filename);
+        wxQueueEvent(mHandler, event);
+    }
+}
+
+/**
+ * Write a snapshot to a file and make sure it is on disk.
+ *
+ * The data goes to a temporary file first, which is synced and
+ * then renamed over the destination. If it cannot be renamed into
+ * place, the temporary file is removed and the destination is left
+ * as it was.
+ *
+ * @param filename File to save to
+ * @param snapshot The items to save
+ * @param format File format to use
+ * @param progress Optional, called as the records are written
+ * @return true if successful
+ */
+bool BackgroundSaver::WriteFile(const wxString& filename, const AquaSnapshot& snapshot, Format format,
+                                const SnapshotProgress& progress)
+{
+    AQUARIUM_TRACE_ZONE("BackgroundSaver::WriteFile");
+    AQUARIUM_ALLOCATION_SCOPE(AllocationSubsystem::File);
+    auto write = [&](wxFFile& file) {
+        wxFFileOutputStream stream(file);
+        if (format == Format::Binary)
+        {
+            return AquaBinary::Write(stream, snapshot, progress);
+        }
+
+        auto writer = make_unique<AquaXmlWriter>();
+        return AquaXmlWriter::IsCompressedName(filename) ? writer->WriteCompressed(stream, snapshot, progress)
+                                                         : writer->Write(stream, snapshot, progress);
+    };
+
+    if (!WriteTempFile(filename, write))
+    {
+        return false;
+    }
+
+    auto temp = filename + TempSaveSuffix;
+    if (!wxRenameFile(temp, filename, true))
+    {
+        wxRemoveFile(temp);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Write the new copy of a file under its temporary name and make
+ * sure it is on disk. The caller renames it into place when ready.
+ * @param filename File the new copy will replace
+ * @param write Writes the contents to the open temporary file
+ * @return true if successful. If not, the temporary file is removed.
+ */
+bool BackgroundSaver::WriteTempFile(const wxString& filename, const std::function<bool(wxFFile& file)>& write)
+{
+    auto temp = filename + TempSaveSuffix;
+
+    bool ok;
+    {
+        wxFFile file(temp, L"wb");
+        if (!file.IsOpened())
+        {
+            return false;
+        }
+
+        ok = write(file);
+        ok = ok && file.Flush() && SyncToDisk(file.fp());
+        ok = file.Close() && ok;
+    }
+
+    if (!ok)
+    {
+        wxRemoveFile(temp);
+    }
+
+    return ok;
+}
+
+/**
+ * Make sure everything written to a file has reached the disk
+ * @param fp The file, already flushed
+ * @return true if successful
+ */
+bool BackgroundSaver::SyncToDisk(FILE* fp)
+{
+#ifdef _WIN32
+    return _commit(_fileno(fp)) == 0;
+#else
+    return fsync(fileno(fp)) == 0;
+#endif
+}
@@ -0,0 +1,91 @@
+/**
+ * @file BackgroundSaver.h
+ * @author Josh Thomas
+ * @brief Header file for the BackgroundSaver class.
+ */
+
+#ifndef BACKGROUNDSAVER_H
+#define BACKGROUNDSAVER_H
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "ItemRecord.h"
+
+class wxFFile;
+
+/// Suffix added to a file's name while a new copy of it is being written
+const wchar_t TempSaveSuffix[] = L".saving";
+
+/// Sent while a background save runs. GetInt() is the percent complete.
+wxDECLARE_EVENT(EVT_SAVE_PROGRESS, wxThreadEvent);
+
+/// Sent when a background save finishes. GetInt() is 1 on success,
+/// 0 on failure, and GetString() is the filename.
+wxDECLARE_EVENT(EVT_SAVE_COMPLETE, wxThreadEvent);
+
+/**
+ * @class BackgroundSaver
+ * @brief Saves an aquarium snapshot on a worker thread.
+ *
+ * The caller takes a snapshot with Aquarium::TakeSnapshot, which is a
+ * cheap copy of plain records, and hands it over. Serialization, the
+ * disk write and the fsync all happen on the worker, so the simulation
+ * keeps running. The file is written under a temporary name and renamed
+ * into place once it is safely on disk, so a crash part way through
+ * never leaves a truncated .aqua file behind.
+ *
+ * Progress and completion are posted as thread events to a handler.
+ */
+class BackgroundSaver
+{
+public:
+    /// File formats we can save
+    enum class Format { Xml, Binary };
+
+private:
+    /// The worker thread, joinable once a save has been started
+    std::thread mThread;
+
+    /// True while a save is running
+    std::atomic<bool> mBusy{false};
+
+    /// Handler that receives our events, may be nullptr
+    wxEvtHandler* mHandler = nullptr;
+
+    void Run(std::wstring filename, Format format, AquaSnapshot snapshot);
+
+public:
+    BackgroundSaver() = default;
+
+    /// Copy constructor (disabled)
+    BackgroundSaver(const BackgroundSaver&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const BackgroundSaver&) = delete;
+
+    ~BackgroundSaver();
+
+    /**
+     * Set the handler that receives progress and completion events
+     * @param handler Event handler, usually the view
+     */
+    void SetHandler(wxEvtHandler* handler) { mHandler = handler; }
+
+    /**
+     * Is a save running?
+     * @return true if a save is in flight
+     */
+    bool IsBusy() const { return mBusy; }
+
+    bool Start(const wxString& filename, Format format, AquaSnapshot&& snapshot);
+    void Wait();
+
+    static bool WriteFile(const wxString& filename, const AquaSnapshot& snapshot, Format format,
+                          const SnapshotProgress& progress = nullptr);
+    static bool WriteTempFile(const wxString& filename, const std::function<bool(wxFFile& file)>& write);
+    static bool SyncToDisk(FILE* fp);
+};
+
+#endif //BACKGROUNDSAVER_H
@@ -0,0 +1,40 @@
+/**
+ * @file DcRenderer.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "DcRenderer.h"
+#include "DrawList.h"
+#include "SpriteLibrary.h"
+
+/**
+ * Constructor
+ * @param dc Device context to draw on
+ * @param sprites Library the sprite ids refer to
+ */
+DcRenderer::DcRenderer(wxDC* dc, const SpriteLibrary* sprites) : mDC(dc), mSprites(sprites)
+{
+}
+
+/**
+ * Draw every command in the list
+ * @param list The list to draw, already batched
+ */
+void DcRenderer::Render(const DrawList& list)
+{
+    const auto& commands = list.GetCommands();
+    for (const auto& batch : list.GetBatches())
+    {
+        // Every command in a batch draws the same bitmap,
+        // so we only look it up once per batch
+        auto sprite = mSprites->Get(batch.sprite);
+        const wxBitmap& bitmap = batch.mirror ? sprite->mirror : sprite->bitmap;
+
+        auto end = batch.first + batch.count;
+        for (auto i = batch.first; i < end; i++)
+        {
+            mDC->DrawBitmap(bitmap, commands[i].x, commands[i].y, true);
+        }
+    }
+}
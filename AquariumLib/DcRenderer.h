@@ -0,0 +1,33 @@
+/**
+ * @file DcRenderer.h
+ * @author Josh Thomas
+ * @brief Header file for the DcRenderer class.
+ */
+
+#ifndef DCRENDERER_H
+#define DCRENDERER_H
+
+#include "DrawListRenderer.h"
+
+class SpriteLibrary;
+
+/**
+ * @class DcRenderer
+ * @brief Plays a DrawList back onto a wxDC, one bitmap per sprite.
+ */
+class DcRenderer : public DrawListRenderer
+{
+private:
+    /// Device context we draw on
+    wxDC* mDC;
+
+    /// Library the sprite ids refer to
+    const SpriteLibrary* mSprites;
+
+public:
+    DcRenderer(wxDC* dc, const SpriteLibrary* sprites);
+
+    void Render(const DrawList& list) override;
+};
+
+#endif //DCRENDERER_H
@@ -14,13 +14,9 @@ using namespace std;
 /// Fish filename
 const wstring DecorCastleImageName = L"images/castle.png";
 
-DecorCastle::DecorCastle(Aquarium* aquarium) : Item(aquarium, DecorCastleImageName)
-{
-}
+/// Castles are saved with the type "castle"
+AQUARIUM_REGISTER_SPECIES(DecorCastle, L"castle");
 
-void DecorCastle::XmlLoad(wxXmlNode* node)
+DecorCastle::DecorCastle(Aquarium* aquarium) : Item(aquarium, DecorCastleImageName)
 {
- // Call the base class to load common attributes (x, y)
- Item::XmlLoad(node);
- // If DecorCastle has specific attributes, load them here
 }
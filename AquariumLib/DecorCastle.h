@@ -31,16 +31,14 @@ public:
      * @param aquarium Pointer to the aquarium that contains the fish.
      */
     DecorCastle(Aquarium* aquarium);
+    /// This species' id in the SpeciesRegistry
+    static const SpeciesId Species;
+
     /**
-     *
-     * @return L"castle" which is the type assigned to castle
-     */
-    std::wstring GetType() const override { return L"castle"; }
-    /**
-     * 
-     * @param node
+     * Get the species of this item
+     * @return DecorCastle::Species
      */
-    virtual void XmlLoad(wxXmlNode* node) override;
+    SpeciesId GetSpecies() const override { return Species; }
 };
 
 
@@ -0,0 +1,174 @@
+/**
+ * @file DivergenceFinder.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "DivergenceFinder.h"
+#include "Aquarium.h"
+#include "StateHash.h"
+#include "SpeciesRegistry.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Format one side of a divergence
+ * @param name Name of the run
+ * @param index Index of the item, or NoItem
+ * @param species Species of the item
+ * @param record State of the item
+ * @return One line describing the item
+ */
+static wxString FormatItem(const wchar_t* name, size_t index, const std::wstring& species, const ItemRecord& record)
+{
+    if (index == NoItem)
+    {
+        return wxString::Format(L"  %s: every item matches\n", name);
+    }
+
+    return wxString::Format(L"  %s: item %llu %s at (%.4f, %.4f) speed (%.4f, %.4f) state (%.6f, %.6f)\n", name,
+                            (unsigned long long)index, species.c_str(), record.x, record.y, record.speedX,
+                            record.speedY, record.state[0], record.state[1]);
+}
+
+/**
+ * Format the divergence for people to read
+ * @return The first tick the runs differ and the items responsible
+ */
+wxString Divergence::Format() const
+{
+    if (!found)
+    {
+        return L"No divergence\n";
+    }
+
+    auto text = wxString::Format(L"Diverged at tick %d: %016llx (%llu items) vs %016llx (%llu items)\n", tick,
+                                 (unsigned long long)hash[0], (unsigned long long)count[0],
+                                 (unsigned long long)hash[1], (unsigned long long)count[1]);
+    text += FormatItem(L"a", index[0], species[0], record[0]);
+    text += FormatItem(L"b", index[1], species[1], record[1]);
+    return text;
+}
+
+/**
+ * Step two aquariums together until their states differ.
+ *
+ * Both should already be loaded and seeded. They are
+ * compared before the first step as well as after each.
+ *
+ * @param a The reference run
+ * @param b The run to check against it
+ * @param divergence Receives where they first differ
+ * @return true if they matched for every tick
+ */
+bool DivergenceFinder::Run(Aquarium* a, Aquarium* b, Divergence* divergence) const
+{
+    *divergence = Divergence();
+    a->SetStateHashing(true);
+    b->SetStateHashing(true);
+
+    auto hashA = a->GetStateHash();
+    auto hashB = b->GetStateHash();
+    for (int tick = 0; ; tick++)
+    {
+        if (hashA != hashB)
+        {
+            divergence->found = true;
+            divergence->tick = tick;
+            divergence->hash[0] = hashA;
+            divergence->hash[1] = hashB;
+            FindItems(a, b, divergence);
+            break;
+        }
+
+        if (tick == mTicks)
+        {
+            break;
+        }
+
+        a->Update(mStep);
+        b->Update(mStep);
+        hashA = a->GetTickHash();
+        hashB = b->GetTickHash();
+    }
+
+    a->SetStateHashing(false);
+    b->SetStateHashing(false);
+    return !divergence->found;
+}
+
+/**
+ * Find the first item of each aquarium that has no match in the other
+ * @param a The reference run
+ * @param b The run to check against it
+ * @param divergence Receives the items
+ */
+void DivergenceFinder::FindItems(Aquarium* a, Aquarium* b, Divergence* divergence)
+{
+    AquaSnapshot snapshots[2];
+    a->TakeSnapshot(&snapshots[0]);
+    b->TakeSnapshot(&snapshots[1]);
+
+    // Hash of every item of each run, by index
+    vector<uint64_t> hashes[2];
+    for (int run = 0; run < 2; run++)
+    {
+        const auto& snapshot = snapshots[run];
+        vector<uint64_t> tagHashes;
+        for (const auto& species : snapshot.species)
+        {
+            tagHashes.push_back(SpeciesRegistry::HashTag(species));
+        }
+
+        divergence->count[run] = snapshot.records.size();
+        for (const auto& record : snapshot.records)
+        {
+            hashes[run].push_back(StateHash::HashItem(tagHashes[record.species], record));
+        }
+    }
+
+    // Each item of b can match one item of a
+    unordered_map<uint64_t, int> unmatched;
+    for (auto hash : hashes[1])
+    {
+        unmatched[hash]++;
+    }
+
+    for (size_t i = 0; i < hashes[0].size(); i++)
+    {
+        auto found = unmatched.find(hashes[0][i]);
+        if (found != unmatched.end() && found->second > 0)
+        {
+            found->second--;
+        }
+        else if (divergence->index[0] == NoItem)
+        {
+            divergence->index[0] = i;
+        }
+    }
+
+    // What is left unmatched in b is the other side of the difference
+    for (size_t i = 0; i < hashes[1].size(); i++)
+    {
+        auto& left = unmatched[hashes[1][i]];
+        if (left > 0)
+        {
+            divergence->index[1] = i;
+            break;
+        }
+    }
+
+    for (int run = 0; run < 2; run++)
+    {
+        auto index = divergence->index[run];
+        if (index != NoItem)
+        {
+            const auto& snapshot = snapshots[run];
+            divergence->record[run] = snapshot.records[index];
+            divergence->species[run] = snapshot.species[snapshot.records[index].species];
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file DivergenceFinder.h
+ * @author Josh Thomas
+ * @brief Header file for the DivergenceFinder class.
+ */
+
+#ifndef DIVERGENCEFINDER_H
+#define DIVERGENCEFINDER_H
+
+#include <string>
+#include "ItemRecord.h"
+
+class Aquarium;
+
+/// Index of an item that is not there
+const size_t NoItem = (size_t)-1;
+
+/**
+ * @struct Divergence
+ * @brief Where two runs of the simulation first disagreed.
+ */
+struct Divergence
+{
+    /// True if the runs disagreed at all
+    bool found = false;
+
+    /// Number of steps run when they disagreed, 0 if they started different
+    int tick = 0;
+
+    /// State hash of each run at that tick
+    uint64_t hash[2] = {0, 0};
+
+    /// Number of items in each run at that tick
+    size_t count[2] = {0, 0};
+
+    /// Index in drawing order of the first item of each run with
+    /// no match in the other, NoItem if every item has a match
+    size_t index[2] = {NoItem, NoItem};
+
+    /// Species of those items
+    std::wstring species[2];
+
+    /// State of those items
+    ItemRecord record[2];
+
+    wxString Format() const;
+};
+
+/**
+ * @class DivergenceFinder
+ * @brief Runs two aquariums side by side and finds the first tick they differ.
+ *
+ * Used to prove an alternative way of running the simulation, such
+ * as a different file format, storage or threading, matches the
+ * reference. Both aquariums are stepped at the same fixed rate and
+ * their state hashes compared after every step, which costs little
+ * enough to run for thousands of ticks over large tanks.
+ *
+ * When the hashes differ, the items of both are hashed one by one
+ * and matched up, without regard to order, to find the offending
+ * item in each.
+ */
+class DivergenceFinder
+{
+private:
+    /// Simulation step in seconds
+    double mStep = 1.0 / 60;
+
+    /// Number of steps to run
+    int mTicks = 600;
+
+    static void FindItems(Aquarium* a, Aquarium* b, Divergence* divergence);
+
+public:
+    bool Run(Aquarium* a, Aquarium* b, Divergence* divergence) const;
+
+    /**
+     * Set the simulation step
+     * @param step Step in seconds
+     */
+    void SetStep(double step) { mStep = step; }
+
+    /**
+     * Set how many steps to run
+     * @param ticks Step count
+     */
+    void SetTicks(int ticks) { mTicks = ticks; }
+};
+
+#endif //DIVERGENCEFINDER_H
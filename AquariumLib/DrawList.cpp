@@ -0,0 +1,151 @@
+/**
+ * @file DrawList.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "DrawList.h"
+#include "SpriteLibrary.h"
+#include <algorithm>
+
+using namespace std;
+
+/// How many batches back we will look for one to join.
+/// Keeps Batch() linear in the number of commands.
+const int MaxLookback = 8;
+
+/**
+ * Bounding rectangle of a batch, in pixels
+ */
+struct BatchBounds
+{
+    /// Left edge
+    int left;
+    /// Top edge
+    int top;
+    /// Right edge, exclusive
+    int right;
+    /// Bottom edge, exclusive
+    int bottom;
+
+    /**
+     * Do two rectangles overlap?
+     * @param other Rectangle to test
+     * @return true if they overlap
+     */
+    bool Intersects(const BatchBounds& other) const
+    {
+        return left < other.right && other.left < right && top < other.bottom && other.top < bottom;
+    }
+
+    /**
+     * Grow to include another rectangle
+     * @param other Rectangle to include
+     */
+    void Include(const BatchBounds& other)
+    {
+        left = min(left, other.left);
+        top = min(top, other.top);
+        right = max(right, other.right);
+        bottom = max(bottom, other.bottom);
+    }
+};
+
+/**
+ * Remove all commands, keeping the storage for the next frame
+ */
+void DrawList::Clear()
+{
+    mCommands.clear();
+    mBatches.clear();
+}
+
+/**
+ * Add a command to the end of the list
+ * @param sprite Sprite id to draw
+ * @param mirror True to draw the mirrored sprite
+ * @param x Left edge in pixels
+ * @param y Top edge in pixels
+ */
+void DrawList::Add(int sprite, bool mirror, int x, int y)
+{
+    mCommands.push_back({x, y, (unsigned)mCommands.size(), (unsigned short)sprite, mirror});
+}
+
+/**
+ * Group the commands into batches of the same sprite.
+ *
+ * Each command joins the most recent batch of the same sprite if
+ * it does not overlap any batch drawn after that one. Otherwise it
+ * starts a new batch. Commands are then reordered into batch order.
+ *
+ * @param sprites Library the sprite ids refer to, for sprite sizes
+ */
+void DrawList::Batch(const SpriteLibrary& sprites)
+{
+    mBatches.clear();
+    mBatchOf.resize(mCommands.size());
+
+    // There is at most a batch per command. Reserving that many means the
+    // number of batches changing as items move never reallocates.
+    mBatches.reserve(mCommands.size());
+
+    // Bounds are only needed for the last few batches we might look at
+    BatchBounds bounds[MaxLookback];
+
+    for (size_t i = 0; i < mCommands.size(); i++)
+    {
+        const auto& command = mCommands[i];
+        auto sprite = sprites.Get(command.sprite);
+        BatchBounds rect = {command.x, command.y, command.x + sprite->width, command.y + sprite->height};
+
+        int target = -1;
+        int oldest = max((int)mBatches.size() - MaxLookback, 0);
+        for (int b = (int)mBatches.size() - 1; b >= oldest; b--)
+        {
+            if (mBatches[b].sprite == command.sprite && mBatches[b].mirror == command.mirror)
+            {
+                target = b;
+                break;
+            }
+
+            if (rect.Intersects(bounds[b % MaxLookback]))
+            {
+                break;
+            }
+        }
+
+        if (target < 0)
+        {
+            target = (int)mBatches.size();
+            mBatches.push_back({command.sprite, command.mirror, 0, 0});
+            bounds[target % MaxLookback] = rect;
+        }
+        else
+        {
+            bounds[target % MaxLookback].Include(rect);
+        }
+
+        mBatches[target].count++;
+        mBatchOf[i] = target;
+    }
+
+    // Work out where each batch starts
+    unsigned first = 0;
+    for (auto& batch : mBatches)
+    {
+        batch.first = first;
+        first += batch.count;
+        batch.count = 0;
+    }
+
+    // Scatter the commands into batch order, keeping their relative order
+    mSorted.resize(mCommands.size());
+    for (size_t i = 0; i < mCommands.size(); i++)
+    {
+        auto& batch = mBatches[mBatchOf[i]];
+        mSorted[batch.first + batch.count++] = mCommands[i];
+    }
+
+    mCommands.swap(mSorted);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file DrawList.h
+ * @author Josh Thomas
+ * @brief Header file for the DrawList class.
+ *
+ * A retained list of the sprites drawn in one frame.
+ */
+
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <vector>
+
+class SpriteLibrary;
+
+/**
+ * @struct DrawCommand
+ * @brief Draw one sprite at one location.
+ */
+struct DrawCommand
+{
+    /// Left edge in pixels
+    int x;
+
+    /// Top edge in pixels
+    int y;
+
+    /// Position in the original drawing order, 0 is drawn first
+    unsigned z;
+
+    /// Sprite id in the aquarium's SpriteLibrary
+    unsigned short sprite;
+
+    /// True to draw the mirrored sprite
+    bool mirror;
+
+    /// Commands are equal if they draw the same thing in the same place
+    bool operator==(const DrawCommand&) const = default;
+};
+
+/**
+ * @struct DrawBatch
+ * @brief A run of commands that all draw the same sprite.
+ */
+struct DrawBatch
+{
+    /// Sprite id every command in the batch draws
+    unsigned short sprite;
+
+    /// True if every command in the batch is mirrored
+    bool mirror;
+
+    /// Index of the first command in the batch
+    unsigned first;
+
+    /// Number of commands in the batch
+    unsigned count;
+};
+
+/**
+ * @class DrawList
+ * @brief Compact record of everything drawn in a frame.
+ *
+ * Aquarium records a frame into a draw list instead of drawing items
+ * directly. A renderer then plays the list back, so the backend can
+ * change without touching Item. Lists can be kept and compared, so a
+ * frame that is identical to the last one need not be drawn again.
+ *
+ * Batch() groups commands that draw the same sprite. A command is only
+ * moved earlier in the list if it does not overlap anything it would
+ * move under, so the final image is unchanged.
+ */
+class DrawList
+{
+private:
+    /// The commands, in batch order after Batch() is called
+    std::vector<DrawCommand> mCommands;
+
+    /// The batches, empty until Batch() is called
+    std::vector<DrawBatch> mBatches;
+
+    /// Scratch space used by Batch(), kept to avoid reallocating each frame
+    std::vector<unsigned> mBatchOf;
+
+    /// Scratch copy of the commands used by Batch()
+    std::vector<DrawCommand> mSorted;
+
+public:
+    void Clear();
+    void Add(int sprite, bool mirror, int x, int y);
+    void Batch(const SpriteLibrary& sprites);
+
+    /**
+     * Get the commands
+     * @return Commands in drawing order
+     */
+    const std::vector<DrawCommand>& GetCommands() const { return mCommands; }
+
+    /**
+     * Get the batches
+     * @return Batches in drawing order
+     */
+    const std::vector<DrawBatch>& GetBatches() const { return mBatches; }
+
+    /**
+     * Get the number of commands
+     * @return Command count
+     */
+    size_t GetCount() const { return mCommands.size(); }
+
+    /**
+     * Get the memory the list holds, including the scratch
+     * space kept from frame to frame
+     * @return Bytes allocated
+     */
+    size_t GetMemorySize() const
+    {
+        return (mCommands.capacity() + mSorted.capacity()) * sizeof(DrawCommand) +
+               mBatches.capacity() * sizeof(DrawBatch) + mBatchOf.capacity() * sizeof(unsigned);
+    }
+
+    /**
+     * Does this list draw exactly the same frame as another?
+     * @param other List to compare to
+     * @return true if the lists are identical
+     */
+    bool operator==(const DrawList& other) const { return mCommands == other.mCommands; }
+};
+
+#endif //DRAWLIST_H
@@ -0,0 +1,34 @@
+/**
+ * @file DrawListRenderer.h
+ * @author Josh Thomas
+ * @brief Header file for the DrawListRenderer class.
+ */
+
+#ifndef DRAWLISTRENDERER_H
+#define DRAWLISTRENDERER_H
+
+class DrawList;
+
+/**
+ * @class DrawListRenderer
+ * @brief Base class for anything that can play back a DrawList.
+ *
+ * Derived classes decide how sprites actually reach the screen,
+ * so the drawing backend can change without touching Item or Aquarium.
+ */
+class DrawListRenderer
+{
+public:
+    /**
+     * Play back a draw list
+     * @param list The list to draw, already batched
+     */
+    virtual void Render(const DrawList& list) = 0;
+
+    /**
+     * Virtual destructor
+     */
+    virtual ~DrawListRenderer() = default;
+};
+
+#endif //DRAWLISTRENDERER_H
@@ -0,0 +1,347 @@
+/**
+ * @file EditJournal.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "EditJournal.h"
+#include "AquaBinary.h"
+#include "BackgroundSaver.h"
+#include <wx/filefn.h>
+#include <wx/wfstream.h>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * 32 bit FNV-1a hash of a block of data
+ * @param data Start of the data
+ * @param size Size of the data in bytes
+ * @return The hash
+ */
+static uint32_t Checksum(const char* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Destructor. Finishes any checkpoint in flight, so it is never lost.
+ */
+EditJournal::~EditJournal()
+{
+    Close();
+}
+
+/**
+ * Start a journal, with a snapshot of the aquarium as it is now.
+ *
+ * Any existing file of that name is replaced. Unlike later
+ * checkpoints, this one is waited for, since there is no
+ * old journal to record edits in meanwhile.
+ *
+ * @param filename Journal file name
+ * @param snapshot The current state of the aquarium, taken over by the journal
+ * @return true if the journal is ready to record edits
+ */
+bool EditJournal::Open(const wxString& filename, AquaSnapshot&& snapshot)
+{
+    Close();
+    mFilename = filename;
+    return Checkpoint(std::move(snapshot)) && FinishCheckpoint();
+}
+
+/**
+ * Stop recording edits. A checkpoint in flight is
+ * finished first. The file is left in place.
+ */
+void EditJournal::Close()
+{
+    FinishCheckpoint();
+    mPending.clear();
+    if (mFile.IsOpened())
+    {
+        mFile.Close();
+    }
+}
+
+/**
+ * Start replacing the journal with a new checkpoint and no entries.
+ *
+ * The snapshot is written on a worker thread. Edits keep going to
+ * the current journal until the next Append or Poll after the worker
+ * is done, which switches over to the new one. If a checkpoint is
+ * already in flight, it is finished first.
+ *
+ * @param snapshot The current state of the aquarium, taken over by the journal
+ * @return true if the checkpoint was started
+ */
+bool EditJournal::Checkpoint(AquaSnapshot&& snapshot)
+{
+    if (mFilename.empty())
+    {
+        return false;
+    }
+
+    FinishCheckpoint();
+
+    mBacklog.clear();
+    mCheckpointDone = false;
+    mCheckpointing = true;
+    mThread = thread(&EditJournal::WriteCheckpoint, this, std::move(snapshot));
+    return true;
+}
+
+/**
+ * Switch to the new checkpoint if the worker has finished it.
+ * Cheap enough to call every frame.
+ */
+void EditJournal::Poll()
+{
+    if (mCheckpointing && mCheckpointDone)
+    {
+        FinishCheckpoint();
+    }
+}
+
+/**
+ * The worker thread. Writes the checkpoint under the temporary
+ * name and syncs it, ready for FinishCheckpoint to rename.
+ * @param snapshot The state of the aquarium to write
+ */
+void EditJournal::WriteCheckpoint(AquaSnapshot snapshot)
+{
+    EditJournalHeader header;
+    memcpy(header.magic, EditJournalMagic, sizeof(header.magic));
+    header.version = EditJournalVersion;
+    header.entrySize = sizeof(JournalEntry);
+    header.snapshotBytes = 0;
+
+    auto write = [&header, &snapshot](wxFFile& file) {
+        if (file.Write(&header, sizeof(header)) != sizeof(header))
+        {
+            return false;
+        }
+
+        {
+            wxFFileOutputStream stream(file);
+            if (!AquaBinary::Write(stream, snapshot))
+            {
+                return false;
+            }
+        }
+
+        // Now we know how big the snapshot is, fill in the header
+        header.snapshotBytes = (uint64_t)file.Tell() - sizeof(header);
+        return file.Seek(0) && file.Write(&header, sizeof(header)) == sizeof(header);
+    };
+
+    mCheckpointWritten = BackgroundSaver::WriteTempFile(mFilename, write);
+    mCheckpointBytes = (size_t)header.snapshotBytes;
+    mCheckpointDone = true;
+}
+
+/**
+ * Wait for the checkpoint in flight, if any, and switch to it.
+ *
+ * The edits made while it was written are appended to the new
+ * file, which is then renamed over the journal, so the journal on
+ * disk is always either the old one or the new one. If anything
+ * fails, the old journal, which has every edit, stays in use.
+ *
+ * @return true if the journal switched to a new checkpoint
+ */
+bool EditJournal::FinishCheckpoint()
+{
+    if (!mCheckpointing)
+    {
+        return false;
+    }
+
+    mThread.join();
+    mCheckpointing = false;
+
+    auto temp = mFilename + TempSaveSuffix;
+    bool ok = mCheckpointWritten;
+    if (ok && !mBacklog.empty())
+    {
+        wxFFile file(temp, L"ab");
+        ok = file.IsOpened() && file.Write(mBacklog.data(), mBacklog.size()) == mBacklog.size() && file.Flush();
+        ok = file.Close() && ok;
+    }
+
+    // A file that is open cannot be renamed over on Windows
+    bool recording = mFile.IsOpened();
+    if (recording)
+    {
+        mFile.Close();
+    }
+
+    if (!ok || !wxRenameFile(temp, mFilename, true))
+    {
+        wxRemoveFile(temp);
+        mBacklog.clear();
+        if (recording)
+        {
+            mFile.Open(mFilename, L"ab");
+        }
+        return false;
+    }
+
+    mSnapshotBytes = mCheckpointBytes;
+    mEntryBytes = mBacklog.size();
+    mBacklog.clear();
+    return mFile.Open(mFilename, L"ab");
+}
+
+/**
+ * Append an edit to the journal
+ * @param op What the edit does
+ * @param index Index of the item in drawing order
+ * @param record New item state, for Add and Update
+ * @param species Type name of the new item, for Add
+ * @return true if the edit was written
+ */
+bool EditJournal::Append(JournalOp op, size_t index, const ItemRecord& record, const std::wstring& species)
+{
+    Queue(op, index, record, species);
+    return Commit();
+}
+
+/**
+ * Add an edit to the batch that the next Commit writes
+ * @param op What the edit does
+ * @param index Index of the item in drawing order
+ * @param record New item state, for Add and Update
+ * @param species Type name of the new item, for Add
+ */
+void EditJournal::Queue(JournalOp op, size_t index, const ItemRecord& record, const std::wstring& species)
+{
+    if (!mFile.IsOpened())
+    {
+        return;
+    }
+
+    auto name = wxString(species).ToUTF8();
+
+    JournalEntry entry = {};
+    entry.op = (uint16_t)op;
+    entry.nameBytes = (uint16_t)name.length();
+    entry.index = (uint32_t)index;
+    entry.record = record;
+
+    // Entry, name and padding, with the checksum filled in last
+    auto start = mPending.size();
+    mPending.append((const char*)&entry, sizeof(entry));
+    mPending.append(name.data(), name.length());
+    mPending.resize((mPending.size() + 7) / 8 * 8, '\0');
+
+    auto data = mPending.data() + start;
+    entry.checksum = Checksum(data + sizeof(entry.checksum), mPending.size() - start - sizeof(entry.checksum));
+    memcpy(data, &entry.checksum, sizeof(entry.checksum));
+}
+
+/**
+ * Write the edits queued since the last Commit, in one write
+ * and one flush however many there are
+ * @return true if the edits were written
+ */
+bool EditJournal::Commit()
+{
+    Poll();
+    if (!mFile.IsOpened() || mPending.empty())
+    {
+        mPending.clear();
+        return mFile.IsOpened();
+    }
+
+    bool written = mFile.Write(mPending.data(), mPending.size()) == mPending.size() && mFile.Flush();
+    if (written)
+    {
+        // The checkpoint being written does not have these edits
+        if (mCheckpointing)
+        {
+            mBacklog += mPending;
+        }
+
+        mEntryBytes += mPending.size();
+    }
+
+    mPending.clear();
+    return written;
+}
+
+/**
+ * Does a block of data start with the journal magic bytes?
+ * @param data Start of the data
+ * @param size Size of the data in bytes
+ * @return true if this is a journal file
+ */
+bool EditJournal::IsJournal(const char* data, size_t size)
+{
+    return size >= sizeof(EditJournalMagic) && memcmp(data, EditJournalMagic, sizeof(EditJournalMagic)) == 0;
+}
+
+/**
+ * Read a journal file.
+ *
+ * Reading stops quietly at the first entry that is incomplete or
+ * fails its checksum, since that is what a crash mid-write leaves.
+ *
+ * @param data Start of the file data, 8 byte aligned
+ * @param size Size of the data in bytes
+ * @param snapshot Receives a pointer to the binary .aqua checkpoint
+ * @param snapshotSize Receives the size of the checkpoint in bytes
+ * @param edits Receives the edits made since the checkpoint, in order
+ * @return false if the file is not a valid journal
+ */
+bool EditJournal::Read(const char* data, size_t size, const char** snapshot, size_t* snapshotSize,
+                       std::vector<JournalEdit>* edits)
+{
+    if (!IsJournal(data, size) || size < sizeof(EditJournalHeader))
+    {
+        return false;
+    }
+
+    EditJournalHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.version != EditJournalVersion || header.entrySize != sizeof(JournalEntry) ||
+        header.snapshotBytes > size - sizeof(header))
+    {
+        return false;
+    }
+
+    *snapshot = data + sizeof(header);
+    *snapshotSize = (size_t)header.snapshotBytes;
+
+    edits->clear();
+    auto pos = sizeof(header) + *snapshotSize;
+    while (size - pos >= sizeof(JournalEntry))
+    {
+        JournalEntry entry;
+        memcpy(&entry, data + pos, sizeof(entry));
+
+        auto length = (sizeof(entry) + entry.nameBytes + 7) / 8 * 8;
+        if (length > size - pos ||
+            Checksum(data + pos + sizeof(entry.checksum), length - sizeof(entry.checksum)) != entry.checksum)
+        {
+            break;
+        }
+
+        JournalEdit edit;
+        edit.op = (JournalOp)entry.op;
+        edit.index = entry.index;
+        edit.record = entry.record;
+        edit.species = wxString::FromUTF8(data + pos + sizeof(entry), entry.nameBytes).ToStdWstring();
+        edits->push_back(std::move(edit));
+
+        pos += length;
+    }
+
+    return true;
+}
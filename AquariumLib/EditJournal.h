@@ -0,0 +1,221 @@
+/**
+ * @file EditJournal.h
+ * @author Josh Thomas
+ * @brief Header file for the EditJournal class.
+ *
+ * Layout of a journal file, all little-endian:
+ *  - EditJournalHeader
+ *  - snapshotBytes of binary .aqua data, the last checkpoint
+ *  - JournalEntry structures, each followed by nameBytes of UTF-8
+ *    species name zero padded to a multiple of 8
+ */
+
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include <wx/ffile.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ItemRecord.h"
+
+/// Magic bytes at the start of every journal file
+const char EditJournalMagic[8] = {'A', 'Q', 'U', 'A', 'J', 'R', 'N', 'L'};
+
+/// Current version of the journal format
+const uint32_t EditJournalVersion = 1;
+
+/**
+ * @struct EditJournalHeader
+ * @brief The header at the start of a journal file.
+ */
+struct EditJournalHeader
+{
+    /// Always EditJournalMagic
+    char magic[8];
+
+    /// Format version, EditJournalVersion when written
+    uint32_t version;
+
+    /// sizeof(JournalEntry) when written
+    uint32_t entrySize;
+
+    /// Size of the checkpoint snapshot that follows in bytes
+    uint64_t snapshotBytes;
+};
+
+static_assert(sizeof(EditJournalHeader) == 24, "EditJournalHeader is an on-disk format");
+
+/**
+ * The kinds of edit a journal records
+ */
+enum class JournalOp : uint16_t
+{
+    Add = 1,    ///< Add an item with the given record and species
+    Clear,      ///< Remove every item
+    Update,     ///< Replace the state of the item at index with the record
+    MoveToEnd   ///< Move the item at index to the end of the drawing order
+};
+
+/**
+ * @struct JournalEntry
+ * @brief One edit, as written to the journal file.
+ */
+struct JournalEntry
+{
+    /// Checksum of the rest of the entry and its name, so a torn write is detected
+    uint32_t checksum;
+
+    /// A JournalOp
+    uint16_t op;
+
+    /// Length of the species name that follows, Add only
+    uint16_t nameBytes;
+
+    /// Index of the item in drawing order
+    uint32_t index;
+
+    /// Padding, always zero
+    uint32_t reserved;
+
+    /// New item state, Add and Update only. The species field is unused.
+    ItemRecord record;
+};
+
+static_assert(sizeof(JournalEntry) == 72, "JournalEntry is an on-disk format");
+
+/**
+ * @struct JournalEdit
+ * @brief One edit read back from a journal.
+ */
+struct JournalEdit
+{
+    /// What the edit does
+    JournalOp op;
+
+    /// Index of the item in drawing order
+    uint32_t index;
+
+    /// New item state, Add and Update only
+    ItemRecord record;
+
+    /// Type name of the new item, Add only
+    std::wstring species;
+};
+
+/**
+ * @class EditJournal
+ * @brief Append-only log of the edits made to an aquarium.
+ *
+ * The journal file starts with a full snapshot, the checkpoint, and
+ * each edit after that is appended as a small fixed size entry, so
+ * the cost of keeping the file current depends on how often the user
+ * edits the aquarium, not how big it is. Entries are flushed as they
+ * are written, so a crash loses nothing the operating system has seen.
+ * An edit to many items at once is queued an entry at a time and
+ * committed in one write and one flush.
+ *
+ * Once the entries outgrow the checkpoint, the owner writes a new
+ * checkpoint, which replaces the whole file atomically. The snapshot
+ * is written and synced on a worker thread, the way BackgroundSaver
+ * saves, while edits keep going to the old file. When the worker is
+ * done, the edits made meanwhile are copied after the new checkpoint
+ * and the journal switches over to it.
+ *
+ * Loading replays the entries on top of the checkpoint. A torn entry
+ * at the end of the file, from a crash part way through a write, fails
+ * its checksum and is ignored along with anything after it.
+ */
+class EditJournal
+{
+private:
+    /// Smallest journal we bother replacing with a checkpoint, in bytes
+    static constexpr size_t MinCheckpointBytes = 64 * 1024;
+
+    /// The journal file name
+    wxString mFilename;
+
+    /// The journal file, open for appending
+    wxFFile mFile;
+
+    /// Size of the last checkpoint snapshot in bytes
+    size_t mSnapshotBytes = 0;
+
+    /// Bytes of entries appended since the last checkpoint
+    size_t mEntryBytes = 0;
+
+    /// Writes a new checkpoint, joinable once one has been started
+    std::thread mThread;
+
+    /// True from starting a checkpoint until we switch over to it
+    bool mCheckpointing = false;
+
+    /// Set by the worker once it has finished with its checkpoint
+    std::atomic<bool> mCheckpointDone{false};
+
+    /// Did the worker's checkpoint reach the disk?
+    bool mCheckpointWritten = false;
+
+    /// Size of the snapshot the worker wrote in bytes
+    size_t mCheckpointBytes = 0;
+
+    /// Entries appended since the worker's snapshot was taken,
+    /// copied after it when we switch to the new checkpoint
+    std::string mBacklog;
+
+    /// Entries queued since the last Commit
+    std::string mPending;
+
+    void WriteCheckpoint(AquaSnapshot snapshot);
+    bool FinishCheckpoint();
+
+public:
+    EditJournal() = default;
+
+    /// Copy constructor (disabled)
+    EditJournal(const EditJournal&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const EditJournal&) = delete;
+
+    ~EditJournal();
+
+    bool Open(const wxString& filename, AquaSnapshot&& snapshot);
+    void Close();
+    bool Checkpoint(AquaSnapshot&& snapshot);
+    void Poll();
+    bool Append(JournalOp op, size_t index, const ItemRecord& record = ItemRecord(),
+                const std::wstring& species = std::wstring());
+    void Queue(JournalOp op, size_t index, const ItemRecord& record = ItemRecord(),
+               const std::wstring& species = std::wstring());
+    bool Commit();
+
+    /**
+     * Is the journal recording edits?
+     * @return true if open
+     */
+    bool IsOpen() const { return mFile.IsOpened(); }
+
+    /**
+     * Have enough edits built up that a new checkpoint is worth writing?
+     * @return true if the owner should call Checkpoint
+     */
+    bool NeedsCheckpoint() const
+    {
+        return !mCheckpointing && mEntryBytes > std::max(mSnapshotBytes, MinCheckpointBytes);
+    }
+
+    /**
+     * Get the journal file name
+     * @return File name, empty if never opened
+     */
+    const wxString& GetFilename() const { return mFilename; }
+
+    static bool IsJournal(const char* data, size_t size);
+    static bool Read(const char* data, size_t size, const char** snapshot, size_t* snapshotSize,
+                     std::vector<JournalEdit>* edits);
+};
+
+#endif //EDITJOURNAL_H
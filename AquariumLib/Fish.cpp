@@ -5,7 +5,6 @@
 #include "pch.h"
 #include "Fish.h"
 #include "Aquarium.h"
-#include <random>
 #include <iomanip>
 /**
  * Constructor
@@ -22,16 +21,14 @@ const double MinSpeedX = 20;
 Fish::Fish(Aquarium *aquarium, const std::wstring &filename) :
     Item(aquarium, filename)
 {
-    std::uniform_real_distribution<> distribution(MinSpeedX, MaxSpeedX);
-    mSpeedX = distribution(aquarium->GetRandom());
+    mSpeedX = aquarium->Random(MinSpeedX, MaxSpeedX);
     mSpeedY = 0;
 }
 
 void Fish::SetRandomSpeed(double minSpeed, double maxSpeed)
 {
-    std::uniform_real_distribution<> distribution(minSpeed, maxSpeed);
-    mSpeedX = distribution(GetAquarium()->GetRandom());
-    mSpeedY = distribution(GetAquarium()->GetRandom());
+    mSpeedX = GetAquarium()->Random(minSpeed, maxSpeed);
+    mSpeedY = GetAquarium()->Random(minSpeed, maxSpeed);
 }
 
 void Fish::Update(double elapsed)
@@ -64,27 +61,25 @@ void Fish::Update(double elapsed)
     SetMirror(mSpeedX < 0);
 }
 
-wxXmlNode* Fish::XmlSave(wxXmlNode* node)
+/**
+ * Copy the position and speed of this fish into a record
+ * @param record Record to save into
+ */
+void Fish::SaveRecord(ItemRecord* record) const
 {
-    // Call base class XmlSave to save common attributes like type, x, y
-    auto itemNode = Item::XmlSave(node);
-
-    // Save the speed attributes
-    itemNode->AddAttribute(L"speedx", wxString::Format(L"%.6f", mSpeedX)); // consistent precision
-    itemNode->AddAttribute(L"speedy", wxString::Format(L"%.6f", mSpeedY));
-
-    return itemNode;
+    Item::SaveRecord(record);
+    record->speedX = mSpeedX;
+    record->speedY = mSpeedY;
+    record->flags |= ItemRecord::Swims;
 }
 
-void Fish::XmlLoad(wxXmlNode* node)
+/**
+ * Restore the position and speed of this fish from a record
+ * @param record Record to load from
+ */
+void Fish::LoadRecord(const ItemRecord& record)
 {
-    // Load common attributes from Item
-    Item::XmlLoad(node);
-    double speedX, speedY;
-    node->GetAttribute(L"speedx", L"0").ToDouble(&speedX);
-    node->GetAttribute(L"speedy",L"0").ToDouble(&speedY);
-    SetSpeedX(speedX);
-    SetSpeedY(speedY);
-
-
+    Item::LoadRecord(record);
+    mSpeedX = record.speedX;
+    mSpeedY = record.speedY;
 }
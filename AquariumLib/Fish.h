@@ -77,17 +77,15 @@ public:
      * @param elapsed
      */
     void Update(double elapsed) override;
+
     /**
-     * saves xml
-     * @param node
-     * @return
-     */
-    wxXmlNode* XmlSave(wxXmlNode* node) override;
-    /**
-     * Loads xml
-     * @param node
+     * Fish always swim
+     * @return true
      */
-    void XmlLoad(wxXmlNode* node) override;
+    bool IsAnimated() const override { return true; }
+
+    void SaveRecord(ItemRecord* record) const override;
+    void LoadRecord(const ItemRecord& record) override;
 };
 
 
@@ -9,12 +9,16 @@
 
 #include "FishBeta.h"
 #include "Aquarium.h"
+#include "Tracer.h"
 
 /**
  * Path to the image file used for FishBeta.
  */
 const std::wstring FishBetaImageName = L"images/beta.png";
 
+/// Beta fish are saved with the type "beta"
+AQUARIUM_REGISTER_SPECIES(FishBeta, L"beta");
+
 /**
  * Constructs a FishBeta instance with initial settings.
  * @param aquarium The aquarium this FishBeta belongs to.
@@ -28,7 +32,8 @@ FishBeta::FishBeta(Aquarium* aquarium) : Fish(aquarium, FishBetaImageName) {
  * @param elapsed The time elapsed since the last update call.
  */
 void FishBeta::Update(double elapsed) {
- if (rand() % 100 < 5) {
+ AQUARIUM_TRACE_ZONE("FishBeta::Update");
+ if (GetAquarium()->GetRandom()() % 100 < 5) {
   SetSpeedX(-GetSpeedX());  // Occasionally reverse horizontal direction.
  }
 
@@ -51,10 +56,3 @@ void FishBeta::Update(double elapsed) {
  Fish::Update(elapsed);
 }
 
-/**
- * Load FishBeta properties from an XML node.
- * @param node XML node containing fish attributes.
- */
-void FishBeta::XmlLoad(wxXmlNode* node) {
-    Fish::XmlLoad(node);  // Load common fish properties.
-}
@@ -19,14 +19,14 @@ public:
     /// Constructor
     FishBeta(Aquarium* aquarium);
 
+    /// This species' id in the SpeciesRegistry
+    static const SpeciesId Species;
+
     /**
-     * returns type of fish
-     * @return wstring
+     * Get the species of this item
+     * @return FishBeta::Species
      */
-    std::wstring GetType() const override { return L"beta"; }
-
-    /// Load Beta fish from XML
-    void XmlLoad(wxXmlNode* node) override;
+    SpeciesId GetSpecies() const override { return Species; }
 
     /// Update the fish state (movement, direction changes, etc.)
     void Update(double elapsed) override;
@@ -5,6 +5,7 @@
 
 #include "FishCarp.h"
 #include "Aquarium.h"
+#include "Tracer.h"
 #include <cmath> // For sin()
 /**
  * @var FishCarpImageName
@@ -12,6 +13,9 @@
  */
 const std::wstring FishCarpImageName = L"images/carp.png";
 
+/// Carp are saved with the type "carp"
+AQUARIUM_REGISTER_SPECIES(FishCarp, L"carp");
+
 /**
  * FishCarp constructor
  * @param aquarium
@@ -28,6 +32,7 @@ FishCarp::FishCarp(Aquarium* aquarium) : Fish(aquarium, FishCarpImageName)
  */
 void FishCarp::Update(double elapsed)
 {
+    AQUARIUM_TRACE_ZONE("FishCarp::Update");
     // Increment time for zig-zag movement
     mZigZagTime += elapsed;
 
@@ -61,11 +66,21 @@ void FishCarp::Update(double elapsed)
 }
 
 /**
- * loads xml from fish class
- * @param node
+ * Save the carp including where it is in its zig-zag
+ * @param record Record to save into
+ */
+void FishCarp::SaveRecord(ItemRecord* record) const
+{
+    Fish::SaveRecord(record);
+    record->state[0] = mZigZagTime;
+}
+
+/**
+ * Load the carp including where it is in its zig-zag
+ * @param record Record to load from
  */
-void FishCarp::XmlLoad(wxXmlNode* node)
+void FishCarp::LoadRecord(const ItemRecord& record)
 {
-    // Call the base class to load common attributes like position, speed, etc.
-    Fish::XmlLoad(node);
+    Fish::LoadRecord(record);
+    mZigZagTime = record.state[0];
 }
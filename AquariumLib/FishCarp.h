@@ -20,18 +20,21 @@ public:
     /// Constructor
     FishCarp(Aquarium* aquarium);
 
+    /// This species' id in the SpeciesRegistry
+    static const SpeciesId Species;
+
     /**
-     * type getter for fish
-     * @return wstring with type
+     * Get the species of this item
+     * @return FishCarp::Species
      */
-    std::wstring GetType() const override { return L"carp"; }
-
-    /// Load Carp fish from XML
-    void XmlLoad(wxXmlNode* node) override;
+    SpeciesId GetSpecies() const override { return Species; }
 
     /// Update the fish state (movement, direction changes, etc.)
     void Update(double elapsed) override;
 
+    void SaveRecord(ItemRecord* record) const override;
+    void LoadRecord(const ItemRecord& record) override;
+
 private:
     /**
      * double for zigzag time
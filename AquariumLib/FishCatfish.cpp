@@ -6,7 +6,7 @@
 
 #include "FishCatfish.h"
 #include "Aquarium.h"
-#include <cstdlib> // for rand()
+#include "Tracer.h"
 #include <cmath>   // for fabs()
 
 /**
@@ -15,6 +15,9 @@
  */
 const std::wstring FishCatfishImageName = L"images/catfish.png";
 
+/// Catfish are saved with the type "catfish"
+AQUARIUM_REGISTER_SPECIES(FishCatfish, L"catfish");
+
 /**
  * fishcatfish constructor
  * @param aquarium
@@ -31,8 +34,9 @@ FishCatfish::FishCatfish(Aquarium* aquarium) : Fish(aquarium, FishCatfishImageNa
  */
 void FishCatfish::Update(double elapsed)
 {
+    AQUARIUM_TRACE_ZONE("FishCatfish::Update");
     // Occasionally, the fish will dart quickly for a short time
-    if (!mIsDarting && rand() % 100 < 3)  // 3% chance to start darting
+    if (!mIsDarting && GetAquarium()->GetRandom()() % 100 < 3)  // 3% chance to start darting
     {
         mIsDarting = true;
         mDartDuration = 0.5;  // Dart for half a second
@@ -78,10 +82,23 @@ void FishCatfish::Update(double elapsed)
 }
 
 /**
- * Loads xml from fish class
- * @param node
+ * Save the catfish including any dart in progress
+ * @param record Record to save into
+ */
+void FishCatfish::SaveRecord(ItemRecord* record) const
+{
+    Fish::SaveRecord(record);
+    record->state[0] = mIsDarting ? 1 : 0;
+    record->state[1] = mDartDuration;
+}
+
+/**
+ * Load the catfish including any dart in progress
+ * @param record Record to load from
  */
-void FishCatfish::XmlLoad(wxXmlNode* node)
+void FishCatfish::LoadRecord(const ItemRecord& record)
 {
-    Fish::XmlLoad(node);  // Call the base class to load common attributes
+    Fish::LoadRecord(record);
+    mIsDarting = record.state[0] != 0;
+    mDartDuration = record.state[1];
 }
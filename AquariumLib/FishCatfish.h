@@ -19,18 +19,21 @@ class FishCatfish : public Fish
 public:
     /// Constructor
     FishCatfish(Aquarium* aquarium);
+    /// This species' id in the SpeciesRegistry
+    static const SpeciesId Species;
+
     /**
-     *gets type
-     * @return wstring type
+     * Get the species of this item
+     * @return FishCatfish::Species
      */
-    std::wstring GetType() const override { return L"catfish"; }
-
-    /// Load Catfish fish from XML
-    void XmlLoad(wxXmlNode* node) override;
+    SpeciesId GetSpecies() const override { return Species; }
 
     /// Update the fish state (movement, direction changes, etc.)
     void Update(double elapsed) override;
 
+    void SaveRecord(ItemRecord* record) const override;
+    void LoadRecord(const ItemRecord& record) override;
+
 private:
     /**
      * member variable for if it is darting
@@ -0,0 +1,214 @@
+/**
+ * @file FrameExporter.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "FrameExporter.h"
+#include "Aquarium.h"
+#include <wx/dcmemory.h>
+#include <wx/filename.h>
+#include <algorithm>
+
+using namespace std;
+
+/// How many frames per encoder thread may wait in the queue
+const int QueuedPerThread = 2;
+
+/**
+ * Constructor
+ * @param aquarium The aquarium to export
+ */
+FrameExporter::FrameExporter(Aquarium* aquarium) : mAquarium(aquarium)
+{
+}
+
+/**
+ * Get the filename for a numbered frame
+ * @param directory Directory the frames go in
+ * @param frame Frame number
+ * @return Full path of the frame file
+ */
+wxString FrameExporter::FrameFilename(const wxString& directory, int frame)
+{
+    return directory + wxFileName::GetPathSeparator() + wxString::Format(L"frame%06d.png", frame);
+}
+
+/**
+ * Draw the current state of the aquarium and advance it one timestep.
+ * @param dc Memory device context to draw on
+ */
+void FrameExporter::RenderFrame(wxMemoryDC* dc)
+{
+    dc->SetBackground(*wxWHITE_BRUSH);
+    dc->Clear();
+    mAquarium->OnDraw(dc);
+
+    mAquarium->Update(1.0 / mFrameRate);
+}
+
+/**
+ * Export frames as numbered PNG files.
+ *
+ * Rendering happens on the calling thread, encoding on worker threads.
+ *
+ * @param directory Directory to write frames to, created if needed
+ * @param frames Number of frames to export
+ * @return true if every frame was written
+ */
+bool FrameExporter::ExportPng(const wxString& directory, int frames)
+{
+    if (!wxFileName::DirExists(directory) && !wxFileName::Mkdir(directory, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+    {
+        return false;
+    }
+
+    wxBitmap bitmap(mAquarium->GetWidth(), mAquarium->GetHeight());
+    wxMemoryDC dc;
+
+    StartWorkers();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        dc.SelectObject(bitmap);
+        RenderFrame(&dc);
+        dc.SelectObject(wxNullBitmap);
+
+        // The image is created here and only ever touched by
+        // the one worker that encodes it, so nothing is shared.
+        Queue(make_unique<wxImage>(bitmap.ConvertToImage()),
+              FrameFilename(directory, frame).ToStdWstring());
+    }
+
+    return StopWorkers() == 0;
+}
+
+/**
+ * Export frames as a raw RGBA stream.
+ *
+ * Each frame is width * height * 4 bytes, rows top to bottom.
+ * There is no header, so the consumer must be told the size
+ * (Aquarium::GetWidth, Aquarium::GetHeight) and frame rate.
+ *
+ * @param out Stream to write to, opened in binary mode
+ * @param frames Number of frames to export
+ * @return true if every frame was written
+ */
+bool FrameExporter::ExportRaw(FILE* out, int frames)
+{
+    auto width = mAquarium->GetWidth();
+    auto height = mAquarium->GetHeight();
+    wxBitmap bitmap(width, height);
+    wxMemoryDC dc;
+
+    vector<unsigned char> rgba((size_t)width * height * 4);
+    for (int frame = 0; frame < frames; frame++)
+    {
+        dc.SelectObject(bitmap);
+        RenderFrame(&dc);
+        dc.SelectObject(wxNullBitmap);
+
+        auto image = bitmap.ConvertToImage();
+        auto rgb = image.GetData();
+        auto alpha = image.HasAlpha() ? image.GetAlpha() : nullptr;
+        for (size_t p = 0; p < (size_t)width * height; p++)
+        {
+            rgba[p * 4] = rgb[p * 3];
+            rgba[p * 4 + 1] = rgb[p * 3 + 1];
+            rgba[p * 4 + 2] = rgb[p * 3 + 2];
+            rgba[p * 4 + 3] = alpha != nullptr ? alpha[p] : 255;
+        }
+
+        if (fwrite(rgba.data(), 1, rgba.size(), out) != rgba.size())
+        {
+            return false;
+        }
+    }
+
+    return fflush(out) == 0;
+}
+
+/**
+ * Start the encoder threads
+ */
+void FrameExporter::StartWorkers()
+{
+    int threads = mThreads > 0 ? mThreads : (int)max(thread::hardware_concurrency(), 1u);
+
+    mDone = false;
+    mFailures = 0;
+    mMaxQueued = (size_t)threads * QueuedPerThread;
+    for (int i = 0; i < threads; i++)
+    {
+        mWorkers.emplace_back(&FrameExporter::Worker, this);
+    }
+}
+
+/**
+ * Wait for the queue to drain and the encoder threads to exit
+ * @return Number of frames that failed to write
+ */
+int FrameExporter::StopWorkers()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        mDone = true;
+    }
+    mJobReady.notify_all();
+
+    for (auto& worker : mWorkers)
+    {
+        worker.join();
+    }
+    mWorkers.clear();
+
+    return mFailures;
+}
+
+/**
+ * Queue a frame for encoding.
+ *
+ * Blocks while the queue is full so a slow encoder
+ * cannot make us hold an unbounded number of frames.
+ *
+ * @param image Image to encode
+ * @param filename File to write it to
+ */
+void FrameExporter::Queue(std::unique_ptr<wxImage> image, const std::wstring& filename)
+{
+    unique_lock<mutex> lock(mMutex);
+    mJobTaken.wait(lock, [this] { return mQueue.size() < mMaxQueued; });
+    mQueue.push_back({std::move(image), filename});
+    lock.unlock();
+
+    mJobReady.notify_one();
+}
+
+/**
+ * Encoder thread. Takes frames off the queue and writes them as PNG.
+ */
+void FrameExporter::Worker()
+{
+    for (;;)
+    {
+        unique_lock<mutex> lock(mMutex);
+        mJobReady.wait(lock, [this] { return mDone || !mQueue.empty(); });
+        if (mQueue.empty())
+        {
+            return;
+        }
+
+        auto job = std::move(mQueue.front());
+        mQueue.pop_front();
+        lock.unlock();
+        mJobTaken.notify_one();
+
+        bool saved = job.image->SaveFile(job.filename, wxBITMAP_TYPE_PNG);
+        job.image.reset();
+
+        if (!saved)
+        {
+            lock_guard<mutex> failLock(mMutex);
+            mFailures++;
+        }
+    }
+}
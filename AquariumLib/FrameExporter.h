@@ -0,0 +1,114 @@
+/**
+ * @file FrameExporter.h
+ * @author Josh Thomas
+ * @brief Header file for the FrameExporter class.
+ *
+ * Renders an aquarium offscreen and writes the frames out.
+ */
+
+#ifndef FRAMEEXPORTER_H
+#define FRAMEEXPORTER_H
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Aquarium;
+
+/**
+ * @class FrameExporter
+ * @brief Offscreen renderer that exports an aquarium as a frame sequence.
+ *
+ * Each frame is drawn with Aquarium::OnDraw into a wxMemoryDC and the
+ * aquarium is advanced by a fixed timestep, so no window is needed.
+ * Frames can be written as numbered PNG files, or as a raw RGBA stream
+ * suitable for piping into a video encoder.
+ *
+ * PNG encoding is pipelined onto worker threads. The render thread only
+ * converts the bitmap to an image and queues it, so throughput is bounded
+ * by rendering rather than compression.
+ */
+class FrameExporter
+{
+private:
+    /// A frame waiting to be encoded
+    struct EncodeJob
+    {
+        /// The image to encode, owned by whoever holds the job
+        std::unique_ptr<wxImage> image;
+
+        /// Filename to write it to
+        std::wstring filename;
+    };
+
+    /// The aquarium we are exporting
+    Aquarium* mAquarium;
+
+    /// Frames per second of simulated time
+    double mFrameRate = 30;
+
+    /// Number of encoder threads, 0 to use one per core
+    int mThreads = 0;
+
+    /// Frames waiting for an encoder
+    std::deque<EncodeJob> mQueue;
+
+    /// Most frames we let wait in mQueue
+    size_t mMaxQueued = 0;
+
+    /// Protects mQueue, mDone and mFailures
+    std::mutex mMutex;
+
+    /// Signalled when a job is queued or we are done
+    std::condition_variable mJobReady;
+
+    /// Signalled when a job is taken off the queue
+    std::condition_variable mJobTaken;
+
+    /// Set when no more jobs will be queued
+    bool mDone = false;
+
+    /// Number of frames that failed to write
+    int mFailures = 0;
+
+    /// The encoder threads
+    std::vector<std::thread> mWorkers;
+
+    void StartWorkers();
+    int StopWorkers();
+    void Worker();
+    void Queue(std::unique_ptr<wxImage> image, const std::wstring& filename);
+    void RenderFrame(wxMemoryDC* dc);
+
+public:
+    explicit FrameExporter(Aquarium* aquarium);
+
+    /// Copy constructor (disabled)
+    FrameExporter(const FrameExporter&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const FrameExporter&) = delete;
+
+    /**
+     * Set the simulated frame rate
+     * @param frameRate Frames per second
+     */
+    void SetFrameRate(double frameRate) { mFrameRate = frameRate; }
+
+    /**
+     * Set the number of PNG encoder threads
+     * @param threads Thread count, 0 to use one per core
+     */
+    void SetThreads(int threads) { mThreads = threads; }
+
+    bool ExportPng(const wxString& directory, int frames);
+    bool ExportRaw(FILE* out, int frames);
+
+    static wxString FrameFilename(const wxString& directory, int frame);
+};
+
+#endif //FRAMEEXPORTER_H
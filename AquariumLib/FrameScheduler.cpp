@@ -0,0 +1,115 @@
+/**
+ * @file FrameScheduler.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "FrameScheduler.h"
+#include <algorithm>
+
+/// Weight of the newest frame in the smoothed frame cost
+const double CostSmoothing = 0.2;
+
+/// When overrunning, leave this much headroom over the
+/// measured frame cost so input events can be handled
+const double OverrunHeadroom = 1.5;
+
+/// Slowest we will ever let the frame interval get in milliseconds
+const double MaxFrameInterval = 250;
+
+/// Shortest delay we ever ask the timer for in milliseconds
+const long MinDelay = 1;
+
+/**
+ * Constructor
+ * @param frameRate Target frame rate in frames per second
+ */
+FrameScheduler::FrameScheduler(double frameRate)
+{
+    SetFrameRate(frameRate);
+}
+
+/**
+ * Set the target frame rate
+ * @param frameRate Frames per second, must be positive
+ */
+void FrameScheduler::SetFrameRate(double frameRate)
+{
+    mFrameInterval = std::min(1000.0 / std::max(frameRate, 1.0), MaxFrameInterval);
+}
+
+/**
+ * Called when the repaint timer fires.
+ *
+ * Repaints are coalesced: if one is already queued with the
+ * window system, another is not requested.
+ *
+ * @param animating True if anything in the scene is moving
+ * @return true if the caller should queue a repaint
+ */
+bool FrameScheduler::RequestRepaint(bool animating)
+{
+    if (mPending || (!animating && !mInvalid))
+    {
+        return false;
+    }
+
+    mPending = true;
+    return true;
+}
+
+/**
+ * Mark the start of a frame
+ * @param time Current time in milliseconds
+ */
+void FrameScheduler::BeginFrame(long time)
+{
+    mFrameStart = time;
+}
+
+/**
+ * Mark the end of a frame and record what it cost
+ * @param time Current time in milliseconds
+ */
+void FrameScheduler::EndFrame(long time)
+{
+    mLastCost = std::max(time - mFrameStart, 0L);
+    mAverageCost += (mLastCost - mAverageCost) * CostSmoothing;
+    mPending = false;
+    mInvalid = false;
+}
+
+/**
+ * The interval we are actually running at.
+ *
+ * This is the target interval unless frames are overrunning,
+ * in which case we back off to the measured cost plus headroom.
+ *
+ * @return Interval between frame starts in milliseconds
+ */
+double FrameScheduler::GetEffectiveInterval() const
+{
+    if (IsOverrunning())
+    {
+        return std::min(mAverageCost * OverrunHeadroom, MaxFrameInterval);
+    }
+
+    return mFrameInterval;
+}
+
+/**
+ * How long to wait before the next frame.
+ * @param time Current time in milliseconds
+ * @param animating True if anything in the scene is moving
+ * @return Delay in milliseconds, or -1 if no frame is needed
+ */
+long FrameScheduler::NextDelay(long time, bool animating) const
+{
+    if (!animating && !mInvalid)
+    {
+        return -1;
+    }
+
+    auto next = mFrameStart + (long)GetEffectiveInterval();
+    return std::max(next - time, MinDelay);
+}
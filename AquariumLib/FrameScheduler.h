@@ -0,0 +1,95 @@
+/**
+ * @file FrameScheduler.h
+ * @author Josh Thomas
+ * @brief Header file for the FrameScheduler class.
+ *
+ * Decides when the aquarium view should repaint.
+ */
+
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+/// Default target frame rate in frames per second
+const double DefaultFrameRate = 30;
+
+/**
+ * @class FrameScheduler
+ * @brief Adaptive frame scheduler for the aquarium view.
+ *
+ * Replaces a fixed repaint timer. The scheduler only asks for a repaint
+ * when something is animating or the view has been invalidated, coalesces
+ * repaint requests while one is already queued, and measures what each
+ * frame actually costs. When frames take longer than the target interval
+ * the scheduler backs off so input events still get a chance to run.
+ *
+ * All times are in milliseconds from the same clock (the view's stopwatch).
+ */
+class FrameScheduler
+{
+private:
+    /// Target interval between frames in milliseconds
+    double mFrameInterval;
+
+    /// Smoothed cost of a frame in milliseconds
+    double mAverageCost = 0;
+
+    /// Cost of the most recent frame in milliseconds
+    long mLastCost = 0;
+
+    /// Time the current (or most recent) frame started
+    long mFrameStart = 0;
+
+    /// True if something has asked for a repaint
+    bool mInvalid = true;
+
+    /// True if a repaint has been queued with the window system
+    bool mPending = false;
+
+public:
+    explicit FrameScheduler(double frameRate = DefaultFrameRate);
+
+    void SetFrameRate(double frameRate);
+
+    /**
+     * Get the target frame rate
+     * @return Frames per second
+     */
+    double GetFrameRate() const { return 1000.0 / mFrameInterval; }
+
+    /**
+     * Ask for a repaint on the next frame even if nothing is animating.
+     */
+    void Invalidate() { mInvalid = true; }
+
+    /**
+     * Is a repaint needed, either by request or because a frame is queued?
+     * @return true if the view is invalid
+     */
+    bool IsInvalid() const { return mInvalid; }
+
+    bool RequestRepaint(bool animating);
+    void BeginFrame(long time);
+    void EndFrame(long time);
+    long NextDelay(long time, bool animating) const;
+    double GetEffectiveInterval() const;
+
+    /**
+     * Get the smoothed cost of a frame
+     * @return Frame cost in milliseconds
+     */
+    double GetAverageCost() const { return mAverageCost; }
+
+    /**
+     * Get the cost of the most recent frame
+     * @return Frame cost in milliseconds
+     */
+    long GetLastCost() const { return mLastCost; }
+
+    /**
+     * Are frames currently taking longer than the target interval?
+     * @return true if the scheduler is backing off
+     */
+    bool IsOverrunning() const { return mAverageCost > mFrameInterval; }
+};
+
+#endif //FRAMESCHEDULER_H
@@ -0,0 +1,208 @@
+/**
+ * @file FrameStats.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Constructor
+ * @param window Number of frames the statistics are taken over
+ */
+FrameStats::FrameStats(int window) : mWindow(std::max(window, 2))
+{
+    mSamples.reserve(mWindow);
+    mLatencies.reserve(mWindow);
+}
+
+/**
+ * Record a frame
+ * @param start Time the frame started
+ * @param update Time spent updating the aquarium
+ * @param draw Time spent recording and drawing the frame
+ * @param frame Time for the whole frame
+ * @param items Number of items in the aquarium
+ */
+void FrameStats::AddFrame(double start, double update, double draw, double frame, size_t items)
+{
+    Sample sample = {start, update, draw, frame};
+    if (mSamples.size() < mWindow)
+    {
+        mSamples.push_back(sample);
+    }
+    else
+    {
+        mSamples[mNext] = sample;
+    }
+
+    mNext = (mNext + 1) % mWindow;
+    mItems = items;
+}
+
+/**
+ * Forget every frame
+ */
+void FrameStats::Clear()
+{
+    mSamples.clear();
+    mNext = 0;
+    mItems = 0;
+    mLatencies.clear();
+    mNextLatency = 0;
+}
+
+/**
+ * Get the frame rate over the window
+ * @return Frames per second, 0 if there are not enough frames
+ */
+double FrameStats::GetFramesPerSecond() const
+{
+    if (mSamples.size() < 2)
+    {
+        return 0;
+    }
+
+    // Once the ring is full the oldest sample is the next one overwritten
+    const auto& oldest = mSamples.size() < mWindow ? mSamples.front() : mSamples[mNext];
+    const auto& newest = mSamples[(mNext + mSamples.size() - 1) % mSamples.size()];
+    double span = newest.start - oldest.start;
+    return span > 0 ? (mSamples.size() - 1) * 1000.0 / span : 0;
+}
+
+/**
+ * Get a percentile of the whole frame time
+ * @param percentile Percentile from 0 to 100
+ * @return Frame time, 0 if there are no frames
+ */
+double FrameStats::GetFramePercentile(double percentile) const
+{
+    if (mSamples.empty())
+    {
+        return 0;
+    }
+
+    mSorted.clear();
+    for (const auto& sample : mSamples)
+    {
+        mSorted.push_back(sample.frame);
+    }
+
+    return Percentile(mSorted, percentile);
+}
+
+/**
+ * Record how long an input took to reach the screen
+ * @param latency Time from the input event to the end of the
+ * frame that showed it
+ */
+void FrameStats::AddInputLatency(double latency)
+{
+    if (mLatencies.size() < mWindow)
+    {
+        mLatencies.push_back(latency);
+    }
+    else
+    {
+        mLatencies[mNextLatency] = latency;
+    }
+
+    mNextLatency = (mNextLatency + 1) % mWindow;
+}
+
+/**
+ * Get a percentile of the input-to-photon latency
+ * @param percentile Percentile from 0 to 100
+ * @return Latency, 0 if no input has been shown
+ */
+double FrameStats::GetLatencyPercentile(double percentile) const
+{
+    if (mLatencies.empty())
+    {
+        return 0;
+    }
+
+    mSorted.assign(mLatencies.begin(), mLatencies.end());
+    return Percentile(mSorted, percentile);
+}
+
+/**
+ * Get a nearest rank percentile of some values.
+ * Shared by everything that reports percentile times.
+ * @param values The values, which must not be empty. They are reordered.
+ * @param percentile Percentile from 0 to 100
+ * @return The value
+ */
+double FrameStats::Percentile(std::vector<double>& values, double percentile)
+{
+    auto rank = (size_t)std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * values.size());
+    auto nth = values.begin() + (rank > 0 ? rank - 1 : 0);
+    std::nth_element(values.begin(), nth, values.end());
+    return *nth;
+}
+
+/**
+ * Get the average time spent updating the aquarium
+ * @return Update time
+ */
+double FrameStats::GetAverageUpdate() const
+{
+    double total = 0;
+    for (const auto& sample : mSamples)
+    {
+        total += sample.update;
+    }
+
+    return mSamples.empty() ? 0 : total / mSamples.size();
+}
+
+/**
+ * Get the average time spent recording and drawing frames
+ * @return Draw time
+ */
+double FrameStats::GetAverageDraw() const
+{
+    double total = 0;
+    for (const auto& sample : mSamples)
+    {
+        total += sample.draw;
+    }
+
+    return mSamples.empty() ? 0 : total / mSamples.size();
+}
+
+/**
+ * Are the slowest frames close to the frame budget?
+ * @param budget Time allowed for a frame
+ * @return true if the p99 frame time is over NearBudget of it
+ */
+bool FrameStats::IsNearBudget(double budget) const
+{
+    return GetFramePercentile(99) > budget * NearBudget;
+}
+
+/**
+ * Describe the statistics in one line, for the status bar
+ * @param budget Time allowed for a frame
+ * @return The description
+ */
+wxString FrameStats::Format(double budget) const
+{
+    auto text = wxString::Format(L"%lu items  %.1f fps  update %.2f ms  draw %.2f ms  frame p50 %.2f ms  p99 %.2f ms",
+                                 (unsigned long)mItems, GetFramesPerSecond(), GetAverageUpdate(), GetAverageDraw(),
+                                 GetFramePercentile(50), GetFramePercentile(99));
+    if (IsNearBudget(budget))
+    {
+        text += wxString::Format(L"  (near %.0f ms budget)", budget);
+    }
+
+    if (!mLatencies.empty())
+    {
+        text += wxString::Format(L"  input p50 %.1f ms  p99 %.1f ms", GetLatencyPercentile(50),
+                                 GetLatencyPercentile(99));
+    }
+
+    return text;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file FrameStats.h
+ * @author Josh Thomas
+ * @brief Header file for the FrameStats class.
+ */
+
+#ifndef FRAMESTATS_H
+#define FRAMESTATS_H
+
+#include <vector>
+
+/// Number of frames the statistics are taken over
+const int FrameStatsWindow = 120;
+
+/// A p99 frame time above this fraction of the
+/// frame budget counts as close to the budget
+const double NearBudget = 0.8;
+
+/**
+ * @class FrameStats
+ * @brief Rolling statistics over the most recent frames.
+ *
+ * The view adds a sample for every frame it paints. The statistics are
+ * cheap enough to keep all the time, so a tank that is close to its
+ * frame budget shows up in the status bar without a profiler.
+ *
+ * Times are in milliseconds.
+ */
+class FrameStats
+{
+private:
+    /**
+     * What one frame cost
+     */
+    struct Sample
+    {
+        /// Time the frame started
+        double start;
+
+        /// Time spent updating the aquarium
+        double update;
+
+        /// Time spent recording and drawing the frame
+        double draw;
+
+        /// Time for the whole frame
+        double frame;
+    };
+
+    /// The most recent samples, oldest first once the ring has wrapped
+    std::vector<Sample> mSamples;
+
+    /// Where the next sample goes in mSamples
+    size_t mNext = 0;
+
+    /// Number of items in the aquarium at the last frame
+    size_t mItems = 0;
+
+    /// The most recent input-to-photon latencies, oldest first once the ring has wrapped
+    std::vector<double> mLatencies;
+
+    /// Where the next latency goes in mLatencies
+    size_t mNextLatency = 0;
+
+    /// Scratch space for percentiles, kept to avoid reallocating
+    mutable std::vector<double> mSorted;
+
+    /// Maximum number of samples kept
+    size_t mWindow;
+
+public:
+    explicit FrameStats(int window = FrameStatsWindow);
+
+    void AddFrame(double start, double update, double draw, double frame, size_t items);
+    void Clear();
+    double GetFramesPerSecond() const;
+    double GetFramePercentile(double percentile) const;
+    void AddInputLatency(double latency);
+    double GetLatencyPercentile(double percentile) const;
+    double GetAverageUpdate() const;
+    double GetAverageDraw() const;
+    bool IsNearBudget(double budget) const;
+    wxString Format(double budget) const;
+
+    static double Percentile(std::vector<double>& values, double percentile);
+
+    /**
+     * Get the number of frames the statistics cover
+     * @return Frame count, at most the window size
+     */
+    size_t GetCount() const { return mSamples.size(); }
+
+    /**
+     * Get the number of input latencies the statistics cover
+     * @return Latency count, at most the window size
+     */
+    size_t GetLatencyCount() const { return mLatencies.size(); }
+
+    /**
+     * Get the number of items in the aquarium at the last frame
+     * @return Item count
+     */
+    size_t GetItemCount() const { return mItems; }
+};
+
+#endif //FRAMESTATS_H
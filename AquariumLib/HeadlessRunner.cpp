@@ -0,0 +1,223 @@
+/**
+ * @file HeadlessRunner.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "HeadlessRunner.h"
+#include "Aquarium.h"
+#include "FrameExporter.h"
+#include "InputReplay.h"
+#include "Tracer.h"
+#include <wx/cmdline.h>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+/**
+ * Add the headless options to the application's command line parser
+ * @param parser Parser to add to
+ */
+void HeadlessRunner::AddOptions(wxCmdLineParser& parser)
+{
+    parser.AddOption(L"", L"load", L"aquarium file to load", wxCMD_LINE_VAL_STRING);
+    parser.AddOption(L"", L"export-png", L"render frames without a window and write them as PNG files to this directory",
+                     wxCMD_LINE_VAL_STRING);
+    parser.AddSwitch(L"", L"export-raw", L"render frames without a window and write raw RGBA to stdout");
+    parser.AddOption(L"", L"frames", L"number of frames to run (default 300)", wxCMD_LINE_VAL_NUMBER);
+    parser.AddOption(L"", L"fps", L"simulated frames per second (default 30)", wxCMD_LINE_VAL_DOUBLE);
+    parser.AddOption(L"", L"threads", L"worker threads (default one per core)", wxCMD_LINE_VAL_NUMBER);
+    parser.AddOption(L"", L"scene", L"generate a scene instead of loading one, such as beta=100,carp=50,castle=2",
+                     wxCMD_LINE_VAL_STRING);
+    parser.AddOption(L"", L"seed", L"seed for the generated scene", wxCMD_LINE_VAL_NUMBER);
+    parser.AddOption(L"", L"layout", L"layout of the generated scene: uniform, clustered or corner",
+                     wxCMD_LINE_VAL_STRING);
+    parser.AddOption(L"", L"save-scene", L"save the generated scene to this .aqua file", wxCMD_LINE_VAL_STRING);
+    parser.AddSwitch(L"", L"memory", L"print where the aquarium's memory goes");
+    parser.AddOption(L"", L"replay", L"replay an input recording as fast as possible and report pick and drag latency",
+                     wxCMD_LINE_VAL_STRING);
+#ifdef AQUARIUM_TRACING
+    parser.AddOption(L"", L"trace", L"write a Chrome trace of the run to this JSON file", wxCMD_LINE_VAL_STRING);
+#endif
+}
+
+/**
+ * Pick up the headless options from a parsed command line
+ * @param parser Parser that has parsed the command line
+ * @return false if the options are invalid
+ */
+bool HeadlessRunner::ParseOptions(const wxCmdLineParser& parser)
+{
+    parser.Found(L"load", &mLoadFile);
+    parser.Found(L"frames", &mFrames);
+    parser.Found(L"fps", &mFrameRate);
+    parser.Found(L"threads", &mThreads);
+#ifdef AQUARIUM_TRACING
+    parser.Found(L"trace", &mTraceFile);
+#endif
+    mRaw = parser.Found(L"export-raw");
+    mMemory = parser.Found(L"memory");
+
+    if (parser.Found(L"export-png", &mExportDir) || mRaw || parser.Found(L"save-scene", &mSceneFile) || mMemory ||
+        parser.Found(L"replay", &mReplayFile))
+    {
+        mEnabled = true;
+    }
+
+    // Frames go to one place or the other, never both
+    if (mRaw && !mExportDir.IsEmpty())
+    {
+        fprintf(stderr, "--export-raw and --export-png cannot be used together\n");
+        return false;
+    }
+
+    return mFrames >= 0 && mFrameRate > 0 && mThreads >= 0 && ParseScene(parser);
+}
+
+/**
+ * Pick up the scene generator options from a parsed command line
+ * @param parser Parser that has parsed the command line
+ * @return false if the options are invalid
+ */
+bool HeadlessRunner::ParseScene(const wxCmdLineParser& parser)
+{
+    long seed;
+    if (parser.Found(L"seed", &seed))
+    {
+        mScene.SetSeed((unsigned int)seed);
+    }
+
+    wxString layout;
+    if (parser.Found(L"layout", &layout))
+    {
+        SceneLayout sceneLayout;
+        if (!SceneGenerator::ParseLayout(layout, &sceneLayout))
+        {
+            return false;
+        }
+        mScene.SetLayout(sceneLayout);
+    }
+
+    wxString spec;
+    if (parser.Found(L"scene", &spec))
+    {
+        mGenerate = true;
+        if (!mScene.Parse(spec))
+        {
+            return false;
+        }
+    }
+
+    // Saving a scene needs one to save
+    return mSceneFile.IsEmpty() || mGenerate;
+}
+
+/**
+ * Run the requested headless mode
+ * @return Process exit code
+ */
+int HeadlessRunner::Run()
+{
+    if (!mTraceFile.IsEmpty())
+    {
+        Tracer::Get().Start();
+    }
+
+    int result = mReplayFile.IsEmpty() ? Export() : Replay();
+
+    if (!mTraceFile.IsEmpty())
+    {
+        Tracer::Get().Stop();
+        if (!Tracer::Get().Write(mTraceFile))
+        {
+            fprintf(stderr, "Unable to write trace %s\n", (const char*)mTraceFile.ToUTF8());
+            result = 1;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Load or generate the aquarium and export its frames
+ * @return Process exit code
+ */
+int HeadlessRunner::Export()
+{
+    Aquarium aquarium;
+    if (mGenerate)
+    {
+        mScene.Generate(&aquarium);
+    }
+    else if (!mLoadFile.IsEmpty() && !aquarium.Load(mLoadFile))
+    {
+        fprintf(stderr, "Unable to load aquarium file %s\n", (const char*)mLoadFile.ToUTF8());
+        return 1;
+    }
+
+    if (!mSceneFile.IsEmpty() && !aquarium.Save(mSceneFile))
+    {
+        fprintf(stderr, "Unable to write scene %s\n", (const char*)mSceneFile.ToUTF8());
+        return 1;
+    }
+
+    if (mMemory)
+    {
+        // Raw frames go to stdout, so the report goes to stderr
+        fprintf(mRaw ? stderr : stdout, "%s", (const char*)aquarium.GetMemoryReport().Format().ToUTF8());
+    }
+
+    // Nothing to export, only the scene or the report was asked for
+    if (mExportDir.IsEmpty() && !mRaw)
+    {
+        return 0;
+    }
+
+    FrameExporter exporter(&aquarium);
+    exporter.SetFrameRate(mFrameRate);
+    exporter.SetThreads((int)mThreads);
+
+    if (mRaw)
+    {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        fprintf(stderr, "Raw RGBA %dx%d @ %g fps\n", aquarium.GetWidth(), aquarium.GetHeight(), mFrameRate);
+        return exporter.ExportRaw(stdout, (int)mFrames) ? 0 : 1;
+    }
+
+    return exporter.ExportPng(mExportDir, (int)mFrames) ? 0 : 1;
+}
+
+/**
+ * Replay an input recording and report what it cost
+ * @return Process exit code
+ */
+int HeadlessRunner::Replay()
+{
+    InputReplay replay;
+    if (!replay.Load(mReplayFile))
+    {
+        fprintf(stderr, "Unable to read input recording %s\n", (const char*)mReplayFile.ToUTF8());
+        return 1;
+    }
+
+    Aquarium aquarium;
+    ReplayResult result;
+    if (!replay.Run(&aquarium, &result))
+    {
+        fprintf(stderr, "Input recording %s has no valid snapshot\n", (const char*)mReplayFile.ToUTF8());
+        return 1;
+    }
+
+    printf("%s", (const char*)result.Format().ToUTF8());
+    if (mMemory)
+    {
+        printf("%s", (const char*)aquarium.GetMemoryReport().Format().ToUTF8());
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file HeadlessRunner.h
+ * @author Josh Thomas
+ * @brief Header file for the HeadlessRunner class.
+ *
+ * Runs the aquarium from the command line without a window.
+ */
+
+#ifndef HEADLESSRUNNER_H
+#define HEADLESSRUNNER_H
+
+#include "SceneGenerator.h"
+
+class wxCmdLineParser;
+
+/**
+ * @class HeadlessRunner
+ * @brief Command line mode that drives an Aquarium without a window.
+ *
+ * The application hands its command line parser to this class. If any
+ * headless option was given, the application runs this instead of
+ * showing the main frame.
+ */
+class HeadlessRunner
+{
+private:
+    /// Aquarium file to load before running
+    wxString mLoadFile;
+
+    /// Directory to export PNG frames to
+    wxString mExportDir;
+
+    /// True to write raw RGBA frames to stdout
+    bool mRaw = false;
+
+    /// Number of frames to run
+    long mFrames = 300;
+
+    /// Simulated frames per second
+    double mFrameRate = 30;
+
+    /// Number of worker threads, 0 for one per core
+    long mThreads = 0;
+
+    /// File to write a Chrome trace of the run to, empty for none
+    wxString mTraceFile;
+
+    /// Scene to generate instead of loading a file
+    SceneGenerator mScene;
+
+    /// True if a scene was given with --scene
+    bool mGenerate = false;
+
+    /// File to save the generated scene to, empty for none
+    wxString mSceneFile;
+
+    /// True to print a memory report of the aquarium
+    bool mMemory = false;
+
+    /// Input recording to replay instead of exporting frames, empty for none
+    wxString mReplayFile;
+
+    /// True if any headless option was given
+    bool mEnabled = false;
+
+    int Export();
+    int Replay();
+    bool ParseScene(const wxCmdLineParser& parser);
+
+public:
+    static void AddOptions(wxCmdLineParser& parser);
+    bool ParseOptions(const wxCmdLineParser& parser);
+
+    /**
+     * Was a headless mode requested on the command line?
+     * @return true if Run should be called instead of showing a window
+     */
+    bool IsEnabled() const { return mEnabled; }
+
+    int Run();
+};
+
+#endif //HEADLESSRUNNER_H
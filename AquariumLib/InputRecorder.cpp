@@ -0,0 +1,161 @@
+/**
+ * @file InputRecorder.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "InputRecorder.h"
+#include "Aquarium.h"
+#include "AquaBinary.h"
+#include <wx/ffile.h>
+#include <wx/wfstream.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+using namespace std;
+
+/**
+ * Start recording with a fresh seed.
+ *
+ * Anything recorded before is discarded.
+ *
+ * @param aquarium The aquarium the input goes to
+ */
+void InputRecorder::Start(Aquarium* aquarium)
+{
+    std::random_device rd;
+    Start(aquarium, rd());
+}
+
+/**
+ * Start recording.
+ *
+ * Reseeds the aquarium and takes a snapshot of it, the
+ * state a replay starts from. Anything recorded before
+ * is discarded.
+ *
+ * @param aquarium The aquarium the input goes to
+ * @param seed Seed to give the aquarium
+ */
+void InputRecorder::Start(Aquarium* aquarium, uint32_t seed)
+{
+    mSeed = seed;
+    aquarium->TakeSnapshot(&mSnapshot);
+    aquarium->Seed(seed);
+
+    mEvents.clear();
+    mDuration = 0;
+    mStart = chrono::steady_clock::now();
+    mRecording = true;
+}
+
+/**
+ * Stop recording. The events are kept until the next Start.
+ */
+void InputRecorder::Stop()
+{
+    if (mRecording)
+    {
+        mDuration = max(mDuration, GetTime());
+        mRecording = false;
+    }
+}
+
+/**
+ * Get the time since recording started
+ * @return Time in milliseconds
+ */
+uint32_t InputRecorder::GetTime() const
+{
+    return (uint32_t)chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - mStart).count();
+}
+
+/**
+ * Get the length of the recording
+ * @return Milliseconds from the start to now, or to Stop
+ * or the last event, whichever is later
+ */
+uint32_t InputRecorder::GetDuration() const
+{
+    return mRecording ? max(mDuration, GetTime()) : mDuration;
+}
+
+/**
+ * Record an event that has just happened
+ * @param type What happened
+ * @param x Mouse X in pixels
+ * @param y Mouse Y in pixels
+ * @param leftDown True if the left button is down
+ */
+void InputRecorder::Record(InputEventType type, int x, int y, bool leftDown)
+{
+    if (!mRecording)
+    {
+        return;
+    }
+
+    InputEvent event;
+    event.time = GetTime();
+    event.type = (uint16_t)type;
+    event.buttons = leftDown ? InputEvent::LeftButton : 0;
+    event.x = x;
+    event.y = y;
+    Add(event);
+}
+
+/**
+ * Add an event with its own timestamp, such as a scripted one.
+ *
+ * Events must be added in time order.
+ *
+ * @param event The event
+ */
+void InputRecorder::Add(const InputEvent& event)
+{
+    mEvents.push_back(event);
+    mDuration = max(mDuration, event.time);
+}
+
+/**
+ * Save the recording
+ * @param filename File to write, replaced if it exists
+ * @return true if successful
+ */
+bool InputRecorder::Save(const wxString& filename) const
+{
+    InputRecordingHeader header;
+    memcpy(header.magic, InputRecordingMagic, sizeof(header.magic));
+    header.version = InputRecordingVersion;
+    header.eventSize = sizeof(InputEvent);
+    header.seed = mSeed;
+    header.step = mStep;
+    header.duration = GetDuration();
+    header.reserved = 0;
+    header.snapshotBytes = 0;
+    header.eventCount = mEvents.size();
+
+    wxFFile file(filename, L"wb");
+    if (!file.IsOpened())
+    {
+        return false;
+    }
+
+    bool ok = file.Write(&header, sizeof(header)) == sizeof(header);
+    if (ok)
+    {
+        wxFFileOutputStream stream(file);
+        ok = AquaBinary::Write(stream, mSnapshot);
+    }
+
+    // Now we know how big the snapshot is, fill in the header
+    if (ok)
+    {
+        header.snapshotBytes = (uint64_t)file.Tell() - sizeof(header);
+        auto eventBytes = mEvents.size() * sizeof(InputEvent);
+        ok = file.Write(mEvents.data(), eventBytes) == eventBytes &&
+             file.Seek(0) && file.Write(&header, sizeof(header)) == sizeof(header);
+    }
+
+    return file.Close() && ok;
+}
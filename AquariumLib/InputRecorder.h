@@ -0,0 +1,187 @@
+/**
+ * @file InputRecorder.h
+ * @author Josh Thomas
+ * @brief Header file for the InputRecorder class.
+ *
+ * Layout of an input recording file, all little-endian:
+ *  - InputRecordingHeader
+ *  - snapshotBytes of binary .aqua data, the aquarium when recording started
+ *  - eventCount InputEvent structures, in time order
+ */
+
+#ifndef INPUTRECORDER_H
+#define INPUTRECORDER_H
+
+#include <chrono>
+#include <vector>
+#include "ItemRecord.h"
+
+class Aquarium;
+
+/// Magic bytes at the start of every input recording
+const char InputRecordingMagic[8] = {'A', 'Q', 'U', 'A', 'I', 'N', 'P', 'T'};
+
+/// Current version of the input recording format
+const uint32_t InputRecordingVersion = 1;
+
+/// Default simulation step a recording is replayed at, in microseconds
+const uint32_t DefaultInputStep = 1000000 / 60;
+
+/**
+ * @struct InputRecordingHeader
+ * @brief The header at the start of an input recording.
+ */
+struct InputRecordingHeader
+{
+    /// Always InputRecordingMagic
+    char magic[8];
+
+    /// Format version, InputRecordingVersion when written
+    uint32_t version;
+
+    /// sizeof(InputEvent) when written
+    uint32_t eventSize;
+
+    /// Seed of the aquarium's random number generator when recording started
+    uint32_t seed;
+
+    /// Fixed simulation step to replay at, in microseconds
+    uint32_t step;
+
+    /// Length of the recording in milliseconds
+    uint32_t duration;
+
+    /// Padding, always zero
+    uint32_t reserved;
+
+    /// Size of the snapshot that follows in bytes
+    uint64_t snapshotBytes;
+
+    /// Number of events after the snapshot
+    uint64_t eventCount;
+};
+
+static_assert(sizeof(InputRecordingHeader) == 48, "InputRecordingHeader is an on-disk format");
+
+/**
+ * The kinds of input a recording holds
+ */
+enum class InputEventType : uint16_t
+{
+    LeftDown = 1,   ///< Left button pressed
+    LeftUp,         ///< Left button released
+    MouseMove,      ///< Mouse moved
+    LeftDClick      ///< Left button double clicked
+};
+
+/**
+ * @struct InputEvent
+ * @brief One mouse event, as written to a recording.
+ */
+struct InputEvent
+{
+    /// Flag set in buttons if the left button is down
+    static const uint16_t LeftButton = 1;
+
+    /// Time since recording started in milliseconds
+    uint32_t time = 0;
+
+    /// An InputEventType
+    uint16_t type = 0;
+
+    /// Combination of the button flags above
+    uint16_t buttons = 0;
+
+    /// Mouse X in pixels
+    int32_t x = 0;
+
+    /// Mouse Y in pixels
+    int32_t y = 0;
+};
+
+static_assert(sizeof(InputEvent) == 16, "InputEvent is an on-disk format");
+
+/**
+ * @class InputRecorder
+ * @brief Records the mouse input to an aquarium so it can be replayed.
+ *
+ * Starting a recording reseeds the aquarium and takes a snapshot of
+ * it, so a replay starts from exactly the same state and random
+ * numbers. Events are timestamped as they arrive and kept in memory
+ * until the recording is saved. They are small, so even a long
+ * session of dragging costs little.
+ *
+ * The view's frames are not recorded. A replay steps the simulation
+ * at a fixed rate instead, so replays of a recording match each
+ * other, though not necessarily the session they were recorded from.
+ */
+class InputRecorder
+{
+private:
+    /// The aquarium when recording started
+    AquaSnapshot mSnapshot;
+
+    /// Seed the aquarium was given when recording started
+    uint32_t mSeed = 0;
+
+    /// Simulation step to replay at, in microseconds
+    uint32_t mStep = DefaultInputStep;
+
+    /// The events so far
+    std::vector<InputEvent> mEvents;
+
+    /// When recording started
+    std::chrono::steady_clock::time_point mStart;
+
+    /// Length of the recording in milliseconds, once stopped
+    uint32_t mDuration = 0;
+
+    /// True while events are being recorded
+    bool mRecording = false;
+
+    uint32_t GetTime() const;
+
+public:
+    InputRecorder() = default;
+
+    /// Copy constructor (disabled)
+    InputRecorder(const InputRecorder&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const InputRecorder&) = delete;
+
+    void Start(Aquarium* aquarium);
+    void Start(Aquarium* aquarium, uint32_t seed);
+    void Stop();
+    void Record(InputEventType type, int x, int y, bool leftDown);
+    void Add(const InputEvent& event);
+    bool Save(const wxString& filename) const;
+
+    /**
+     * Set the simulation step the recording is replayed at
+     * @param step Step in microseconds
+     */
+    void SetStep(uint32_t step) { mStep = step; }
+
+    /**
+     * Is input being recorded?
+     * @return true between Start and Stop
+     */
+    bool IsRecording() const { return mRecording; }
+
+    /**
+     * Get the number of events recorded
+     * @return Event count
+     */
+    size_t GetEventCount() const { return mEvents.size(); }
+
+    /**
+     * Get the seed the aquarium was given when recording started
+     * @return The seed
+     */
+    uint32_t GetSeed() const { return mSeed; }
+
+    uint32_t GetDuration() const;
+};
+
+#endif //INPUTRECORDER_H
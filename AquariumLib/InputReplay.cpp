@@ -0,0 +1,254 @@
+/**
+ * @file InputReplay.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "InputReplay.h"
+#include "Aquarium.h"
+#include "AquariumInput.h"
+#include "AquaBinary.h"
+#include "FrameStats.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * Get the average time
+ * @return Time in milliseconds, 0 if nothing was measured
+ */
+double InputLatency::GetAverage() const
+{
+    if (mSamples.empty())
+    {
+        return 0;
+    }
+
+    double total = 0;
+    for (auto sample : mSamples)
+    {
+        total += sample;
+    }
+
+    return total / mSamples.size();
+}
+
+/**
+ * Get a percentile of the times
+ * @param percentile Percentile from 0 to 100
+ * @return Time in milliseconds, 0 if nothing was measured
+ */
+double InputLatency::GetPercentile(double percentile) const
+{
+    if (mSamples.empty())
+    {
+        return 0;
+    }
+
+    auto sorted = mSamples;
+    return FrameStats::Percentile(sorted, percentile);
+}
+
+/**
+ * Get the longest time
+ * @return Time in milliseconds, 0 if nothing was measured
+ */
+double InputLatency::GetMax() const
+{
+    return mSamples.empty() ? 0 : *max_element(mSamples.begin(), mSamples.end());
+}
+
+/**
+ * Format the times on one line
+ * @return Text like "120, avg 0.052 ms, p99 0.210 ms, max 0.400 ms"
+ */
+wxString InputLatency::Format() const
+{
+    return wxString::Format(L"%llu, avg %.3f ms, p99 %.3f ms, max %.3f ms", (unsigned long long)GetCount(),
+                            GetAverage(), GetPercentile(99), GetMax());
+}
+
+/**
+ * Format the result of a replay
+ * @return The result, one line per measurement
+ */
+wxString ReplayResult::Format() const
+{
+    auto text = wxString::Format(L"Replayed %llu events over %d steps in %.1f ms\n", (unsigned long long)events,
+                                 ticks, time);
+    text += L"Pick  " + pick.Format() + L"\n";
+    text += L"Drag  " + drag.Format() + L"\n";
+    text += wxString::Format(L"Checksum %016llx\n", (unsigned long long)checksum);
+    return text;
+}
+
+/**
+ * Does a block of data start like an input recording?
+ * @param data Start of the data
+ * @param size Size of the data in bytes
+ * @return true if it has the magic bytes
+ */
+bool InputReplay::IsRecording(const char* data, size_t size)
+{
+    return size >= sizeof(InputRecordingMagic) && memcmp(data, InputRecordingMagic, sizeof(InputRecordingMagic)) == 0;
+}
+
+/**
+ * Load an input recording
+ * @param filename The recording file
+ * @return false if the file is not a valid recording
+ */
+bool InputReplay::Load(const wxString& filename)
+{
+    mSnapshot = nullptr;
+    mEvents.clear();
+    if (!mFile.Open(filename))
+    {
+        return false;
+    }
+
+    auto data = mFile.GetData();
+    auto size = mFile.GetSize();
+    if (!IsRecording(data, size) || size < sizeof(InputRecordingHeader))
+    {
+        return false;
+    }
+
+    memcpy(&mHeader, data, sizeof(mHeader));
+    auto available = size - sizeof(mHeader);
+    if (mHeader.version != InputRecordingVersion || mHeader.eventSize != sizeof(InputEvent) ||
+        mHeader.snapshotBytes > available ||
+        mHeader.eventCount > (available - mHeader.snapshotBytes) / sizeof(InputEvent))
+    {
+        return false;
+    }
+
+    // The events do not have to be aligned in the file, so they are copied
+    mSnapshot = data + sizeof(mHeader);
+    mEvents.resize((size_t)mHeader.eventCount);
+    memcpy(mEvents.data(), mSnapshot + mHeader.snapshotBytes, mEvents.size() * sizeof(InputEvent));
+    return true;
+}
+
+/**
+ * Put an aquarium back in the state the recording started from:
+ * the same items and the same random number seed
+ * @param aquarium Aquarium to restore, replacing its items
+ * @return false if no recording is loaded
+ */
+bool InputReplay::Restore(Aquarium* aquarium) const
+{
+    vector<wstring> species;
+    const ItemRecord* records;
+    size_t count;
+    if (mSnapshot == nullptr ||
+        !AquaBinary::Read(mSnapshot, (size_t)mHeader.snapshotBytes, &species, &records, &count))
+    {
+        return false;
+    }
+
+    aquarium->BeginLoad();
+    aquarium->AddRecords(species, records, count);
+    aquarium->EndLoad();
+
+    // Creating the items draws random numbers, so seed last
+    aquarium->Seed(mHeader.seed);
+    return true;
+}
+
+/**
+ * Replay the recording as fast as possible.
+ *
+ * The aquarium is restored first, so every replay of a
+ * recording starts from the same state.
+ *
+ * @param aquarium Aquarium to replay against
+ * @param result Receives the state hash and latencies
+ * @return false if no recording is loaded
+ */
+bool InputReplay::Run(Aquarium* aquarium, ReplayResult* result) const
+{
+    AQUARIUM_TRACE_ZONE("InputReplay::Run");
+    *result = ReplayResult();
+    if (!Restore(aquarium))
+    {
+        return false;
+    }
+
+    auto start = chrono::steady_clock::now();
+    AquariumInput input(aquarium);
+
+    // Time is kept in whole microseconds so it never drifts
+    uint64_t step = mStep > 0 ? mStep : (mHeader.step > 0 ? mHeader.step : DefaultInputStep);
+    uint64_t duration = (uint64_t)mHeader.duration * 1000;
+    uint64_t now = 0;
+    size_t next = 0;
+    while (true)
+    {
+        for (; next < mEvents.size() && (uint64_t)mEvents[next].time * 1000 <= now; next++)
+        {
+            const auto& event = mEvents[next];
+            auto eventStart = chrono::steady_clock::now();
+            bool redraw = false;
+            switch ((InputEventType)event.type)
+            {
+            case InputEventType::LeftDown:
+                redraw = input.LeftDown(event.x, event.y);
+                break;
+
+            case InputEventType::LeftUp:
+                redraw = input.LeftUp(event.x, event.y);
+                break;
+
+            case InputEventType::MouseMove:
+            {
+                // Applied once per step, as the view applies them once per frame
+                wxRect dirty;
+                input.QueueMove(event.x, event.y, (event.buttons & InputEvent::LeftButton) != 0, &dirty);
+                result->events++;
+                continue;
+            }
+
+            case InputEventType::LeftDClick:
+                redraw = input.LeftDClick(event.x, event.y);
+                break;
+
+            default:
+                continue;
+            }
+
+            // The user sees the result once the frame is recorded
+            if (redraw)
+            {
+                aquarium->RecordDrawList();
+            }
+
+            result->pick.Add(chrono::duration<double, milli>(chrono::steady_clock::now() - eventStart).count());
+            result->events++;
+        }
+
+        // However many moves were queued this step, only the latest is applied
+        auto moveStart = chrono::steady_clock::now();
+        if (input.ApplyMove())
+        {
+            aquarium->RecordDrawList();
+            result->drag.Add(chrono::duration<double, milli>(chrono::steady_clock::now() - moveStart).count());
+        }
+
+        if (next == mEvents.size() && now >= duration)
+        {
+            break;
+        }
+
+        aquarium->Update((double)step / 1000000);
+        result->ticks++;
+        now += step;
+    }
+
+    result->time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    result->checksum = aquarium->GetStateHash();
+    return true;
+}
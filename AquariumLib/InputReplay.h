@@ -0,0 +1,143 @@
+/**
+ * @file InputReplay.h
+ * @author Josh Thomas
+ * @brief Header file for the InputReplay class.
+ */
+
+#ifndef INPUTREPLAY_H
+#define INPUTREPLAY_H
+
+#include <vector>
+#include "InputRecorder.h"
+#include "MappedFile.h"
+
+/**
+ * @class InputLatency
+ * @brief How long one kind of input took to handle.
+ *
+ * Times are in milliseconds.
+ */
+class InputLatency
+{
+private:
+    /// Every time measured
+    std::vector<double> mSamples;
+
+public:
+    /**
+     * Add a measured time
+     * @param time Time in milliseconds
+     */
+    void Add(double time) { mSamples.push_back(time); }
+
+    /**
+     * Get the number of times measured
+     * @return Sample count
+     */
+    size_t GetCount() const { return mSamples.size(); }
+
+    double GetAverage() const;
+    double GetPercentile(double percentile) const;
+    double GetMax() const;
+    wxString Format() const;
+};
+
+/**
+ * @struct ReplayResult
+ * @brief What a replay of an input recording did and how long it took.
+ */
+struct ReplayResult
+{
+    /// Aquarium::GetStateHash at the end of the replay
+    uint64_t checksum = 0;
+
+    /// Number of simulation steps run
+    int ticks = 0;
+
+    /// Number of events replayed
+    size_t events = 0;
+
+    /// Picks: presses, releases and double clicks, each with its hit test,
+    /// and recording the frame if they changed anything
+    InputLatency pick;
+
+    /// Drags: applying the latest queued move of a step, and recording the frame
+    InputLatency drag;
+
+    /// Wall time of the whole replay in milliseconds
+    double time = 0;
+
+    wxString Format() const;
+};
+
+/**
+ * @class InputReplay
+ * @brief Plays an input recording back against an aquarium without a window.
+ *
+ * The aquarium is restored to the recorded snapshot and seed, then
+ * stepped at the recording's fixed rate, with each event handled
+ * before the first step at or after its time. Drag moves are queued
+ * and only the latest is applied before each step, the way the view
+ * applies them once per frame. Nothing waits on the clock, so a
+ * replay runs as fast as the machine allows, and two replays of the
+ * same recording end in the same state.
+ */
+class InputReplay
+{
+private:
+    /// The recording file, which the snapshot is read from
+    MappedFile mFile;
+
+    /// The header of the recording
+    InputRecordingHeader mHeader = {};
+
+    /// Start of the snapshot in mFile
+    const char* mSnapshot = nullptr;
+
+    /// The events, in time order
+    std::vector<InputEvent> mEvents;
+
+    /// Simulation step in microseconds, 0 for the recording's own
+    uint32_t mStep = 0;
+
+public:
+    InputReplay() = default;
+
+    /// Copy constructor (disabled)
+    InputReplay(const InputReplay&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const InputReplay&) = delete;
+
+    bool Load(const wxString& filename);
+    bool Restore(Aquarium* aquarium) const;
+    bool Run(Aquarium* aquarium, ReplayResult* result) const;
+
+    static bool IsRecording(const char* data, size_t size);
+
+    /**
+     * Replay at a different simulation step than was recorded
+     * @param step Step in microseconds, 0 for the recording's own
+     */
+    void SetStep(uint32_t step) { mStep = step; }
+
+    /**
+     * Get the number of events in the recording
+     * @return Event count
+     */
+    size_t GetEventCount() const { return mEvents.size(); }
+
+    /**
+     * Get the seed the recording was made with
+     * @return The seed
+     */
+    uint32_t GetSeed() const { return mHeader.seed; }
+
+    /**
+     * Get the length of the recording
+     * @return Length in milliseconds
+     */
+    uint32_t GetDuration() const { return mHeader.duration; }
+};
+
+#endif //INPUTREPLAY_H
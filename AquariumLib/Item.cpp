@@ -15,29 +15,24 @@ using namespace std;
  */
 Item::Item(Aquarium* aquarium, const std::wstring& filename) : mAquarium(aquarium)
 {
-    mItemImage = std::make_unique<wxImage>(filename, wxBITMAP_TYPE_ANY);
-    mFishBitmap = std::make_unique<wxBitmap>(*mItemImage);
-
-    // Create a mirrored image
-    wxImage mirroredImage = mItemImage->Mirror();
-    mFishBitmapMirror = std::make_unique<wxBitmap>(mirroredImage);
+    mSprite = aquarium->GetSprites().Load(filename);
 }
 
+/**
+ * Draw this item directly.
+ *
+ * Aquarium::OnDraw goes through a DrawList instead; this
+ * is for drawing a single item on its own.
+ * @param dc Device context to draw on
+ */
 void Item::Draw(wxDC* dc)
 {
-    double wid = mFishBitmap->GetWidth();
-    double hit = mFishBitmap->GetHeight();
+    double wid = mSprite->width;
+    double hit = mSprite->height;
     int x = int(GetX() - wid / 2);
     int y = int(GetY() - hit / 2);
 
-    if (mMirror)
-    {
-        dc->DrawBitmap(*mFishBitmapMirror, x, y, true);
-    }
-    else
-    {
-        dc->DrawBitmap(*mFishBitmap, x, y, true);
-    }
+    dc->DrawBitmap(mMirror ? mSprite->mirror : mSprite->bitmap, x, y, true);
 }
 
 /**
@@ -48,8 +43,14 @@ void Item::Draw(wxDC* dc)
  */
 bool Item::HitTest(int x, int y)
 {
-    double wid = mFishBitmap->GetWidth();
-    double hit = mFishBitmap->GetHeight();
+    // Nothing to click on until the image is loaded
+    if (!mSprite->ready)
+    {
+        return false;
+    }
+
+    double wid = mSprite->width;
+    double hit = mSprite->height;
 
     double testX = x - GetX() + wid / 2;
     double testY = y - GetY() + hit / 2;
@@ -64,46 +65,45 @@ bool Item::HitTest(int x, int y)
         return false;
     }
 
-    return !mItemImage->IsTransparent((int)testX, (int)testY);
+    return !mSprite->IsTransparent((int)testX, (int)testY);
 }
 
 /**
- * Save this item to an XML node
- * @param node The parent node we are going to be a child of
- * @return wxXmlNode that we saved the item into
+ * Get the type name of this item, as used in .aqua files.
+ *
+ * This allocates a string. Code that handles many items should
+ * use GetSpecies and SpeciesRegistry::GetTag instead.
+ *
+ * @return The species tag
  */
-wxXmlNode* Item::XmlSave(wxXmlNode* node)
+std::wstring Item::GetType() const
 {
-    // Create a new node for this item
-    auto itemNode = new wxXmlNode(wxXML_ELEMENT_NODE, L"item");
-
-    // Set position attributes
-    itemNode->AddAttribute(L"x", wxString::Format(L"%.6f", mX));
-    itemNode->AddAttribute(L"y", wxString::Format(L"%.6f", mY));
-
-    // Add the 'type' attribute using GetType() from the derived class
-    itemNode->AddAttribute(L"type", GetType()); // Only add 'type' here
-
-    // Attach the node to the parent node
-    node->AddChild(itemNode);
-
-    return itemNode;
+    return SpeciesRegistry::Get().GetTag(GetSpecies());
 }
 
 /**
- * Load the attributes for an item node.
+ * Copy the state of this item into a record.
  *
- * This is the  base class version that loads the attributes
- * common to all items. Override this to load custom attributes
- * for specific items.
+ * This is the base class version that saves the state common
+ * to all items. Override it to save state for specific items.
+ * The caller fills in ItemRecord::species.
  *
- * @param node The Xml node we are loading the item from
+ * @param record Record to save into
+ */
+void Item::SaveRecord(ItemRecord* record) const
+{
+    record->x = mX;
+    record->y = mY;
+}
+
+/**
+ * Restore the state of this item from a record.
+ * @param record Record to load from
  */
-void Item::XmlLoad(wxXmlNode* node)
+void Item::LoadRecord(const ItemRecord& record)
 {
-    node->GetAttribute(L"x", L"0").ToDouble(&mX);
-    node->GetAttribute(L"y", L"0").ToDouble(&mY);
-    wxString typeAttr = node->GetAttribute(L"type", L"unknown");
+    mX = record.x;
+    mY = record.y;
 }
 
 /**
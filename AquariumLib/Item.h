@@ -8,6 +8,10 @@
 #ifndef ITEM_H
 #define ITEM_H
 
+#include "SpriteLibrary.h"
+#include "ItemRecord.h"
+#include "SpeciesRegistry.h"
+
 /**
  * @class Item
  * @brief Represents an item in the aquarium.
@@ -24,14 +28,12 @@ protected:
     Item(Aquarium* aquarium, const std::wstring& filename);
 
 private:
-    /// The underlying fish image
-    std::unique_ptr<wxImage> mItemImage;
-    /// The mirrored bitmap we can display for this fish
-    std::unique_ptr<wxBitmap> mFishBitmapMirror;
+    /// The sprite we draw this item with, shared with
+    /// every other item that uses the same image
+    const Sprite* mSprite;
 
     /// The aquarium this item is contained in
     Aquarium* mAquarium;
-    /// The bitmap we can display for this fish
 
     // Item location in the aquarium
     /**
@@ -46,10 +48,9 @@ private:
      * member variable for mirror
      */
     bool mMirror = false;
-    /**
-     * member variable for bitmap
-     */
-    std::unique_ptr<wxBitmap> mFishBitmap;
+
+    /// Id the aquarium gave this item when it was added
+    uint32_t mId = 0;
 
 public:
     /// Default constructor (disabled)
@@ -74,9 +75,43 @@ public:
     double GetX() const { return mX; }
     /**
      * gets fishbitmap
-     * @return mFishBitmap.get()
+     * @return The bitmap we draw this item with
+     */
+    const wxBitmap* GetFishBitmap() const { return &mSprite->bitmap; }
+
+    /**
+     * Get the id the aquarium gave this item. Ids start at 0
+     * and are handed out in order, so they can index a bitset.
+     * @return The id
+     */
+    uint32_t GetId() const { return mId; }
+
+    /**
+     * Set the item's id. Only the aquarium should call this.
+     * @param id The id
+     */
+    void SetId(uint32_t id) { mId = id; }
+
+    /**
+     * Get the sprite this item is drawn with
+     * @return The shared sprite
      */
-    wxBitmap* GetFishBitmap() const { return mFishBitmap.get(); }
+    const Sprite* GetSprite() const { return mSprite; }
+
+    /**
+     * Get the rectangle the item is drawn in
+     * @return Bounds in pixels, centered on the item's location
+     */
+    wxRect GetBounds() const
+    {
+        return wxRect(int(mX - mSprite->width / 2.0), int(mY - mSprite->height / 2.0), mSprite->width, mSprite->height);
+    }
+
+    /**
+     * Is the item drawn mirrored?
+     * @return true if mirrored
+     */
+    bool GetMirror() const { return mMirror; }
 
     /**
      * The Y location of the item
@@ -108,6 +143,15 @@ public:
     * @return Always returns false, can be overridden in derived classes.
     */
     virtual bool IsActive() const { return false; }
+
+    /**
+     * Does this item move on its own?
+     *
+     * The view uses this to decide if it needs to keep repainting.
+     * @return Always returns false, overridden by items that animate.
+     */
+    virtual bool IsAnimated() const { return false; }
+
     bool HitTest(int x, int y);
 
     /**
@@ -118,13 +162,15 @@ public:
     }
 
     /**
-     * gets the type
-     * @return type
+     * Get the species of this item
+     * @return The species id the item class registered
      */
-    virtual std::wstring GetType() const = 0;
+    virtual SpeciesId GetSpecies() const = 0;
+
+    std::wstring GetType() const;
 
-    virtual wxXmlNode* XmlSave(wxXmlNode* node);
-    virtual void XmlLoad(wxXmlNode* node);
+    virtual void SaveRecord(ItemRecord* record) const;
+    virtual void LoadRecord(const ItemRecord& record);
     /**
    * Handle updates for animation
    * @param elapsed The time since the last update
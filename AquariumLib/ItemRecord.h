@@ -0,0 +1,76 @@
+/**
+ * @file ItemRecord.h
+ * @author Josh Thomas
+ * @brief Plain data copies of item state.
+ *
+ * Records let the aquarium be copied, saved and loaded
+ * without touching the items themselves.
+ */
+
+#ifndef ITEMRECORD_H
+#define ITEMRECORD_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ItemRecord
+ * @brief Fixed size copy of the state of one item.
+ *
+ * This is also the on-disk record of the binary .aqua format,
+ * so its layout must not change without bumping AquaBinaryVersion.
+ */
+struct ItemRecord
+{
+    /// Flag set if the item is a fish and speedX and speedY are meaningful
+    static const uint16_t Swims = 1;
+
+    /// X location in pixels
+    double x = 0;
+
+    /// Y location in pixels
+    double y = 0;
+
+    /// Speed in the X direction in pixels per second
+    double speedX = 0;
+
+    /// Speed in the Y direction in pixels per second
+    double speedY = 0;
+
+    /// Species specific state, such as behavior timers
+    double state[2] = {0, 0};
+
+    /// Index of the item's type in the snapshot species table
+    uint16_t species = 0;
+
+    /// Combination of the flags above
+    uint16_t flags = 0;
+
+    /// Padding, always zero
+    uint32_t reserved = 0;
+};
+
+static_assert(sizeof(ItemRecord) == 56, "ItemRecord is an on-disk format");
+
+/**
+ * @struct AquaSnapshot
+ * @brief A copy of every item in an aquarium, in drawing order.
+ */
+struct AquaSnapshot
+{
+    /// Type names, indexed by ItemRecord::species
+    std::vector<std::wstring> species;
+
+    /// One record per item
+    std::vector<ItemRecord> records;
+};
+
+/// Called while a snapshot is written with the number of records written so far and the total
+typedef std::function<void(size_t written, size_t total)> SnapshotProgress;
+
+/// How many records are written between calls to a SnapshotProgress
+const size_t SnapshotProgressInterval = 64 * 1024;
+
+#endif //ITEMRECORD_H
@@ -0,0 +1,55 @@
+/**
+ * @file ItemSelection.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "ItemSelection.h"
+#include <algorithm>
+
+/**
+ * Select nothing, keeping the memory for the next selection
+ */
+void ItemSelection::Clear()
+{
+    if (mCount > 0)
+    {
+        std::fill(mWords.begin(), mWords.end(), 0);
+        mCount = 0;
+    }
+}
+
+/**
+ * Select an item
+ * @param id The item's id
+ */
+void ItemSelection::Add(uint32_t id)
+{
+    auto word = id / 64;
+    if (word >= mWords.size())
+    {
+        mWords.resize(word + 1);
+    }
+
+    auto bit = uint64_t(1) << (id % 64);
+    if ((mWords[word] & bit) == 0)
+    {
+        mWords[word] |= bit;
+        mCount++;
+    }
+}
+
+/**
+ * Deselect an item
+ * @param id The item's id
+ */
+void ItemSelection::Remove(uint32_t id)
+{
+    auto word = id / 64;
+    auto bit = uint64_t(1) << (id % 64);
+    if (word < mWords.size() && (mWords[word] & bit) != 0)
+    {
+        mWords[word] &= ~bit;
+        mCount--;
+    }
+}
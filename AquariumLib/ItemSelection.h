@@ -0,0 +1,67 @@
+/**
+ * @file ItemSelection.h
+ * @author Josh Thomas
+ * @brief Header file for the ItemSelection class.
+ */
+
+#ifndef ITEMSELECTION_H
+#define ITEMSELECTION_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class ItemSelection
+ * @brief A set of items, kept as one bit per item id.
+ *
+ * Ids are handed out densely by the aquarium, so 20,000 items
+ * fit in 2.5 KB, and finding out if an item is selected while
+ * walking the aquarium is a shift and a mask. The words are
+ * kept when the selection is cleared, so selecting again with
+ * a rubber band every mouse move does not allocate.
+ */
+class ItemSelection
+{
+private:
+    /// One bit per item id, set if the item is selected
+    std::vector<uint64_t> mWords;
+
+    /// Number of bits set
+    size_t mCount = 0;
+
+public:
+    void Clear();
+    void Add(uint32_t id);
+    void Remove(uint32_t id);
+
+    /**
+     * Is an item selected?
+     * @param id The item's id
+     * @return true if selected
+     */
+    bool Contains(uint32_t id) const
+    {
+        auto word = id / 64;
+        return word < mWords.size() && (mWords[word] >> (id % 64) & 1) != 0;
+    }
+
+    /**
+     * Get the number of items selected
+     * @return Item count
+     */
+    size_t GetCount() const { return mCount; }
+
+    /**
+     * Is nothing selected?
+     * @return true if empty
+     */
+    bool IsEmpty() const { return mCount == 0; }
+
+    /**
+     * Get the memory the selection holds
+     * @return Bytes allocated
+     */
+    size_t GetMemorySize() const { return mWords.capacity() * sizeof(uint64_t); }
+};
+
+#endif //ITEMSELECTION_H
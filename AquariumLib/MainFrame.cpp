@@ -46,18 +46,37 @@ void MainFrame::Initialize()
  helpMenu->Append(wxID_ABOUT, "&About\tF1", "Show about dialog");
  fileMenu->Append(wxID_OPEN, "Open &File...\tCtrl-F", L"Open aquarium file...");
  auto fishMenu = new wxMenu();
+ auto viewMenu = new wxMenu();
 
  fishMenu->Append(IDM_ADDFISHBETA, L"&Beta Fish", L"Add a Beta Fish");
  fishMenu->Append(IDM_ADDFISHCARP, L"&Carp Fish", L"Add a Carp Fish"); // Add Carp Fish
  fishMenu->Append(IDM_ADDFISHCATFISH, L"&Catfish", L"Add a Catfish");
  fishMenu->Append(IDM_ADDDECORCASTLE, L"&Decor Castle", L"Add A DecorCastle");
+ viewMenu->AppendCheckItem(IDM_PAUSE, L"&Pause\tCtrl-P", L"Pause the aquarium");
+ viewMenu->AppendCheckItem(IDM_FRAMESTATS, L"&Frame Statistics\tCtrl-T", L"Show frame statistics over the aquarium");
+ viewMenu->Append(IDM_MEMORYUSAGE, L"&Memory Usage...", L"Show where the aquarium's memory goes");
+ viewMenu->AppendSeparator();
+ viewMenu->AppendCheckItem(IDM_RECORDINPUT, L"Record &Input", L"Record mouse input so it can be replayed with --replay");
+ viewMenu->Append(IDM_SAVEINPUT, L"Save Input Recordin&g...", L"Save the recorded mouse input");
+#ifdef AQUARIUM_TRACING
+ viewMenu->AppendSeparator();
+ viewMenu->AppendCheckItem(IDM_TRACE, L"&Record Trace", L"Record trace zones");
+ viewMenu->Append(IDM_SAVETRACE, L"Save Tra&ce...", L"Save the recorded trace for chrome://tracing or Perfetto");
+#endif
+#ifdef AQUARIUM_ALLOCATION_TRACKING
+ viewMenu->AppendCheckItem(IDM_ALLOCATIONS, L"Count &Allocations", L"Show heap allocations per frame with the frame statistics");
+#endif
 
 
  menuBar->Append(fileMenu, L"&File" );
  menuBar->Append(fishMenu, L"&Add Fish");
+ menuBar->Append(viewMenu, L"&View");
  menuBar->Append(helpMenu, L"&Help");
  SetMenuBar( menuBar );
- CreateStatusBar( 1, wxSTB_SIZEGRIP, wxID_ANY );
+ // Messages on the left, frame statistics on the right
+ CreateStatusBar( 2, wxSTB_SIZEGRIP, wxID_ANY );
+ int widths[] = {-1, -2};
+ SetStatusWidths(2, widths);
  Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnExit, this, wxID_EXIT);
  Bind(wxEVT_COMMAND_MENU_SELECTED, &MainFrame::OnAbout, this, wxID_ABOUT);
 }
@@ -0,0 +1,143 @@
+/**
+ * @file MappedFile.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <wx/msw/wrapwin.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Destructor
+ */
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+/**
+ * Map a file into memory
+ * @param filename File to map
+ * @return true if the file was opened
+ */
+bool MappedFile::Open(const wxString& filename)
+{
+    Close();
+
+#ifdef _WIN32
+    auto file = CreateFileW(filename.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    mFile = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+    {
+        Close();
+        return false;
+    }
+
+    mSize = (size_t)size.QuadPart;
+    if (mSize == 0)
+    {
+        return true;
+    }
+
+    mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    mData = (const char*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+    mFd = open(filename.fn_str(), O_RDONLY);
+    if (mFd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(mFd, &info) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    mSize = (size_t)info.st_size;
+    if (mSize == 0)
+    {
+        return true;
+    }
+
+    auto data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+    if (data == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    // We read the file front to back exactly once
+    madvise(data, mSize, MADV_SEQUENTIAL);
+    mData = (const char*)data;
+#endif
+
+    if (mData == nullptr)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Unmap and close the file
+ */
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (mData != nullptr)
+    {
+        UnmapViewOfFile(mData);
+    }
+
+    if (mMapping != nullptr)
+    {
+        CloseHandle(mMapping);
+        mMapping = nullptr;
+    }
+
+    if (mFile != nullptr)
+    {
+        CloseHandle(mFile);
+        mFile = nullptr;
+    }
+#else
+    if (mData != nullptr)
+    {
+        munmap((void*)mData, mSize);
+    }
+
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+#endif
+
+    mData = nullptr;
+    mSize = 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file MappedFile.h
+ * @author Josh Thomas
+ * @brief Header file for the MappedFile class.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+/**
+ * @class MappedFile
+ * @brief A file mapped read-only into memory.
+ *
+ * The contents are paged in by the operating system as they
+ * are touched, so nothing is copied into a buffer of our own.
+ */
+class MappedFile
+{
+private:
+    /// Start of the mapped file, nullptr if not open or empty
+    const char* mData = nullptr;
+
+    /// Size of the file in bytes
+    size_t mSize = 0;
+
+#ifdef _WIN32
+    /// Windows file handle
+    void* mFile = nullptr;
+
+    /// Windows file mapping handle
+    void* mMapping = nullptr;
+#else
+    /// File descriptor
+    int mFd = -1;
+#endif
+
+public:
+    MappedFile() = default;
+
+    /// Copy constructor (disabled)
+    MappedFile(const MappedFile&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    bool Open(const wxString& filename);
+    void Close();
+
+    /**
+     * Get the mapped contents
+     * @return Pointer to the first byte, nullptr if the file is empty
+     */
+    const char* GetData() const { return mData; }
+
+    /**
+     * Get the size of the file
+     * @return Size in bytes
+     */
+    size_t GetSize() const { return mSize; }
+};
+
+#endif //MAPPEDFILE_H
@@ -0,0 +1,63 @@
+/**
+ * @file MemoryReport.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "MemoryReport.h"
+
+/**
+ * Format a byte count for people to read
+ * @param bytes Number of bytes
+ * @return Text like "512 B", "3.2 KB" or "1.50 GB"
+ */
+wxString MemoryReport::FormatBytes(double bytes)
+{
+    const wchar_t* units[] = {L"B", L"KB", L"MB", L"GB", L"TB"};
+    int unit = 0;
+    while (bytes >= 1024 && unit < 4)
+    {
+        bytes /= 1024;
+        unit++;
+    }
+
+    if (unit == 0)
+    {
+        return wxString::Format(L"%.0f %s", bytes, units[unit]);
+    }
+
+    return wxString::Format(bytes < 10 ? L"%.2f %s" : L"%.1f %s", bytes, units[unit]);
+}
+
+/**
+ * Format the whole report, one line per category and species
+ * @return The report
+ */
+wxString MemoryReport::Format() const
+{
+    auto text = wxString::Format(L"Total %s\n", FormatBytes((double)GetTotal()));
+    text += wxString::Format(L"  Sprites     %s\n", FormatBytes((double)sprites));
+    text += wxString::Format(L"  Entities    %s\n", FormatBytes((double)entities));
+    for (const auto& memory : species)
+    {
+        text += wxString::Format(L"    %-10s %s (%llu x %llu B)\n", memory.tag.c_str(), FormatBytes((double)memory.bytes),
+                                 (unsigned long long)memory.count, (unsigned long long)memory.itemBytes);
+    }
+
+    text += wxString::Format(L"  Containers  %s\n", FormatBytes((double)containers));
+    text += wxString::Format(L"  Caches      %s\n", FormatBytes((double)GetCacheTotal()));
+    text += wxString::Format(L"    Atlas      %s\n", FormatBytes((double)atlas));
+    text += wxString::Format(L"    Draw list  %s\n", FormatBytes((double)drawList));
+    text += wxString::Format(L"    Pack       %s (mapped)\n", FormatBytes((double)pack));
+    return text;
+}
+
+/**
+ * Format the report on one line, for the status bar
+ * @return Text like "Mem 12.3 MB (items 4.1 MB)"
+ */
+wxString MemoryReport::FormatSummary() const
+{
+    return wxString::Format(L"Mem %s (items %s)", FormatBytes((double)GetTotal()),
+                            FormatBytes((double)(entities + containers)));
+}
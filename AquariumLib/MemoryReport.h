@@ -0,0 +1,92 @@
+/**
+ * @file MemoryReport.h
+ * @author Josh Thomas
+ * @brief Header file for the MemoryReport struct.
+ */
+
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Estimated bytes of the control block make_shared puts in front
+ * of every item: its vtable pointer and the two reference counts.
+ */
+const size_t SharedControlBytes = sizeof(void*) + 2 * sizeof(int);
+
+/// Estimated bytes per pixel of a wxBitmap, which is held as 32 bit RGBA
+const size_t BitmapPixelBytes = 4;
+
+/**
+ * @struct SpeciesMemory
+ * @brief What the items of one species cost.
+ */
+struct SpeciesMemory
+{
+    /// Species tag, as saved in .aqua files
+    std::wstring tag;
+
+    /// Number of items of the species
+    size_t count = 0;
+
+    /// Bytes of one item, including its shared_ptr control block
+    size_t itemBytes = 0;
+
+    /// Bytes of every item of the species
+    size_t bytes = 0;
+};
+
+/**
+ * @struct MemoryReport
+ * @brief Where an aquarium's memory goes.
+ *
+ * Filled in by Aquarium::GetMemoryReport. Sizes are estimates from
+ * object sizes and container capacities, not measured from the heap,
+ * so they can be taken cheaply at any time and scale predictably
+ * with the number of items. Allocator overhead is not included.
+ */
+struct MemoryReport
+{
+    /// Entity memory of each species that has items
+    std::vector<SpeciesMemory> species;
+
+    /// Decoded sprite pixels: images kept for hit testing and their bitmaps
+    size_t sprites = 0;
+
+    /// Item objects and their shared_ptr control blocks
+    size_t entities = 0;
+
+    /// The item list, sprite tables and other bookkeeping
+    size_t containers = 0;
+
+    /// Cache: the sprite atlas pages
+    size_t atlas = 0;
+
+    /// Cache: the retained draw list and its scratch space
+    size_t drawList = 0;
+
+    /// Cache: the memory mapped sprite pack. Backed by the file,
+    /// so the system can drop its pages under memory pressure.
+    size_t pack = 0;
+
+    /**
+     * Get the bytes held in caches
+     * @return Atlas, draw list and sprite pack together
+     */
+    size_t GetCacheTotal() const { return atlas + drawList + pack; }
+
+    /**
+     * Get the bytes of everything in the report
+     * @return Total bytes
+     */
+    size_t GetTotal() const { return sprites + entities + containers + GetCacheTotal(); }
+
+    wxString Format() const;
+    wxString FormatSummary() const;
+
+    static wxString FormatBytes(double bytes);
+};
+
+#endif //MEMORYREPORT_H
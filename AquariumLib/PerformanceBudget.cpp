@@ -0,0 +1,168 @@
+/**
+ * @file PerformanceBudget.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "PerformanceBudget.h"
+#include <wx/filefn.h>
+#include <wx/textfile.h>
+
+using namespace std;
+
+/// Name of the line in a baseline file that sets the tolerance
+const std::string ToleranceName = "tolerance";
+
+/**
+ * Read budgets from a baseline file, adding to any already set
+ * @param filename The baseline file
+ * @return false if the file could not be read or has a bad line
+ */
+bool PerformanceBudget::Load(const wxString& filename)
+{
+    wxTextFile file;
+    if (!wxFileExists(filename) || !file.Open(filename))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < file.GetLineCount(); i++)
+    {
+        auto line = file[i];
+        line.Trim(true).Trim(false);
+        if (line.IsEmpty() || line.StartsWith(L"#"))
+        {
+            continue;
+        }
+
+        auto name = line.BeforeFirst(L' ');
+        auto text = line.AfterFirst(L' ').Trim(false);
+        double value;
+        if (name.IsEmpty() || !text.ToCDouble(&value))
+        {
+            return false;
+        }
+
+        auto key = name.ToStdString();
+        if (key == ToleranceName)
+        {
+            mTolerance = value;
+        }
+        else
+        {
+            mBudgets[key] = value;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Set the budget for a measurement
+ * @param name Name of the measurement
+ * @param budget Largest value it should have
+ */
+void PerformanceBudget::SetBudget(const std::string& name, double budget)
+{
+    mBudgets[name] = budget;
+}
+
+/**
+ * Get the budget for a measurement
+ * @param name Name of the measurement
+ * @return The budget, or -1 if the measurement has none
+ */
+double PerformanceBudget::GetBudget(const std::string& name) const
+{
+    auto budget = mBudgets.find(name);
+    return budget != mBudgets.end() ? budget->second : -1;
+}
+
+/**
+ * Would a value be over the budget for a measurement,
+ * once the tolerance is allowed for?
+ * @param name Name of the measurement
+ * @param value The value
+ * @return true if over budget. Measurements without a budget never are.
+ */
+bool PerformanceBudget::IsOverBudget(const std::string& name, double value) const
+{
+    auto budget = GetBudget(name);
+    return budget >= 0 && value > budget * (1 + mTolerance);
+}
+
+/**
+ * Record a measurement
+ * @param name Name of the measurement
+ * @param value The measured value
+ * @return true if it is within its budget
+ */
+bool PerformanceBudget::Measure(const std::string& name, double value)
+{
+    mMeasurements.push_back({name, value});
+    return !IsOverBudget(name, value);
+}
+
+/**
+ * Is every measurement so far within its budget?
+ * @return true if nothing is over budget
+ */
+bool PerformanceBudget::IsWithinBudget() const
+{
+    for (const auto& measurement : mMeasurements)
+    {
+        if (IsOverBudget(measurement.name, measurement.value))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Format a table comparing every measurement with its budget
+ * @return One line per measurement, over budget ones marked OVER
+ */
+wxString PerformanceBudget::FormatDiff() const
+{
+    auto text = wxString::Format(L"%-20s %14s %14s %9s\n", L"measurement", L"budget", L"measured", L"change");
+    for (const auto& measurement : mMeasurements)
+    {
+        wxString name(measurement.name);
+        auto budget = GetBudget(measurement.name);
+        auto measured = wxString::Format(L"%.6g", measurement.value);
+        if (budget < 0)
+        {
+            text += wxString::Format(L"%-20s %14s %14s %9s  no budget\n", name, L"-", measured, L"-");
+            continue;
+        }
+
+        wxString change = L"-";
+        if (budget > 0)
+        {
+            change = wxString::Format(L"%+.1f%%", (measurement.value - budget) / budget * 100);
+        }
+
+        text += wxString::Format(L"%-20s %14s %14s %9s  %s\n", name, wxString::Format(L"%.6g", budget), measured,
+                                 change, IsOverBudget(measurement.name, measurement.value) ? L"OVER" : L"ok");
+    }
+
+    return text;
+}
+
+/**
+ * Format the measurements as a baseline file, to
+ * replace the old one after an intended change
+ * @return Contents for a baseline file
+ */
+wxString PerformanceBudget::FormatBaseline() const
+{
+    auto text = wxString::Format(L"%s %g\n", wxString(ToleranceName), mTolerance);
+    for (const auto& measurement : mMeasurements)
+    {
+        text += wxString::Format(L"%s %.6g\n", wxString(measurement.name), measurement.value);
+    }
+
+    return text;
+}
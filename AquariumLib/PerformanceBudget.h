@@ -0,0 +1,79 @@
+/**
+ * @file PerformanceBudget.h
+ * @author Josh Thomas
+ * @brief Header file for the PerformanceBudget class.
+ */
+
+#ifndef PERFORMANCEBUDGET_H
+#define PERFORMANCEBUDGET_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/// Fraction a measurement may go over its budget before it fails
+const double DefaultBudgetTolerance = 0.25;
+
+/**
+ * @class PerformanceBudget
+ * @brief Budgets for named measurements, read from a baseline file.
+ *
+ * A baseline file has one budget per line, a name and a value
+ * separated by spaces. Lines starting with # are comments. The
+ * special name "tolerance" sets the fraction a measurement may
+ * exceed its budget by:
+ *
+ *     tolerance 0.25
+ *     update_ms 1500
+ *     update_allocs 0
+ *
+ * A budget of 0 allows nothing, whatever the tolerance.
+ */
+class PerformanceBudget
+{
+private:
+    /**
+     * A value measured against the budget
+     */
+    struct Measurement
+    {
+        /// Name of the measurement
+        std::string name;
+
+        /// The measured value
+        double value;
+    };
+
+    /// Budget for each name
+    std::map<std::string, double> mBudgets;
+
+    /// Fraction a measurement may exceed its budget by
+    double mTolerance = DefaultBudgetTolerance;
+
+    /// Everything measured, in the order it was measured
+    std::vector<Measurement> mMeasurements;
+
+public:
+    bool Load(const wxString& filename);
+    void SetBudget(const std::string& name, double budget);
+    double GetBudget(const std::string& name) const;
+    bool Measure(const std::string& name, double value);
+    bool IsOverBudget(const std::string& name, double value) const;
+    bool IsWithinBudget() const;
+    wxString FormatDiff() const;
+    wxString FormatBaseline() const;
+
+    /**
+     * Set how far a measurement may exceed its budget
+     * @param tolerance Fraction of the budget, 0.25 allows 25% over
+     */
+    void SetTolerance(double tolerance) { mTolerance = tolerance; }
+
+    /**
+     * Get how far a measurement may exceed its budget
+     * @return Fraction of the budget
+     */
+    double GetTolerance() const { return mTolerance; }
+};
+
+#endif //PERFORMANCEBUDGET_H
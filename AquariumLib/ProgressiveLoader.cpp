@@ -0,0 +1,320 @@
+/**
+ * @file ProgressiveLoader.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "ProgressiveLoader.h"
+#include "AquaBinary.h"
+#include "AquaXmlReader.h"
+#include "EditJournal.h"
+#include "MappedFile.h"
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+wxDEFINE_EVENT(EVT_LOAD_PROGRESS, wxThreadEvent);
+
+/**
+ * Destructor. Stops any load in progress.
+ */
+ProgressiveLoader::~ProgressiveLoader()
+{
+    Cancel();
+}
+
+/**
+ * Can a file be loaded progressively?
+ * @param filename File to check
+ * @return false for autosave journals, which must be loaded all at once
+ */
+bool ProgressiveLoader::CanLoad(const wxString& filename)
+{
+    MappedFile file;
+    return !file.Open(filename) || !EditJournal::IsJournal(file.GetData(), file.GetSize());
+}
+
+/**
+ * Start loading a file. Anything still waiting from an earlier load is discarded.
+ * @param filename File to load
+ * @return false if a load is already running
+ */
+bool ProgressiveLoader::Start(const wxString& filename)
+{
+    if (mBusy)
+    {
+        return false;
+    }
+
+    // Reap the last load, which has already finished
+    Cancel();
+
+    mReady = AquaSnapshot();
+    mTaken = 0;
+    mNotified = false;
+    mFailed = false;
+    mPercent = 0;
+
+    mBusy = true;
+    mThread = thread(&ProgressiveLoader::Run, this, filename.ToStdWstring());
+    return true;
+}
+
+/**
+ * Stop any load in progress and wait for the worker to finish
+ */
+void ProgressiveLoader::Cancel()
+{
+    // Wake the worker if it is waiting for room
+    {
+        lock_guard<mutex> lock(mMutex);
+        mCancel = true;
+    }
+    mRoom.notify_all();
+
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+    mCancel = false;
+}
+
+/**
+ * Is there anything left to load?
+ * @return true while the worker is running or records are waiting to be taken
+ */
+bool ProgressiveLoader::IsLoading()
+{
+    if (mBusy)
+    {
+        return true;
+    }
+
+    lock_guard<mutex> lock(mMutex);
+    return mTaken < mReady.records.size();
+}
+
+/**
+ * Take the next batch of records.
+ *
+ * The species table only ever grows during a load, so it is only
+ * copied into the batch when it has grown since the batch last had
+ * it. Pass the same batch each time, emptied when a load starts.
+ *
+ * @param max Most records to take
+ * @param batch Receives the species table and the records
+ * @return Number of records taken
+ */
+size_t ProgressiveLoader::Take(size_t max, AquaSnapshot* batch)
+{
+    size_t count;
+    {
+        lock_guard<mutex> lock(mMutex);
+        mNotified = false;
+
+        count = min(max, mReady.records.size() - mTaken);
+        if (batch->species.size() != mReady.species.size())
+        {
+            batch->species = mReady.species;
+        }
+        batch->records.assign(mReady.records.begin() + mTaken, mReady.records.begin() + mTaken + count);
+
+        mTaken += count;
+        if (mTaken == mReady.records.size())
+        {
+            mReady.records.clear();
+            mTaken = 0;
+        }
+    }
+
+    if (count > 0)
+    {
+        mRoom.notify_one();
+    }
+
+    return count;
+}
+
+/**
+ * The worker thread
+ * @param filename File to load
+ */
+void ProgressiveLoader::Run(std::wstring filename)
+{
+    bool ok;
+    bool compressed = false;
+    {
+        MappedFile file;
+        if (file.Open(filename) && AquaBinary::IsBinary(file.GetData(), file.GetSize()))
+        {
+            ok = ReadBinary(file);
+        }
+        else
+        {
+            compressed = file.GetData() != nullptr && AquaXmlReader::IsCompressed(file.GetData(), file.GetSize());
+            file.Close();
+            ok = ReadXml(filename, compressed);
+        }
+    }
+
+    mFailed = !ok && !mCancel;
+    mPercent = 100;
+    mBusy = false;
+
+    // Always wake the view, so it sees we are done
+    {
+        lock_guard<mutex> lock(mMutex);
+        mNotified = true;
+    }
+    Notify();
+}
+
+/**
+ * Read a mapped binary .aqua file
+ * @param file The mapped file
+ * @return false if the file is not valid or we were cancelled
+ */
+bool ProgressiveLoader::ReadBinary(const MappedFile& file)
+{
+    vector<wstring> species;
+    const ItemRecord* records;
+    size_t count;
+    if (!AquaBinary::Read(file, &species, &records, &count))
+    {
+        return false;
+    }
+
+    vector<ItemRecord> batch;
+    for (size_t first = 0; first < count; first += BatchSize)
+    {
+        auto end = min(first + BatchSize, count);
+        for (auto i = first; i < end; i++)
+        {
+            if (records[i].species >= species.size())
+            {
+                return false;
+            }
+        }
+
+        batch.assign(records + first, records + end);
+        if (!Deliver(species, &batch, (int)(end * 100 / count)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Read an XML file, possibly gzip compressed
+ * @param filename File to read
+ * @param compressed True if the file is gzip compressed
+ * @return false if the file is not valid or we were cancelled
+ */
+bool ProgressiveLoader::ReadXml(const wxString& filename, bool compressed)
+{
+    wxFFileInputStream fileStream(filename);
+    if (!fileStream.IsOk())
+    {
+        return false;
+    }
+
+    unique_ptr<wxZlibInputStream> decompressor;
+    wxInputStream* stream = &fileStream;
+    if (compressed)
+    {
+        decompressor = make_unique<wxZlibInputStream>(fileStream, wxZLIB_GZIP);
+        stream = decompressor.get();
+    }
+
+    auto length = max((wxFileOffset)fileStream.GetLength(), (wxFileOffset)1);
+
+    vector<wstring> species;
+    unordered_map<wstring, uint16_t> speciesIndex;
+    vector<ItemRecord> batch;
+    AquaXmlReader reader;
+    bool ok = reader.Read(*stream, [&](wxXmlNode* node) {
+        auto type = node->GetAttribute(L"type").ToStdWstring();
+        auto found = speciesIndex.find(type);
+        if (found == speciesIndex.end())
+        {
+            found = speciesIndex.emplace(type, (uint16_t)species.size()).first;
+            species.push_back(type);
+        }
+
+        ItemRecord record;
+        record.species = found->second;
+        AquaXmlReader::ReadRecord(node, &record);
+        batch.push_back(record);
+
+        if (batch.size() >= BatchSize &&
+            !Deliver(species, &batch, (int)min<wxFileOffset>(fileStream.TellI() * 100 / length, 99)))
+        {
+            reader.Stop();
+        }
+    });
+
+    return ok && Deliver(species, &batch, 100);
+}
+
+/**
+ * Hand a batch of records over to the UI thread.
+ *
+ * If MaxReady records are already waiting, this waits for the UI
+ * to take some, so a slow UI does not leave the whole file in memory.
+ *
+ * @param species Species table the records index
+ * @param records Records to hand over, cleared
+ * @param percent How far through the file we are
+ * @return false if we have been cancelled
+ */
+bool ProgressiveLoader::Deliver(const std::vector<std::wstring>& species, std::vector<ItemRecord>* records,
+                                int percent)
+{
+    bool notify;
+    {
+        unique_lock<mutex> lock(mMutex);
+        mRoom.wait(lock, [this] { return mReady.records.size() - mTaken < MaxReady || mCancel; });
+        if (mCancel)
+        {
+            return false;
+        }
+
+        // Drop what has been taken, so mReady holds no more than it must
+        mReady.records.erase(mReady.records.begin(), mReady.records.begin() + mTaken);
+        mTaken = 0;
+
+        if (mReady.species.size() != species.size())
+        {
+            mReady.species = species;
+        }
+
+        mReady.records.insert(mReady.records.end(), records->begin(), records->end());
+        notify = !mNotified;
+        mNotified = true;
+    }
+
+    records->clear();
+    mPercent = percent;
+    if (notify)
+    {
+        Notify();
+    }
+
+    return !mCancel;
+}
+
+/**
+ * Send a progress event to the handler
+ */
+void ProgressiveLoader::Notify()
+{
+    if (mHandler != nullptr)
+    {
+        wxQueueEvent(mHandler, new wxThreadEvent(EVT_LOAD_PROGRESS));
+    }
+}
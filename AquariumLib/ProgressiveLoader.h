@@ -0,0 +1,122 @@
+/**
+ * @file ProgressiveLoader.h
+ * @author Josh Thomas
+ * @brief Header file for the ProgressiveLoader class.
+ */
+
+#ifndef PROGRESSIVELOADER_H
+#define PROGRESSIVELOADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ItemRecord.h"
+
+class MappedFile;
+
+/// Sent when a progressive load has more items ready, or has finished
+wxDECLARE_EVENT(EVT_LOAD_PROGRESS, wxThreadEvent);
+
+/**
+ * @class ProgressiveLoader
+ * @brief Reads a .aqua file on a worker thread, a batch at a time.
+ *
+ * The worker parses XML, compressed XML or binary files into plain
+ * ItemRecords. Items themselves hold wx bitmaps, which may only be
+ * made on the UI thread, so the UI takes the records a batch at a time
+ * with Take and builds the items with Aquarium::AddRecords. The items
+ * loaded so far can be drawn and clicked while the rest arrive.
+ *
+ * Records from XML hold the attributes Item and Fish save: location,
+ * and speed for fish. Autosave journals must be replayed in order and
+ * are not loaded this way; CanLoad says which files are.
+ */
+class ProgressiveLoader
+{
+private:
+    /// Records the worker collects before handing them over
+    static const size_t BatchSize = 1024;
+
+    /// Most records left waiting for the UI before the worker waits too
+    static const size_t MaxReady = 64 * BatchSize;
+
+    /// The worker thread
+    std::thread mThread;
+
+    /// Protects the members below it
+    std::mutex mMutex;
+
+    /// Records read but not yet taken, from mTaken on.
+    /// The species table only ever grows.
+    AquaSnapshot mReady;
+
+    /// Index of the first record in mReady not yet taken
+    size_t mTaken = 0;
+
+    /// True if a progress event has been sent and not yet acted on
+    bool mNotified = false;
+
+    /// Signalled when the UI takes records, making room for more
+    std::condition_variable mRoom;
+
+    /// True while the worker is running
+    std::atomic<bool> mBusy{false};
+
+    /// Set to ask the worker to stop
+    std::atomic<bool> mCancel{false};
+
+    /// True if the last load failed part way
+    std::atomic<bool> mFailed{false};
+
+    /// How far through the file the worker is, 0 to 100
+    std::atomic<int> mPercent{0};
+
+    /// Handler that receives our events, may be nullptr
+    wxEvtHandler* mHandler = nullptr;
+
+    void Run(std::wstring filename);
+    bool ReadBinary(const MappedFile& file);
+    bool ReadXml(const wxString& filename, bool compressed);
+    bool Deliver(const std::vector<std::wstring>& species, std::vector<ItemRecord>* records, int percent);
+    void Notify();
+
+public:
+    ProgressiveLoader() = default;
+
+    /// Copy constructor (disabled)
+    ProgressiveLoader(const ProgressiveLoader&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const ProgressiveLoader&) = delete;
+
+    ~ProgressiveLoader();
+
+    /**
+     * Set the handler that receives progress events
+     * @param handler Event handler, usually the view
+     */
+    void SetHandler(wxEvtHandler* handler) { mHandler = handler; }
+
+    static bool CanLoad(const wxString& filename);
+
+    bool Start(const wxString& filename);
+    void Cancel();
+    bool IsLoading();
+    size_t Take(size_t max, AquaSnapshot* batch);
+
+    /**
+     * How far through the file has the worker read?
+     * @return Percent complete
+     */
+    int GetPercent() const { return mPercent; }
+
+    /**
+     * Did the last load stop part way because the file is bad?
+     * @return true if it failed
+     */
+    bool Failed() const { return mFailed; }
+};
+
+#endif //PROGRESSIVELOADER_H
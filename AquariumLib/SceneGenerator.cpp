@@ -0,0 +1,234 @@
+/**
+ * @file SceneGenerator.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "SceneGenerator.h"
+#include "Aquarium.h"
+#include "SpeciesRegistry.h"
+#include <algorithm>
+
+using namespace std;
+
+/// Fraction of the tank's smaller side a school is spread over
+const double ClusterSpread = 0.05;
+
+/// Fraction of the tank's width and height the corner layout uses
+const double CornerSize = 0.1;
+
+/**
+ * Set how many items of a species the scene has
+ * @param tag Species tag, such as "beta"
+ * @param count Number of items, 0 to leave the species out
+ */
+void SceneGenerator::SetCount(const std::wstring& tag, int count)
+{
+    for (auto& species : mCounts)
+    {
+        if (species.tag == tag)
+        {
+            species.count = count;
+            return;
+        }
+    }
+
+    mCounts.push_back({tag, count});
+}
+
+/**
+ * Get how many items of a species the scene has
+ * @param tag Species tag
+ * @return Number of items
+ */
+int SceneGenerator::GetCount(const std::wstring& tag) const
+{
+    for (const auto& species : mCounts)
+    {
+        if (species.tag == tag)
+        {
+            return species.count;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Get the number of items in the scene
+ * @return Total over every species
+ */
+int SceneGenerator::GetTotal() const
+{
+    int total = 0;
+    for (const auto& species : mCounts)
+    {
+        total += species.count;
+    }
+
+    return total;
+}
+
+/**
+ * Set the counts from a command line style description
+ * such as "beta=100,carp=50,castle=2"
+ * @param spec The description
+ * @return false if it names an unknown species or has a bad count
+ */
+bool SceneGenerator::Parse(const wxString& spec)
+{
+    auto& registry = SpeciesRegistry::Get();
+
+    wxString rest = spec;
+    while (!rest.IsEmpty())
+    {
+        auto entry = rest.BeforeFirst(L',');
+        rest = rest.AfterFirst(L',');
+
+        auto tag = entry.BeforeFirst(L'=').Trim(true).Trim(false).ToStdWstring();
+        long count;
+        if (registry.Find(tag) == UnknownSpecies || !entry.AfterFirst(L'=').ToLong(&count) || count < 0)
+        {
+            return false;
+        }
+
+        SetCount(tag, (int)count);
+    }
+
+    return true;
+}
+
+/**
+ * Get a layout from its name
+ * @param name "uniform", "clustered" or "corner"
+ * @param layout Receives the layout
+ * @return false if the name is not a layout
+ */
+bool SceneGenerator::ParseLayout(const wxString& name, SceneLayout* layout)
+{
+    auto lower = name.Lower();
+    if (lower == L"uniform")
+    {
+        *layout = SceneLayout::Uniform;
+    }
+    else if (lower == L"clustered")
+    {
+        *layout = SceneLayout::Clustered;
+    }
+    else if (lower == L"corner")
+    {
+        *layout = SceneLayout::Corner;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Add the scene's items to an aquarium.
+ *
+ * Seeds the aquarium's generator first, so the items
+ * and everything they do afterwards are reproducible.
+ *
+ * @param aquarium Aquarium to add to, usually empty
+ * @return The items, in the order they were added
+ */
+std::vector<std::shared_ptr<Item>> SceneGenerator::Generate(Aquarium* aquarium) const
+{
+    aquarium->Seed(mSeed);
+
+    double width = mWidth > 0 ? mWidth : aquarium->GetWidth();
+    double height = mHeight > 0 ? mHeight : aquarium->GetHeight();
+
+    auto& registry = SpeciesRegistry::Get();
+    vector<SpeciesId> species;
+    vector<int> remaining;
+    for (const auto& count : mCounts)
+    {
+        auto id = registry.Find(count.tag);
+        if (id != UnknownSpecies && count.count > 0)
+        {
+            species.push_back(id);
+            remaining.push_back(count.count);
+        }
+    }
+
+    // Schools are centred away from the edges, so they are not cut off
+    vector<pair<double, double>> centres;
+    for (int i = 0; i < max(mClusters, 1); i++)
+    {
+        auto x = aquarium->Random(width * 0.1, width * 0.9);
+        auto y = aquarium->Random(height * 0.1, height * 0.9);
+        centres.push_back({x, y});
+    }
+
+    double spread = max(min(width, height) * ClusterSpread, 1.0);
+
+    vector<shared_ptr<Item>> items;
+    items.reserve(GetTotal());
+
+    // Take one of each species in turn until they run out
+    bool added = true;
+    while (added)
+    {
+        added = false;
+        for (size_t s = 0; s < species.size(); s++)
+        {
+            if (remaining[s] == 0)
+            {
+                continue;
+            }
+
+            auto item = registry.Create(species[s], aquarium);
+            remaining[s]--;
+            added = true;
+            if (item == nullptr)
+            {
+                continue;
+            }
+
+            double x, y;
+            switch (mLayout)
+            {
+            case SceneLayout::Clustered:
+            {
+                const auto& centre = centres[items.size() % centres.size()];
+                x = clamp(centre.first + aquarium->RandomNormal(spread), 0.0, width);
+                y = clamp(centre.second + aquarium->RandomNormal(spread), 0.0, height);
+                break;
+            }
+
+            case SceneLayout::Corner:
+                x = aquarium->Random(0, width * CornerSize);
+                y = aquarium->Random(0, height * CornerSize);
+                break;
+
+            default:
+                x = aquarium->Random(0, width);
+                y = aquarium->Random(0, height);
+                break;
+            }
+
+            item->SetLocation(x, y);
+            aquarium->Add(item);
+            items.push_back(item);
+        }
+    }
+
+    return items;
+}
+
+/**
+ * Generate the scene and save it as a .aqua file
+ * @param filename File to write, .aqua.gz to compress it
+ * @return false if the file was not written
+ */
+bool SceneGenerator::Export(const wxString& filename) const
+{
+    Aquarium aquarium;
+    Generate(&aquarium);
+    return aquarium.Save(filename);
+}
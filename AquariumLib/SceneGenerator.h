@@ -0,0 +1,126 @@
+/**
+ * @file SceneGenerator.h
+ * @author Josh Thomas
+ * @brief Header file for the SceneGenerator class.
+ */
+
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Aquarium;
+class Item;
+
+/// Seed used when none is given, the same one the tests use
+const unsigned int DefaultSceneSeed = 1238197374;
+
+/**
+ * How the items of a generated scene are spread over the tank
+ */
+enum class SceneLayout
+{
+    Uniform,    ///< Anywhere in the tank with equal chance
+    Clustered,  ///< Gathered in a few tight schools
+    Corner      ///< All piled into the top left corner, the worst case for overlap
+};
+
+/**
+ * @class SceneGenerator
+ * @brief Builds reproducible aquariums for tests, benchmarks and profiling.
+ *
+ * A scene is a count for each species tag, a layout and a seed.
+ * The same scene always builds the same aquarium, down to the speed
+ * of every fish, so workloads can be shared and scaled up. The numbers
+ * come from Aquarium::Random rather than the standard distributions,
+ * so this holds across standard libraries as well.
+ *
+ * Species are interleaved, so every species is spread through the
+ * drawing order instead of being drawn in one block.
+ */
+class SceneGenerator
+{
+private:
+    /**
+     * Number of items to make of one species
+     */
+    struct SpeciesCount
+    {
+        /// Species tag, as saved in .aqua files
+        std::wstring tag;
+
+        /// Number of items
+        int count;
+    };
+
+    /// Seed for the aquarium's random number generator
+    unsigned int mSeed = DefaultSceneSeed;
+
+    /// The species, in the order they are interleaved
+    std::vector<SpeciesCount> mCounts;
+
+    /// How items are spread over the tank
+    SceneLayout mLayout = SceneLayout::Uniform;
+
+    /// Width of the area items are placed in, 0 for the aquarium's width
+    int mWidth = 0;
+
+    /// Height of the area items are placed in, 0 for the aquarium's height
+    int mHeight = 0;
+
+    /// Number of schools in the clustered layout
+    int mClusters = 4;
+
+public:
+    void SetCount(const std::wstring& tag, int count);
+    int GetCount(const std::wstring& tag) const;
+    int GetTotal() const;
+    bool Parse(const wxString& spec);
+
+    std::vector<std::shared_ptr<Item>> Generate(Aquarium* aquarium) const;
+    bool Export(const wxString& filename) const;
+
+    static bool ParseLayout(const wxString& name, SceneLayout* layout);
+
+    /**
+     * Set the seed that makes the scene
+     * @param seed The seed
+     */
+    void SetSeed(unsigned int seed) { mSeed = seed; }
+
+    /**
+     * Get the seed that makes the scene
+     * @return The seed
+     */
+    unsigned int GetSeed() const { return mSeed; }
+
+    /**
+     * Set how items are spread over the tank
+     * @param layout The layout
+     */
+    void SetLayout(SceneLayout layout) { mLayout = layout; }
+
+    /**
+     * Get how items are spread over the tank
+     * @return The layout
+     */
+    SceneLayout GetLayout() const { return mLayout; }
+
+    /**
+     * Set the size of the area items are placed in.
+     * 0 uses the size of the aquarium.
+     * @param width Width in pixels
+     * @param height Height in pixels
+     */
+    void SetSize(int width, int height) { mWidth = width; mHeight = height; }
+
+    /**
+     * Set the number of schools in the clustered layout
+     * @param clusters Number of schools, at least 1
+     */
+    void SetClusters(int clusters) { mClusters = clusters; }
+};
+
+#endif //SCENEGENERATOR_H
@@ -0,0 +1,142 @@
+/**
+ * @file SpatialGrid.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "SpatialGrid.h"
+#include "Item.h"
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+/**
+ * Bin every item by where it is now.
+ *
+ * The grid is a snapshot. It has to be built again
+ * once the items move.
+ *
+ * @param items The items, each with its own id
+ */
+void SpatialGrid::Build(const vector<shared_ptr<Item>>& items)
+{
+    mEntries.resize(items.size());
+    mCellOf.resize(items.size());
+    mMaxWidth = 0;
+    mMaxHeight = 0;
+    if (items.empty())
+    {
+        mColumns = 0;
+        mRows = 0;
+        mStarts.assign(1, 0);
+        return;
+    }
+
+    // The grid covers the items' centers
+    int left = INT_MAX;
+    int top = INT_MAX;
+    int right = INT_MIN;
+    int bottom = INT_MIN;
+    for (const auto& item : items)
+    {
+        auto bounds = item->GetBounds();
+        int x = bounds.x + bounds.width / 2;
+        int y = bounds.y + bounds.height / 2;
+        left = min(left, x);
+        top = min(top, y);
+        right = max(right, x);
+        bottom = max(bottom, y);
+        mMaxWidth = max(mMaxWidth, bounds.width);
+        mMaxHeight = max(mMaxHeight, bounds.height);
+    }
+
+    mLeft = left;
+    mTop = top;
+    mColumns = min((right - left) / GridCellSize + 1, MaxGridCells);
+    mRows = min((bottom - top) / GridCellSize + 1, MaxGridCells);
+
+    // Count the items in each cell, then turn the counts into starts
+    mStarts.assign((size_t)mColumns * mRows + 1, 0);
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        auto bounds = items[i]->GetBounds();
+        auto cell = (uint32_t)(Row(bounds.y + bounds.height / 2) * mColumns + Column(bounds.x + bounds.width / 2));
+        mCellOf[i] = cell;
+        mStarts[cell + 1]++;
+    }
+
+    for (size_t cell = 1; cell < mStarts.size(); cell++)
+    {
+        mStarts[cell] += mStarts[cell - 1];
+    }
+
+    // Place each item after the ones already in its cell. This
+    // walks each cell's start up to the next cell's start...
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        auto& entry = mEntries[mStarts[mCellOf[i]]++];
+        entry.bounds = items[i]->GetBounds();
+        entry.id = items[i]->GetId();
+    }
+
+    // ...so shifting them down one cell puts them back
+    for (size_t cell = mStarts.size() - 1; cell > 0; cell--)
+    {
+        mStarts[cell] = mStarts[cell - 1];
+    }
+    mStarts[0] = 0;
+}
+
+/**
+ * Find the items whose bounds overlap a rectangle
+ * @param rect Rectangle in pixels
+ * @param ids Receives the ids of the items, in no particular order
+ */
+void SpatialGrid::Query(const wxRect& rect, vector<uint32_t>* ids) const
+{
+    if (rect.IsEmpty() || mEntries.empty())
+    {
+        return;
+    }
+
+    // An item can overlap the rectangle with its center up
+    // to half its size outside it
+    int first = Column(rect.x - mMaxWidth / 2 - 1);
+    int last = Column(rect.x + rect.width + mMaxWidth / 2 + 1);
+    int top = Row(rect.y - mMaxHeight / 2 - 1);
+    int bottom = Row(rect.y + rect.height + mMaxHeight / 2 + 1);
+    for (int row = top; row <= bottom; row++)
+    {
+        // The cells of a row are next to each other
+        auto begin = mStarts[row * mColumns + first];
+        auto end = mStarts[row * mColumns + last + 1];
+        for (auto i = begin; i < end; i++)
+        {
+            if (mEntries[i].bounds.Intersects(rect))
+            {
+                ids->push_back(mEntries[i].id);
+            }
+        }
+    }
+}
+
+/**
+ * Find the column an X location is in
+ * @param x X location in pixels
+ * @return Column, clamped to the grid
+ */
+int SpatialGrid::Column(int x) const
+{
+    return clamp((x - mLeft) / GridCellSize, 0, mColumns - 1);
+}
+
+/**
+ * Find the row a Y location is in
+ * @param y Y location in pixels
+ * @return Row, clamped to the grid
+ */
+int SpatialGrid::Row(int y) const
+{
+    return clamp((y - mTop) / GridCellSize, 0, mRows - 1);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file SpatialGrid.h
+ * @author Josh Thomas
+ * @brief Header file for the SpatialGrid class.
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Item;
+
+/// Width and height of a grid cell in pixels
+const int GridCellSize = 64;
+
+/// Most cells across or down a grid. Items beyond
+/// the last cell are kept in the cell at the edge.
+const int MaxGridCells = 256;
+
+/**
+ * @class SpatialGrid
+ * @brief Finds the items in a rectangle without looking at every item.
+ *
+ * Items are binned by the cell their center is in, with a
+ * counting sort into one flat array, so a build is three passes
+ * over the items and reuses its memory from build to build.
+ * A query looks at the cells the rectangle covers, widened
+ * by half the largest item, so an item that pokes into the
+ * rectangle from a neighboring cell is still found.
+ */
+class SpatialGrid
+{
+private:
+    /// Left edge of the first column in pixels
+    int mLeft = 0;
+
+    /// Top edge of the first row in pixels
+    int mTop = 0;
+
+    /// Number of columns
+    int mColumns = 0;
+
+    /// Number of rows
+    int mRows = 0;
+
+    /// Width of the widest item in pixels
+    int mMaxWidth = 0;
+
+    /// Height of the tallest item in pixels
+    int mMaxHeight = 0;
+
+    /// Index in mEntries of the first entry of each cell,
+    /// plus one past the last entry of the last cell
+    std::vector<uint32_t> mStarts;
+
+    /**
+     * @struct Entry
+     * @brief One item, where it is, and its id.
+     */
+    struct Entry
+    {
+        /// Bounds of the item
+        wxRect bounds;
+
+        /// Id of the item
+        uint32_t id;
+    };
+
+    /// The items, cell by cell
+    std::vector<Entry> mEntries;
+
+    /// Scratch space for Build: the cell of each item
+    std::vector<uint32_t> mCellOf;
+
+    int Column(int x) const;
+    int Row(int y) const;
+
+public:
+    void Build(const std::vector<std::shared_ptr<Item>>& items);
+    void Query(const wxRect& rect, std::vector<uint32_t>* ids) const;
+
+    /**
+     * Get the number of items in the grid
+     * @return Item count
+     */
+    size_t GetCount() const { return mEntries.size(); }
+
+    /**
+     * Get the memory the grid holds
+     * @return Bytes allocated
+     */
+    size_t GetMemorySize() const
+    {
+        return (mStarts.capacity() + mCellOf.capacity()) * sizeof(uint32_t) + mEntries.capacity() * sizeof(Entry);
+    }
+};
+
+#endif //SPATIALGRID_H
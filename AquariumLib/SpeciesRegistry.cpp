@@ -0,0 +1,92 @@
+/**
+ * @file SpeciesRegistry.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "SpeciesRegistry.h"
+
+using namespace std;
+
+/**
+ * Get the registry. It is created on first use, so
+ * species can register during static initialization.
+ * @return The one species registry
+ */
+SpeciesRegistry& SpeciesRegistry::Get()
+{
+    static SpeciesRegistry registry;
+    return registry;
+}
+
+/**
+ * Register a species. Registering a tag again replaces its factory.
+ * @param tag Type name used in .aqua files
+ * @param factory Creates items of this species, nullptr if it cannot be created
+ * @param size Size of the item class in bytes, for memory reports
+ * @return The species id
+ */
+SpeciesId SpeciesRegistry::Register(const std::wstring& tag, Factory factory, size_t size)
+{
+    auto found = mByTag.find(tag);
+    if (found != mByTag.end())
+    {
+        mSpecies[found->second].factory = factory;
+        mSpecies[found->second].size = size;
+        return found->second;
+    }
+
+    auto id = (SpeciesId)mSpecies.size();
+    mSpecies.push_back({tag, factory, size, HashTag(tag)});
+    mByTag.emplace(tag, id);
+    return id;
+}
+
+/**
+ * Find the id for a tag
+ * @param tag Type name
+ * @return The species id, or UnknownSpecies if the tag has never been seen
+ */
+SpeciesId SpeciesRegistry::Find(const std::wstring& tag) const
+{
+    auto found = mByTag.find(tag);
+    return found != mByTag.end() ? found->second : UnknownSpecies;
+}
+
+/**
+ * Create a new item of a species
+ * @param id Species id
+ * @param aquarium Aquarium the item belongs to
+ * @return The new item, or nullptr if the species cannot be created
+ */
+std::shared_ptr<Item> SpeciesRegistry::Create(SpeciesId id, Aquarium* aquarium) const
+{
+    if (id >= mSpecies.size() || mSpecies[id].factory == nullptr)
+    {
+        return nullptr;
+    }
+
+    return mSpecies[id].factory(aquarium);
+}
+
+/**
+ * Hash a species tag.
+ *
+ * A 64 bit FNV-1a hash of the tag in UTF-8, so it does not
+ * depend on the size of wchar_t or anything else about the
+ * platform, and a species hashes the same everywhere.
+ *
+ * @param tag Type name
+ * @return The hash
+ */
+uint64_t SpeciesRegistry::HashTag(const std::wstring& tag)
+{
+    auto utf8 = wxString(tag).ToUTF8();
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < utf8.length(); i++)
+    {
+        hash = (hash ^ (unsigned char)utf8.data()[i]) * 1099511628211ull;
+    }
+
+    return hash;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file SpeciesRegistry.h
+ * @author Josh Thomas
+ * @brief Header file for the SpeciesRegistry class.
+ */
+
+#ifndef SPECIESREGISTRY_H
+#define SPECIESREGISTRY_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class Item;
+class Aquarium;
+
+/// Compact id of a species, assigned by the SpeciesRegistry
+typedef uint16_t SpeciesId;
+
+/// Returned when a tag has not been registered
+const SpeciesId UnknownSpecies = 0xffff;
+
+/**
+ * @class SpeciesRegistry
+ * @brief Every kind of item the aquarium knows how to create.
+ *
+ * Each species has a tag, the type name used in .aqua files, and a
+ * compact id that items report through Item::GetSpecies. Comparing
+ * ids and looking up tags by id allocate nothing, so type checks,
+ * saving and loading need no per-item strings.
+ *
+ * Species register themselves with AQUARIUM_REGISTER_SPECIES in their
+ * own .cpp file, so adding one does not mean editing Aquarium.cpp.
+ * Registration happens during static initialization and the registry
+ * is not safe to change from more than one thread after that.
+ */
+class SpeciesRegistry
+{
+public:
+    /// Creates a new item of a species
+    typedef std::shared_ptr<Item> (*Factory)(Aquarium* aquarium);
+
+private:
+    /**
+     * One registered species
+     */
+    struct Species
+    {
+        /// Type name used in .aqua files
+        std::wstring tag;
+
+        /// Creates items of this species, nullptr if it cannot be created
+        Factory factory;
+
+        /// Size of the item class in bytes, 0 if not registered
+        size_t size;
+
+        /// HashTag of the tag, the same in every build and run
+        uint64_t tagHash;
+    };
+
+    /// The species, indexed by id. A deque keeps the tags from moving.
+    std::deque<Species> mSpecies;
+
+    /// Species ids by tag
+    std::unordered_map<std::wstring, SpeciesId> mByTag;
+
+    SpeciesRegistry() = default;
+
+public:
+    /// Copy constructor (disabled)
+    SpeciesRegistry(const SpeciesRegistry&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SpeciesRegistry&) = delete;
+
+    static SpeciesRegistry& Get();
+
+    SpeciesId Register(const std::wstring& tag, Factory factory, size_t size = 0);
+    SpeciesId Find(const std::wstring& tag) const;
+    std::shared_ptr<Item> Create(SpeciesId id, Aquarium* aquarium) const;
+
+    /**
+     * Get the tag of a species
+     * @param id Species id, which must be valid
+     * @return Type name used in .aqua files
+     */
+    const std::wstring& GetTag(SpeciesId id) const { return mSpecies[id].tag; }
+
+    /**
+     * Get the hash of the tag of a species. Unlike the id, which
+     * depends on the order species register in, this is the same
+     * for a species in every program that registers it.
+     * @param id Species id, which must be valid
+     * @return HashTag of the tag
+     */
+    uint64_t GetTagHash(SpeciesId id) const { return mSpecies[id].tagHash; }
+
+    /**
+     * Get the size of the item class of a species
+     * @param id Species id, which must be valid
+     * @return Size in bytes, 0 if the species was not registered with one
+     */
+    size_t GetSize(SpeciesId id) const { return mSpecies[id].size; }
+
+    /**
+     * Get the number of species. Ids run from 0 to one less than this.
+     * @return Species count
+     */
+    size_t GetCount() const { return mSpecies.size(); }
+
+    static uint64_t HashTag(const std::wstring& tag);
+};
+
+/**
+ * Register an item class as a species. Use once, at namespace scope in
+ * the class's .cpp file. The class must declare
+ * `static const SpeciesId Species;` and have a constructor
+ * that takes the Aquarium.
+ * @param ItemClass The item class
+ * @param tag Type name used in .aqua files
+ */
+#define AQUARIUM_REGISTER_SPECIES(ItemClass, tag)                                       \
+    const SpeciesId ItemClass::Species = SpeciesRegistry::Get().Register(               \
+        tag, [](Aquarium* aquarium) -> std::shared_ptr<Item> {                          \
+            return std::make_shared<ItemClass>(aquarium);                               \
+        }, sizeof(ItemClass))
+
+#endif //SPECIESREGISTRY_H
@@ -0,0 +1,220 @@
+/**
+ * @file SpriteAtlas.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "SpriteAtlas.h"
+#include "SpriteLibrary.h"
+#include "MemoryReport.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+using namespace std;
+
+/**
+ * A row of sprites on a page
+ */
+struct Shelf
+{
+    /// Page the shelf is on
+    int page;
+
+    /// Top of the shelf
+    int y;
+
+    /// Height of the tallest sprite, which is the first one placed
+    int height;
+
+    /// Where the next sprite goes
+    int x;
+};
+
+/**
+ * Pack rectangles onto pages.
+ *
+ * Rectangles are placed tallest first on the first shelf they fit.
+ * A new shelf is opened below the others when none has room, and a
+ * new page when no page has room for the shelf. A rectangle larger
+ * than a page gets a page of its own, sized to fit it.
+ *
+ * @param sizes The rectangles. Empty ones are not placed.
+ * @param pageSize Width and height of a page
+ * @param pages Receives the size of each page, cut down to what is used
+ * @return Where each rectangle is, in the same order as sizes
+ */
+std::vector<AtlasRegion> SpriteAtlas::Pack(const std::vector<wxSize>& sizes, int pageSize,
+                                           std::vector<wxSize>* pages)
+{
+    vector<AtlasRegion> regions(sizes.size());
+    pages->clear();
+
+    vector<size_t> order(sizes.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+        if (sizes[a].GetHeight() != sizes[b].GetHeight())
+        {
+            return sizes[a].GetHeight() > sizes[b].GetHeight();
+        }
+        return sizes[a].GetWidth() > sizes[b].GetWidth();
+    });
+
+    vector<Shelf> shelves;
+
+    // Top of the next shelf on each page, pageSize once a page is full
+    vector<int> nextShelf;
+
+    for (auto i : order)
+    {
+        int width = sizes[i].GetWidth();
+        int height = sizes[i].GetHeight();
+        if (width <= 0 || height <= 0)
+        {
+            continue;
+        }
+
+        auto& region = regions[i];
+        if (width > pageSize || height > pageSize)
+        {
+            region.page = (int)pages->size();
+            region.rect = wxRect(0, 0, width, height);
+            pages->push_back(wxSize(width, height));
+            nextShelf.push_back(pageSize);
+            continue;
+        }
+
+        Shelf* shelf = nullptr;
+        for (auto& existing : shelves)
+        {
+            if (existing.height >= height && existing.x + width <= pageSize)
+            {
+                shelf = &existing;
+                break;
+            }
+        }
+
+        if (shelf == nullptr)
+        {
+            int page = 0;
+            while (page < (int)pages->size() && nextShelf[page] + height > pageSize)
+            {
+                page++;
+            }
+
+            if (page == (int)pages->size())
+            {
+                pages->push_back(wxSize(0, 0));
+                nextShelf.push_back(0);
+            }
+
+            shelves.push_back({page, nextShelf[page], height, 0});
+            nextShelf[page] += height;
+            shelf = &shelves.back();
+        }
+
+        region.page = shelf->page;
+        region.rect = wxRect(shelf->x, shelf->y, width, height);
+        shelf->x += width;
+
+        auto& page = (*pages)[shelf->page];
+        page = wxSize(max(page.GetWidth(), shelf->x), max(page.GetHeight(), shelf->y + height));
+    }
+
+    return regions;
+}
+
+/**
+ * Build the atlas from every ready sprite in a library.
+ *
+ * The pages are bitmaps, so call this from the UI thread.
+ *
+ * @param sprites The sprites to pack
+ * @param pageSize Width and height of a page
+ */
+void SpriteAtlas::Build(const SpriteLibrary& sprites, int pageSize)
+{
+    vector<wxSize> sizes;
+    vector<wxImage> images;
+    for (int id = 0; id < sprites.GetCount(); id++)
+    {
+        auto sprite = sprites.Get(id);
+        if (!sprite->ready)
+        {
+            sizes.insert(sizes.end(), 2, wxSize(0, 0));
+            images.insert(images.end(), 2, wxImage());
+            continue;
+        }
+
+        // Sprites from the pack only have their bitmaps
+        wxImage image = sprite->image.IsOk() ? sprite->image : sprite->bitmap.ConvertToImage();
+        if (!image.HasAlpha())
+        {
+            image.InitAlpha();
+        }
+
+        sizes.insert(sizes.end(), 2, wxSize(image.GetWidth(), image.GetHeight()));
+        images.push_back(image);
+        images.push_back(image.Mirror());
+    }
+
+    vector<wxSize> pageSizes;
+    mRegions = Pack(sizes, pageSize, &pageSizes);
+
+    // Start with fully transparent pages
+    vector<wxImage> pages;
+    for (const auto& size : pageSizes)
+    {
+        wxImage page(size.GetWidth(), size.GetHeight(), true);
+        page.InitAlpha();
+        memset(page.GetAlpha(), 0, (size_t)size.GetWidth() * size.GetHeight());
+        pages.push_back(page);
+    }
+
+    mUsed = 0;
+    for (size_t i = 0; i < mRegions.size(); i++)
+    {
+        const auto& region = mRegions[i];
+        if (region.page < 0)
+        {
+            continue;
+        }
+
+        auto& page = pages[region.page];
+        const auto& image = images[i];
+        const auto& rect = region.rect;
+        int pageWidth = page.GetWidth();
+        for (int y = 0; y < rect.GetHeight(); y++)
+        {
+            size_t from = (size_t)y * rect.GetWidth();
+            size_t to = (size_t)(rect.GetTop() + y) * pageWidth + rect.GetLeft();
+            memcpy(page.GetData() + to * 3, image.GetData() + from * 3, (size_t)rect.GetWidth() * 3);
+            memcpy(page.GetAlpha() + to, image.GetAlpha() + from, rect.GetWidth());
+        }
+
+        mUsed += (double)rect.GetWidth() * rect.GetHeight();
+    }
+
+    mPages.clear();
+    mTotal = 0;
+    for (const auto& page : pages)
+    {
+        mPages.push_back(wxBitmap(page));
+        mTotal += (double)page.GetWidth() * page.GetHeight();
+    }
+}
+
+/**
+ * Estimate the memory the atlas holds
+ * @return Bytes of the pages and the region table
+ */
+size_t SpriteAtlas::GetMemorySize() const
+{
+    size_t bytes = mRegions.capacity() * sizeof(AtlasRegion);
+    for (const auto& page : mPages)
+    {
+        bytes += (size_t)page.GetWidth() * page.GetHeight() * BitmapPixelBytes;
+    }
+
+    return bytes;
+}
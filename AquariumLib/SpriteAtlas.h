@@ -0,0 +1,92 @@
+/**
+ * @file SpriteAtlas.h
+ * @author Josh Thomas
+ * @brief Header file for the SpriteAtlas class.
+ */
+
+#ifndef SPRITEATLAS_H
+#define SPRITEATLAS_H
+
+#include <vector>
+
+class SpriteLibrary;
+
+/// Width and height of an atlas page in pixels. Sprites
+/// bigger than this get a page of their own.
+const int AtlasPageSize = 2048;
+
+/**
+ * @struct AtlasRegion
+ * @brief Where a sprite is in the atlas.
+ */
+struct AtlasRegion
+{
+    /// Index of the page, -1 if the sprite is not in the atlas
+    int page = -1;
+
+    /// The sprite's rectangle on the page
+    wxRect rect;
+};
+
+/**
+ * @class SpriteAtlas
+ * @brief Every sprite and its mirror packed onto a few large bitmaps.
+ *
+ * Drawing from an atlas blits sub-rectangles of one bitmap instead of
+ * switching between a bitmap per sprite, so a frame usually only
+ * selects a single source surface.
+ *
+ * Sprites are packed onto shelves, tallest first. Each page is cut
+ * down to the shelves it uses.
+ */
+class SpriteAtlas
+{
+private:
+    /// The pages
+    std::vector<wxBitmap> mPages;
+
+    /// Regions, two per sprite id, the mirrored one second
+    std::vector<AtlasRegion> mRegions;
+
+    /// Pixels covered by sprites
+    double mUsed = 0;
+
+    /// Pixels on all the pages
+    double mTotal = 0;
+
+public:
+    void Build(const SpriteLibrary& sprites, int pageSize = AtlasPageSize);
+    static std::vector<AtlasRegion> Pack(const std::vector<wxSize>& sizes, int pageSize,
+                                         std::vector<wxSize>* pages);
+
+    /**
+     * Get where a sprite is in the atlas
+     * @param sprite Sprite id
+     * @param mirror True for the mirrored sprite
+     * @return The region, page -1 if not in the atlas
+     */
+    const AtlasRegion& GetRegion(int sprite, bool mirror) const { return mRegions[sprite * 2 + (mirror ? 1 : 0)]; }
+
+    /**
+     * Get a page
+     * @param page Page index from an AtlasRegion
+     * @return The page bitmap
+     */
+    const wxBitmap& GetPage(int page) const { return mPages[page]; }
+
+    /**
+     * Get the number of pages
+     * @return Page count
+     */
+    int GetPageCount() const { return (int)mPages.size(); }
+
+    /**
+     * Get the fraction of the pages covered by sprites
+     * @return Utilization from 0 to 1
+     */
+    double GetUtilization() const { return mTotal > 0 ? mUsed / mTotal : 0; }
+
+    size_t GetMemorySize() const;
+};
+
+#endif //SPRITEATLAS_H
@@ -0,0 +1,278 @@
+/**
+ * @file SpriteLibrary.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "SpriteLibrary.h"
+#include "AssetPreloader.h"
+#include "MemoryReport.h"
+#include <wx/ffile.h>
+#include <wx/rawbmp.h>
+
+using namespace std;
+
+/**
+ * Read the size of a PNG image from its header, without decoding it
+ * @param filename PNG file
+ * @param width Receives the width in pixels
+ * @param height Receives the height in pixels
+ * @return false if this is not a PNG file
+ */
+static bool ReadPngSize(const std::wstring& filename, int* width, int* height)
+{
+    // Signature, then the IHDR chunk with the big-endian width and height
+    unsigned char header[24];
+    wxFFile file(filename, L"rb");
+    if (!file.IsOpened() || file.Read(header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, "\x89PNG\r\n\x1a\n", 8) != 0 || memcmp(header + 12, "IHDR", 4) != 0)
+    {
+        return false;
+    }
+
+    *width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+    *height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+    return true;
+}
+
+/// True where bitmaps store premultiplied alpha, as the pack does
+#if defined(__WXMSW__) || defined(__WXOSX__)
+const bool PremultipliedBitmaps = true;
+#else
+const bool PremultipliedBitmaps = false;
+#endif
+
+/**
+ * Make a bitmap from premultiplied RGBA pixels
+ * @param pixels The pixels
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @return The bitmap
+ */
+static wxBitmap MakeBitmap(const unsigned char* pixels, int width, int height)
+{
+    wxBitmap bitmap(width, height, 32);
+    wxAlphaPixelData data(bitmap);
+    if (!data)
+    {
+        return bitmap;
+    }
+
+    wxAlphaPixelData::Iterator row(data);
+    for (int y = 0; y < height; y++, row.OffsetY(data, 1))
+    {
+        auto p = row;
+        for (int x = 0; x < width; x++, ++p, pixels += 4)
+        {
+            unsigned a = pixels[3];
+            if (PremultipliedBitmaps || a == 0 || a == 255)
+            {
+                p.Red() = pixels[0];
+                p.Green() = pixels[1];
+                p.Blue() = pixels[2];
+            }
+            else
+            {
+                p.Red() = (unsigned char)std::min(255u, (pixels[0] * 255 + a / 2) / a);
+                p.Green() = (unsigned char)std::min(255u, (pixels[1] * 255 + a / 2) / a);
+                p.Blue() = (unsigned char)std::min(255u, (pixels[2] * 255 + a / 2) / a);
+            }
+            p.Alpha() = (unsigned char)a;
+        }
+    }
+
+    return bitmap;
+}
+
+/**
+ * Use a sprite pack for the images it has up to date copies of.
+ * If the pack cannot be opened, images are loaded from their files.
+ *
+ * Call before any sprites are loaded.
+ *
+ * @param filename Sprite pack file
+ * @return true if the pack was opened
+ */
+bool SpriteLibrary::OpenPack(const wxString& filename)
+{
+    return mPack.Open(filename);
+}
+
+/**
+ * Get the sprite for an image file, loading it the first time it is asked for.
+ * @param filename Image file to load
+ * @return The shared sprite, which may not be ready yet
+ */
+const Sprite* SpriteLibrary::Load(const std::wstring& filename)
+{
+    auto found = mByFilename.find(filename);
+    if (found != mByFilename.end())
+    {
+        return found->second;
+    }
+
+    auto sprite = make_unique<Sprite>();
+    sprite->id = (int)mSprites.size();
+    sprite->filename = filename;
+
+    // The pack needs no decoding at all
+    auto packed = mPack.IsOpen() ? mPack.Find(filename) : nullptr;
+    if (packed != nullptr)
+    {
+        AdoptPacked(sprite.get(), packed);
+        return Keep(std::move(sprite));
+    }
+
+    wxImage image;
+    auto state = AssetPreloader::Get().Take(filename, &image);
+    if (state == AssetPreloader::State::Pending && ReadPngSize(filename, &sprite->width, &sprite->height))
+    {
+        // Fill it in when the preloader is done with it
+        mPending.push_back(sprite.get());
+    }
+    else
+    {
+        if (state != AssetPreloader::State::Ready)
+        {
+            image.LoadFile(filename, wxBITMAP_TYPE_ANY);
+        }
+
+        Adopt(sprite.get(), image);
+    }
+
+    return Keep(std::move(sprite));
+}
+
+/**
+ * Add a newly loaded sprite to the library
+ * @param sprite The sprite
+ * @return The sprite, now owned by the library
+ */
+const Sprite* SpriteLibrary::Keep(std::unique_ptr<Sprite> sprite)
+{
+    auto loaded = sprite.get();
+    mByFilename[loaded->filename] = loaded;
+    mSprites.push_back(std::move(sprite));
+    mAtlasStale = true;
+    return loaded;
+}
+
+/**
+ * Fill in any sprites whose images have finished preloading.
+ *
+ * Call from the UI thread, once a frame.
+ *
+ * @return true if any sprite became ready
+ */
+bool SpriteLibrary::Update()
+{
+    bool changed = false;
+    for (auto i = mPending.begin(); i != mPending.end();)
+    {
+        auto sprite = *i;
+
+        wxImage image;
+        auto state = AssetPreloader::Get().Take(sprite->filename, &image);
+        if (state == AssetPreloader::State::Pending)
+        {
+            ++i;
+            continue;
+        }
+
+        if (state != AssetPreloader::State::Ready)
+        {
+            image.LoadFile(sprite->filename, wxBITMAP_TYPE_ANY);
+        }
+
+        Adopt(sprite, image);
+        i = mPending.erase(i);
+        changed = true;
+    }
+
+    mAtlasStale = mAtlasStale || changed;
+    return changed;
+}
+
+/**
+ * Get the atlas of every ready sprite, rebuilding it
+ * if sprites have been loaded since it was built.
+ *
+ * Call from the UI thread.
+ *
+ * @return The atlas
+ */
+const SpriteAtlas& SpriteLibrary::GetAtlas()
+{
+    if (mAtlasStale)
+    {
+        mAtlas.Build(*this);
+        mAtlasStale = false;
+    }
+
+    return mAtlas;
+}
+
+/**
+ * Add the memory the library holds to a report
+ * @param report Report to add the sprites, tables and caches to
+ */
+void SpriteLibrary::AddMemory(MemoryReport* report) const
+{
+    for (const auto& sprite : mSprites)
+    {
+        size_t pixels = (size_t)sprite->width * sprite->height;
+        if (sprite->image.IsOk())
+        {
+            report->sprites += pixels * (sprite->image.HasAlpha() ? 4 : 3);
+        }
+
+        if (sprite->ready)
+        {
+            // The bitmap and its mirror
+            report->sprites += pixels * BitmapPixelBytes * 2;
+        }
+
+        report->containers += sizeof(Sprite) + sprite->filename.capacity() * sizeof(wchar_t);
+    }
+
+    // Hash nodes hold the key, the value and a next pointer
+    report->containers += mSprites.capacity() * sizeof(std::unique_ptr<Sprite>) +
+                          mPending.capacity() * sizeof(Sprite*) +
+                          mByFilename.bucket_count() * sizeof(void*) +
+                          mByFilename.size() * (sizeof(std::pair<const std::wstring, Sprite*>) + sizeof(void*));
+
+    report->atlas += mAtlas.GetMemorySize();
+    report->pack += mPack.GetSize();
+}
+
+/**
+ * Make the bitmaps for a sprite from its image
+ * @param sprite Sprite to fill in
+ * @param image The decoded image
+ */
+void SpriteLibrary::Adopt(Sprite* sprite, const wxImage& image)
+{
+    sprite->image = image;
+    sprite->bitmap = wxBitmap(image);
+
+    // Create a mirrored image
+    sprite->mirror = wxBitmap(image.Mirror());
+    sprite->width = sprite->bitmap.GetWidth();
+    sprite->height = sprite->bitmap.GetHeight();
+    sprite->ready = true;
+}
+
+/**
+ * Make the bitmaps for a sprite from its packed copy
+ * @param sprite Sprite to fill in
+ * @param entry The sprite's entry in the pack
+ */
+void SpriteLibrary::AdoptPacked(Sprite* sprite, const SpritePackEntry* entry)
+{
+    sprite->width = (int)entry->width;
+    sprite->height = (int)entry->height;
+    sprite->bitmap = MakeBitmap(mPack.GetPixels(entry, false), sprite->width, sprite->height);
+    sprite->mirror = MakeBitmap(mPack.GetPixels(entry, true), sprite->width, sprite->height);
+    sprite->mask = mPack.GetMask(entry);
+    sprite->ready = true;
+}
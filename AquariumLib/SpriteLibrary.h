@@ -0,0 +1,150 @@
+/**
+ * @file SpriteLibrary.h
+ * @author Josh Thomas
+ * @brief Header file for the SpriteLibrary class.
+ *
+ * Sprites are the images items are drawn with. They are
+ * loaded once per aquarium and shared by every item that
+ * uses the same image file.
+ */
+
+#ifndef SPRITELIBRARY_H
+#define SPRITELIBRARY_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SpritePack.h"
+#include "SpriteAtlas.h"
+
+struct MemoryReport;
+
+/**
+ * @struct Sprite
+ * @brief An image loaded for drawing and hit testing.
+ */
+struct Sprite
+{
+    /// Index of this sprite in its library
+    int id = 0;
+
+    /// File the sprite was loaded from
+    std::wstring filename;
+
+    /// The underlying image, used for hit testing. Empty
+    /// for sprites loaded from a pack, which use mask instead.
+    wxImage image;
+
+    /// Alpha mask from the sprite pack, one bit per pixel set
+    /// where the sprite can be hit, or nullptr if not packed
+    const unsigned char* mask = nullptr;
+
+    /// The bitmap we draw
+    wxBitmap bitmap;
+
+    /// The mirrored bitmap we draw when facing the other way
+    wxBitmap mirror;
+
+    /// Width in pixels
+    int width = 0;
+
+    /// Height in pixels
+    int height = 0;
+
+    /// False while the image is still being preloaded. The size
+    /// is known, but there is nothing to draw or hit test yet.
+    bool ready = false;
+
+    /**
+     * Is a pixel too transparent to click on?
+     * @param x X position in the sprite
+     * @param y Y position in the sprite
+     * @return true if transparent
+     */
+    bool IsTransparent(int x, int y) const
+    {
+        if (mask == nullptr)
+        {
+            return image.IsTransparent(x, y);
+        }
+
+        return (mask[y * SpritePack::MaskRowBytes(width) + x / 8] & (1 << (x % 8))) == 0;
+    }
+};
+
+/**
+ * @class SpriteLibrary
+ * @brief Loads sprites and hands out shared references to them.
+ *
+ * Sprites are never unloaded while the library exists, so the
+ * pointers returned by Load remain valid for its lifetime.
+ *
+ * Images are taken from the sprite pack when it has an up to
+ * date copy, which needs no decoding at all. Images the
+ * AssetPreloader is still decoding get a placeholder
+ * sprite of the right size. Update fills them in once they are
+ * decoded. Any other image is loaded on the spot.
+ */
+class SpriteLibrary
+{
+private:
+    /// Decoded images. Declared first, since the sprites
+    /// point into it.
+    SpritePack mPack;
+
+    /// All loaded sprites, indexed by sprite id
+    std::vector<std::unique_ptr<Sprite>> mSprites;
+
+    /// Sprites by filename
+    std::unordered_map<std::wstring, Sprite*> mByFilename;
+
+    /// Sprites that are not ready yet
+    std::vector<Sprite*> mPending;
+
+    /// Every ready sprite packed together for drawing
+    SpriteAtlas mAtlas;
+
+    /// True if sprites have become ready since the atlas was built
+    bool mAtlasStale = true;
+
+    const Sprite* Keep(std::unique_ptr<Sprite> sprite);
+    static void Adopt(Sprite* sprite, const wxImage& image);
+    void AdoptPacked(Sprite* sprite, const SpritePackEntry* entry);
+
+public:
+    SpriteLibrary() = default;
+
+    /// Copy constructor (disabled)
+    SpriteLibrary(const SpriteLibrary&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SpriteLibrary&) = delete;
+
+    bool OpenPack(const wxString& filename);
+    const Sprite* Load(const std::wstring& filename);
+    bool Update();
+    const SpriteAtlas& GetAtlas();
+    void AddMemory(MemoryReport* report) const;
+
+    /**
+     * Are all the sprites ready to draw?
+     * @return true if none are still being preloaded
+     */
+    bool IsReady() const { return mPending.empty(); }
+
+    /**
+     * Get a sprite by id
+     * @param id Sprite id as returned in Sprite::id
+     * @return The sprite
+     */
+    const Sprite* Get(int id) const { return mSprites[id].get(); }
+
+    /**
+     * Get the number of loaded sprites
+     * @return Sprite count
+     */
+    int GetCount() const { return (int)mSprites.size(); }
+};
+
+#endif //SPRITELIBRARY_H
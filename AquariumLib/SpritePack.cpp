@@ -0,0 +1,269 @@
+/**
+ * @file SpritePack.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "SpritePack.h"
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <cstring>
+#include <filesystem>
+
+using namespace std;
+
+/// Largest width or height we accept in a pack
+const uint32_t MaxPackedSize = 16384;
+
+/// Suffix of the file a pack is written to before it replaces the old one
+const wchar_t TempPackSuffix[] = L".packing";
+
+/**
+ * Get the modification time and size of an image file
+ * @param filename Image file
+ * @param time Receives the modification time
+ * @param size Receives the size in bytes
+ * @return false if the file does not exist
+ */
+static bool SourceStats(const std::wstring& filename, int64_t* time, uint64_t* size)
+{
+    error_code error;
+    auto bytes = filesystem::file_size(filesystem::path(filename), error);
+    auto modified = wxFileModificationTime(filename);
+    if (error || modified == (time_t)-1)
+    {
+        return false;
+    }
+
+    *time = (int64_t)modified;
+    *size = (uint64_t)bytes;
+    return true;
+}
+
+/**
+ * Round a size up to the pixel alignment
+ * @param size Size in bytes
+ * @return The aligned size
+ */
+static size_t Align(size_t size)
+{
+    return (size + SpritePackAlignment - 1) / SpritePackAlignment * SpritePackAlignment;
+}
+
+/**
+ * Map a sprite pack into memory
+ * @param filename Pack file
+ * @return false if it is missing or not a valid pack
+ */
+bool SpritePack::Open(const wxString& filename)
+{
+    Close();
+    if (!wxFileExists(filename) || !mFile.Open(filename))
+    {
+        return false;
+    }
+
+    auto data = mFile.GetData();
+    auto size = (uint64_t)mFile.GetSize();
+
+    SpritePackHeader header;
+    if (data == nullptr || size < sizeof(header))
+    {
+        Close();
+        return false;
+    }
+
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, SpritePackMagic, sizeof(header.magic)) != 0 ||
+        header.version != SpritePackVersion ||
+        size < sizeof(header) + (uint64_t)header.count * sizeof(SpritePackEntry))
+    {
+        Close();
+        return false;
+    }
+
+    // Entries are 8 byte aligned in the file, and the mapping is page aligned
+    auto entries = (const SpritePackEntry*)(data + sizeof(header));
+    for (uint32_t i = 0; i < header.count; i++)
+    {
+        const auto& entry = entries[i];
+        uint64_t pixelBytes = (uint64_t)entry.width * entry.height * 8;
+        uint64_t maskBytes = MaskRowBytes(entry.width) * entry.height;
+        if (entry.width > MaxPackedSize || entry.height > MaxPackedSize ||
+            (uint64_t)entry.name + entry.nameBytes > size ||
+            entry.pixels % SpritePackAlignment != 0 ||
+            entry.pixels > size || size - entry.pixels < pixelBytes + maskBytes)
+        {
+            Close();
+            return false;
+        }
+
+        auto name = wxString::FromUTF8(data + entry.name, entry.nameBytes);
+        mEntries[name.ToStdWstring()] = &entry;
+    }
+
+    return true;
+}
+
+/**
+ * Unmap the pack. Pointers into it are no longer valid.
+ */
+void SpritePack::Close()
+{
+    mEntries.clear();
+    mFile.Close();
+}
+
+/**
+ * Find the packed copy of an image
+ * @param filename Image file, as named in the manifest
+ * @return The entry, or nullptr if it is not in the pack or is stale
+ */
+const SpritePackEntry* SpritePack::Find(const std::wstring& filename) const
+{
+    auto found = mEntries.find(filename);
+    if (found == mEntries.end())
+    {
+        return nullptr;
+    }
+
+    int64_t time;
+    uint64_t size;
+    if (SourceStats(filename, &time, &size) &&
+        (time != found->second->sourceTime || size != found->second->sourceSize))
+    {
+        return nullptr;
+    }
+
+    return found->second;
+}
+
+/**
+ * Decode images and write them to a sprite pack.
+ *
+ * The pack is written beside the destination and then renamed over
+ * it, so a pack that is mapped by a running aquarium is not changed
+ * under it.
+ *
+ * @param files Image files to pack
+ * @param filename Pack file to write
+ * @return false if an image could not be decoded or the pack written
+ */
+bool SpritePack::Write(const std::vector<std::wstring>& files, const wxString& filename)
+{
+    vector<SpritePackEntry> entries(files.size());
+    vector<string> names;
+    vector<wxImage> images;
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        wxImage image;
+        if (!image.LoadFile(files[i], wxBITMAP_TYPE_ANY) ||
+            (uint32_t)image.GetWidth() > MaxPackedSize || (uint32_t)image.GetHeight() > MaxPackedSize)
+        {
+            return false;
+        }
+
+        // Images without alpha get it here, from their mask if they have one
+        if (!image.HasAlpha())
+        {
+            image.InitAlpha();
+        }
+
+        auto& entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+        SourceStats(files[i], &entry.sourceTime, &entry.sourceSize);
+        entry.width = image.GetWidth();
+        entry.height = image.GetHeight();
+
+        names.push_back(wxString(files[i]).ToUTF8().data());
+        images.push_back(image);
+    }
+
+    // Lay out the names, then the pixels
+    size_t offset = sizeof(SpritePackHeader) + entries.size() * sizeof(SpritePackEntry);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        entries[i].name = (uint32_t)offset;
+        entries[i].nameBytes = (uint32_t)names[i].size();
+        offset += names[i].size();
+    }
+
+    for (auto& entry : entries)
+    {
+        offset = Align(offset);
+        entry.pixels = offset;
+        offset += (size_t)entry.width * entry.height * 8 + MaskRowBytes(entry.width) * entry.height;
+    }
+
+    vector<unsigned char> pack(offset, 0);
+
+    SpritePackHeader header;
+    memcpy(header.magic, SpritePackMagic, sizeof(header.magic));
+    header.version = SpritePackVersion;
+    header.count = (uint32_t)entries.size();
+    memcpy(pack.data(), &header, sizeof(header));
+    if (!entries.empty())
+    {
+        memcpy(pack.data() + sizeof(header), entries.data(), entries.size() * sizeof(SpritePackEntry));
+    }
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const auto& entry = entries[i];
+        const auto& image = images[i];
+        memcpy(pack.data() + entry.name, names[i].data(), names[i].size());
+
+        int width = entry.width;
+        int height = entry.height;
+        auto pixels = pack.data() + entry.pixels;
+        auto mirrored = pixels + (size_t)width * height * 4;
+        auto mask = mirrored + (size_t)width * height * 4;
+        auto rowBytes = MaskRowBytes(width);
+
+        const unsigned char* rgb = image.GetData();
+        const unsigned char* alpha = image.GetAlpha();
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                size_t source = (size_t)y * width + x;
+                unsigned a = alpha[source];
+
+                unsigned char premultiplied[4];
+                for (int c = 0; c < 3; c++)
+                {
+                    premultiplied[c] = (unsigned char)((rgb[source * 3 + c] * a + 127) / 255);
+                }
+                premultiplied[3] = (unsigned char)a;
+
+                memcpy(pixels + source * 4, premultiplied, 4);
+                memcpy(mirrored + ((size_t)y * width + (width - 1 - x)) * 4, premultiplied, 4);
+
+                // The same test wxImage::IsTransparent makes
+                if (a >= wxIMAGE_ALPHA_THRESHOLD)
+                {
+                    mask[y * rowBytes + x / 8] |= (unsigned char)(1 << (x % 8));
+                }
+            }
+        }
+    }
+
+    auto temp = filename + TempPackSuffix;
+    {
+        wxFFile file(temp, L"wb");
+        if (!file.IsOpened() || file.Write(pack.data(), pack.size()) != pack.size() || !file.Close())
+        {
+            wxRemoveFile(temp);
+            return false;
+        }
+    }
+
+    if (!wxRenameFile(temp, filename, true))
+    {
+        wxRemoveFile(temp);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file SpritePack.h
+ * @author Josh Thomas
+ * @brief Header file for the SpritePack class.
+ *
+ * A sprite pack holds every sprite image already decoded, so
+ * bitmaps can be built from it without decoding any PNGs. It is
+ * made offline by the aquarium_pack build target.
+ *
+ * Layout of a pack file, in native byte order:
+ *  - SpritePackHeader
+ *  - count SpritePackEntry structures
+ *  - The UTF-8 filenames of the entries
+ *  - For each entry, aligned to SpritePackAlignment:
+ *    - width * height premultiplied RGBA pixels
+ *    - The same pixels mirrored left to right
+ *    - An alpha mask of one bit per pixel, set where the pixel is
+ *      opaque enough to hit, each row padded to a whole byte
+ */
+
+#ifndef SPRITEPACK_H
+#define SPRITEPACK_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MappedFile.h"
+
+/// Magic bytes at the start of every sprite pack
+const char SpritePackMagic[8] = {'A', 'Q', 'U', 'A', 'P', 'A', 'C', 'K'};
+
+/// Current version of the sprite pack format
+const uint32_t SpritePackVersion = 1;
+
+/// Pixel data in a pack starts on a multiple of this many bytes
+const size_t SpritePackAlignment = 16;
+
+/// The pack built from the asset manifest
+const wchar_t SpritePackName[] = L"images/sprites.pack";
+
+/**
+ * @struct SpritePackHeader
+ * @brief The header at the start of a sprite pack.
+ */
+struct SpritePackHeader
+{
+    /// Always SpritePackMagic
+    char magic[8];
+
+    /// Format version, SpritePackVersion when written
+    uint32_t version;
+
+    /// Number of entries that follow
+    uint32_t count;
+};
+
+static_assert(sizeof(SpritePackHeader) == 16, "SpritePackHeader is an on-disk format");
+
+/**
+ * @struct SpritePackEntry
+ * @brief One image in a sprite pack.
+ */
+struct SpritePackEntry
+{
+    /// Modification time of the source image when packed
+    int64_t sourceTime;
+
+    /// Size of the source image in bytes when packed
+    uint64_t sourceSize;
+
+    /// Offset of the pixels from the start of the file
+    uint64_t pixels;
+
+    /// Width in pixels
+    uint32_t width;
+
+    /// Height in pixels
+    uint32_t height;
+
+    /// Offset of the filename from the start of the file
+    uint32_t name;
+
+    /// Length of the filename in bytes
+    uint32_t nameBytes;
+};
+
+static_assert(sizeof(SpritePackEntry) == 40, "SpritePackEntry is an on-disk format");
+
+/**
+ * @class SpritePack
+ * @brief A sprite pack mapped into memory.
+ *
+ * The pack is mapped rather than read, so only the images that
+ * are used are ever paged in. Pointers into it remain valid
+ * until the pack is closed.
+ *
+ * An entry whose source image has changed since the pack was made
+ * is stale and is not returned, so the image is loaded from the
+ * PNG instead. An entry whose source image is missing is used.
+ */
+class SpritePack
+{
+private:
+    /// The mapped pack file
+    MappedFile mFile;
+
+    /// Entries by filename
+    std::unordered_map<std::wstring, const SpritePackEntry*> mEntries;
+
+public:
+    SpritePack() = default;
+
+    /// Copy constructor (disabled)
+    SpritePack(const SpritePack&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const SpritePack&) = delete;
+
+    bool Open(const wxString& filename);
+    void Close();
+    const SpritePackEntry* Find(const std::wstring& filename) const;
+
+    /**
+     * Is a pack open?
+     * @return true if open
+     */
+    bool IsOpen() const { return mFile.GetData() != nullptr; }
+
+    /**
+     * Get the size of the mapped pack
+     * @return Size in bytes, 0 if no pack is open
+     */
+    size_t GetSize() const { return mFile.GetSize(); }
+
+    /**
+     * Get the pixels of an entry
+     * @param entry Entry returned by Find
+     * @param mirrored True for the mirrored copy
+     * @return width * height premultiplied RGBA pixels
+     */
+    const unsigned char* GetPixels(const SpritePackEntry* entry, bool mirrored) const
+    {
+        size_t bytes = (size_t)entry->width * entry->height * 4;
+        return (const unsigned char*)mFile.GetData() + entry->pixels + (mirrored ? bytes : 0);
+    }
+
+    /**
+     * Get the alpha mask of an entry
+     * @param entry Entry returned by Find
+     * @return The mask, MaskRowBytes(width) bytes a row
+     */
+    const unsigned char* GetMask(const SpritePackEntry* entry) const
+    {
+        return GetPixels(entry, false) + (size_t)entry->width * entry->height * 8;
+    }
+
+    /**
+     * Get the number of bytes in each row of an alpha mask
+     * @param width Width in pixels
+     * @return Bytes a row
+     */
+    static size_t MaskRowBytes(int width) { return ((size_t)width + 7) / 8; }
+
+    static bool Write(const std::vector<std::wstring>& files, const wxString& filename);
+};
+
+#endif //SPRITEPACK_H
@@ -0,0 +1,58 @@
+/**
+ * @file StateHash.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "StateHash.h"
+#include <cmath>
+
+/**
+ * Mix the bits of a value, the splitmix64 finalizer
+ * @param value Value to mix
+ * @return The mixed value
+ */
+static uint64_t Mix(uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+/**
+ * Round a value to a whole number of quanta
+ * @param value The value
+ * @param quantum Size of one step
+ * @return The value in steps, as the bits of a signed integer
+ */
+static uint64_t Quantize(double value, double quantum)
+{
+    return (uint64_t)std::llround(value / quantum);
+}
+
+/**
+ * Hash the state of one item
+ * @param tagHash SpeciesRegistry::HashTag of the item's species
+ * @param record The item's state
+ * @return The hash
+ */
+uint64_t StateHash::HashItem(uint64_t tagHash, const ItemRecord& record)
+{
+    auto hash = Mix(tagHash);
+    hash = Mix(hash ^ Quantize(record.x, PositionQuantum));
+    hash = Mix(hash ^ Quantize(record.y, PositionQuantum));
+    hash = Mix(hash ^ Quantize(record.speedX, SpeedQuantum));
+    hash = Mix(hash ^ Quantize(record.speedY, SpeedQuantum));
+    hash = Mix(hash ^ Quantize(record.state[0], StateQuantum));
+    hash = Mix(hash ^ Quantize(record.state[1], StateQuantum));
+    return Mix(hash ^ record.flags);
+}
+
+/**
+ * Get the hash of every item added
+ * @return The hash, which also depends on the number of items
+ */
+uint64_t StateHash::GetValue() const
+{
+    return Mix(mSum ^ Mix(mCount));
+}
@@ -0,0 +1,78 @@
+/**
+ * @file StateHash.h
+ * @author Josh Thomas
+ * @brief Header file for the StateHash class.
+ */
+
+#ifndef STATEHASH_H
+#define STATEHASH_H
+
+#include <cstdint>
+#include "ItemRecord.h"
+#include "SpeciesRegistry.h"
+
+/// Positions are hashed in steps of this many pixels, so rounding
+/// differences smaller than this do not count as a divergence
+const double PositionQuantum = 1.0 / 256;
+
+/// Speeds are hashed in steps of this many pixels per second
+const double SpeedQuantum = 1.0 / 256;
+
+/// Species state, such as behavior timers, is hashed in steps of this much
+const double StateQuantum = 1.0 / 65536;
+
+/**
+ * @class StateHash
+ * @brief Order independent hash of the state of a set of items.
+ *
+ * Each item's species and quantized record are mixed into a 64 bit
+ * hash, and the item hashes are added together. The species is
+ * hashed by its tag, not its id, since ids depend on the order
+ * species register in, which can differ from program to program. Addition does not
+ * care about order, so the hash can be built up one item at a time
+ * in whatever order the items are visited, and two aquariums that
+ * store or update their items differently still hash the same if
+ * every item ends up in the same state.
+ */
+class StateHash
+{
+private:
+    /// Sum of the item hashes
+    uint64_t mSum = 0;
+
+    /// Number of items added
+    size_t mCount = 0;
+
+public:
+    static uint64_t HashItem(uint64_t tagHash, const ItemRecord& record);
+
+    /**
+     * Start again with no items
+     */
+    void Clear()
+    {
+        mSum = 0;
+        mCount = 0;
+    }
+
+    /**
+     * Add an item's state to the hash
+     * @param species The item's species
+     * @param record The item's state
+     */
+    void Add(SpeciesId species, const ItemRecord& record)
+    {
+        mSum += HashItem(SpeciesRegistry::Get().GetTagHash(species), record);
+        mCount++;
+    }
+
+    /**
+     * Get the number of items in the hash
+     * @return Item count
+     */
+    size_t GetCount() const { return mCount; }
+
+    uint64_t GetValue() const;
+};
+
+#endif //STATEHASH_H
@@ -0,0 +1,236 @@
+/**
+ * @file Tracer.cpp
+ * @author Josh Thomas
+ */
+
+#include "pch.h"
+#include "Tracer.h"
+#include <wx/ffile.h>
+#include <wx/thread.h>
+#include <algorithm>
+#include <string>
+
+using namespace std;
+
+thread_local Tracer::BufferOwner Tracer::sThreadBuffer;
+
+/**
+ * Get the tracer
+ * @return The one tracer
+ */
+Tracer& Tracer::Get()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+/**
+ * Get the calling thread's buffer. The first time, this is the
+ * buffer of a thread that has ended, or a new one if there is none.
+ * @return The buffer
+ */
+Tracer::Buffer* Tracer::GetBuffer()
+{
+    auto& owner = sThreadBuffer;
+    if (owner.buffer == nullptr)
+    {
+        lock_guard<mutex> lock(mMutex);
+        if (!mFree.empty())
+        {
+            owner.buffer = mFree.back();
+            mFree.pop_back();
+        }
+        else
+        {
+            mBuffers.push_back(make_unique<Buffer>());
+            owner.buffer = mBuffers.back().get();
+            owner.buffer->thread = (int)mBuffers.size();
+        }
+
+        owner.buffer->main = wxIsMainThread();
+    }
+
+    return owner.buffer;
+}
+
+/**
+ * Take back the buffer of a thread that has ended. Its zones
+ * stay in the ring until the next thread to use it overwrites them.
+ * @param buffer The buffer
+ */
+void Tracer::Release(Buffer* buffer)
+{
+    lock_guard<mutex> lock(mMutex);
+    mFree.push_back(buffer);
+}
+
+/**
+ * Destructor. Runs as the thread ends.
+ */
+Tracer::BufferOwner::~BufferOwner()
+{
+    if (buffer != nullptr)
+    {
+        Tracer::Get().Release(buffer);
+    }
+}
+
+/**
+ * Start recording, discarding anything recorded before
+ */
+void Tracer::Start()
+{
+    {
+        lock_guard<mutex> lock(mMutex);
+        for (auto& buffer : mBuffers)
+        {
+            lock_guard<mutex> bufferLock(buffer->mutex);
+            buffer->count = 0;
+        }
+    }
+
+    sEnabled = true;
+}
+
+/**
+ * Stop recording. What was recorded is kept until the next Start.
+ */
+void Tracer::Stop()
+{
+    sEnabled = false;
+}
+
+/**
+ * Record a completed zone in the calling thread's ring
+ * @param name Name of the zone, a string literal
+ * @param start When the zone was entered
+ * @param duration How long the zone took
+ */
+void Tracer::Record(const char* name, int64_t start, int64_t duration)
+{
+    auto buffer = GetBuffer();
+
+    // Only contended while the trace is being written
+    lock_guard<mutex> lock(buffer->mutex);
+    if (buffer->events.empty())
+    {
+        buffer->events.resize(TraceBufferSize);
+    }
+
+    buffer->events[buffer->count % buffer->events.size()] = {name, start, duration};
+    buffer->count++;
+}
+
+/**
+ * Get every recorded zone that is still in the rings
+ * @param threads If not nullptr, receives the trace thread id of each event
+ * @return The zones in the order they were entered
+ */
+std::vector<TraceEvent> Tracer::GetEvents(std::vector<int>* threads)
+{
+    vector<pair<int, TraceEvent>> all;
+
+    {
+        lock_guard<mutex> lock(mMutex);
+        for (auto& buffer : mBuffers)
+        {
+            lock_guard<mutex> bufferLock(buffer->mutex);
+            auto size = buffer->events.size();
+            auto kept = min(buffer->count, size);
+            for (size_t i = buffer->count - kept; i < buffer->count; i++)
+            {
+                all.emplace_back(buffer->thread, buffer->events[i % size]);
+            }
+        }
+    }
+
+    stable_sort(all.begin(), all.end(), [](const auto& a, const auto& b) { return a.second.start < b.second.start; });
+
+    vector<TraceEvent> events;
+    if (threads != nullptr)
+    {
+        threads->clear();
+    }
+
+    for (const auto& event : all)
+    {
+        events.push_back(event.second);
+        if (threads != nullptr)
+        {
+            threads->push_back(event.first);
+        }
+    }
+
+    return events;
+}
+
+/**
+ * Append a string to JSON output as a quoted string
+ * @param text The string
+ * @param json Output to append to
+ */
+static void AppendJsonString(const char* text, std::string* json)
+{
+    *json += '"';
+    for (; *text != '\0'; text++)
+    {
+        if (*text == '"' || *text == '\\')
+        {
+            *json += '\\';
+        }
+
+        if ((unsigned char)*text >= ' ')
+        {
+            *json += *text;
+        }
+    }
+    *json += '"';
+}
+
+/**
+ * Write the recorded zones in the Chrome trace event format
+ * @param filename JSON file to write
+ * @return false if the file could not be written
+ */
+bool Tracer::Write(const wxString& filename)
+{
+    vector<int> threads;
+    auto events = GetEvents(&threads);
+
+    // Times are written in microseconds from the first zone
+    int64_t origin = events.empty() ? 0 : events.front().start;
+
+    string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    char number[128];
+
+    bool first = true;
+    {
+        lock_guard<mutex> lock(mMutex);
+        for (const auto& buffer : mBuffers)
+        {
+            snprintf(number, sizeof(number), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                     first ? "" : ",\n", buffer->thread);
+            json += number;
+
+            string name = buffer->main ? "Main" : "Thread " + to_string(buffer->thread);
+            AppendJsonString(name.c_str(), &json);
+            json += "}}";
+            first = false;
+        }
+    }
+
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        json += first ? "{\"name\":" : ",\n{\"name\":";
+        AppendJsonString(events[i].name, &json);
+        snprintf(number, sizeof(number), ",\"cat\":\"aquarium\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                 (events[i].start - origin) / 1000.0, events[i].duration / 1000.0, threads[i]);
+        json += number;
+        first = false;
+    }
+
+    json += "\n]}\n";
+
+    wxFFile file(filename, L"wb");
+    return file.IsOpened() && file.Write(json.data(), json.size()) == json.size() && file.Close();
+}
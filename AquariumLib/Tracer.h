@@ -0,0 +1,202 @@
+/**
+ * @file Tracer.h
+ * @author Josh Thomas
+ * @brief Header file for the Tracer class and the trace zone macro.
+ *
+ * Mark a scope to be traced with AQUARIUM_TRACE_ZONE("Name"). When the
+ * library is built without AQUARIUM_TRACING the macro is empty and
+ * zones cost nothing. When tracing is built in but not recording, a
+ * zone costs one relaxed atomic load.
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// Number of zones kept per thread. Older ones are overwritten.
+const size_t TraceBufferSize = 16384;
+
+/**
+ * @struct TraceEvent
+ * @brief One completed zone.
+ */
+struct TraceEvent
+{
+    /// Name of the zone, a string literal
+    const char* name;
+
+    /// When the zone was entered, in steady clock nanoseconds
+    int64_t start;
+
+    /// How long the zone took in nanoseconds
+    int64_t duration;
+};
+
+/**
+ * @class Tracer
+ * @brief Records trace zones into per-thread ring buffers.
+ *
+ * Each thread writes to a ring of its own, so threads never contend
+ * with each other while recording. When a thread ends, its ring is
+ * kept for the next new thread, so there are never more rings than
+ * threads that have recorded at the same time.
+ *
+ * The recording can be written out in the Chrome trace event format,
+ * which chrome://tracing and Perfetto open directly.
+ */
+class Tracer
+{
+private:
+    /**
+     * The ring of events recorded by one thread
+     */
+    struct Buffer
+    {
+        /// Id of the thread in the trace
+        int thread;
+
+        /// True for the UI thread
+        bool main;
+
+        /// The events, allocated when first recorded to
+        std::vector<TraceEvent> events;
+
+        /// Number of events ever recorded, so the next goes at count % size
+        size_t count = 0;
+
+        /// Held by the thread while it records and by Write while it reads
+        std::mutex mutex;
+    };
+
+    /**
+     * Gives a thread's buffer back to the tracer when the thread ends
+     */
+    struct BufferOwner
+    {
+        /// The thread's buffer, nullptr until it first records
+        Buffer* buffer = nullptr;
+
+        ~BufferOwner();
+    };
+
+    /// The calling thread's buffer
+    static thread_local BufferOwner sThreadBuffer;
+
+    /// True while recording. Static, so the test in every
+    /// zone is a load from a fixed address.
+    inline static std::atomic<bool> sEnabled{false};
+
+    /// Protects mBuffers and mFree
+    std::mutex mMutex;
+
+    /// Every buffer there is. Kept after its thread ends,
+    /// so its zones can still be written.
+    std::vector<std::unique_ptr<Buffer>> mBuffers;
+
+    /// Buffers whose threads have ended, for new threads to reuse
+    std::vector<Buffer*> mFree;
+
+    Tracer() = default;
+    Buffer* GetBuffer();
+    void Release(Buffer* buffer);
+
+public:
+    /// Copy constructor (disabled)
+    Tracer(const Tracer&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const Tracer&) = delete;
+
+    static Tracer& Get();
+
+    /**
+     * Is a trace being recorded?
+     * @return true if zones are recorded
+     */
+    static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    void Start();
+    void Stop();
+    void Record(const char* name, int64_t start, int64_t duration);
+    std::vector<TraceEvent> GetEvents(std::vector<int>* threads = nullptr);
+    bool Write(const wxString& filename);
+
+    /**
+     * Get the current time on the clock zones are timed with
+     * @return Time in nanoseconds
+     */
+    static int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/**
+ * @class TraceZone
+ * @brief Records the time from its construction to its destruction.
+ *
+ * Use through AQUARIUM_TRACE_ZONE rather than directly, so
+ * zones go away when tracing is not built in.
+ */
+class TraceZone
+{
+private:
+    /// Name of the zone, nullptr if not recording
+    const char* mName = nullptr;
+
+    /// When the zone was entered
+    int64_t mStart = 0;
+
+public:
+    /**
+     * Constructor
+     * @param name Name of the zone, which must be a string literal
+     */
+    explicit TraceZone(const char* name)
+    {
+        if (Tracer::IsEnabled())
+        {
+            mName = name;
+            mStart = Tracer::Now();
+        }
+    }
+
+    /**
+     * Destructor. Records the zone if we were recording when it started.
+     */
+    ~TraceZone()
+    {
+        if (mName != nullptr)
+        {
+            Tracer::Get().Record(mName, mStart, Tracer::Now() - mStart);
+        }
+    }
+
+    /// Copy constructor (disabled)
+    TraceZone(const TraceZone&) = delete;
+
+    /// Assignment operator (disabled)
+    void operator=(const TraceZone&) = delete;
+};
+
+/// Helpers that give each zone variable a unique name
+#define AQUARIUM_TRACE_JOIN2(a, b) a##b
+#define AQUARIUM_TRACE_JOIN(a, b) AQUARIUM_TRACE_JOIN2(a, b)
+
+/**
+ * Trace the rest of the enclosing scope
+ * @param name Name of the zone, a string literal
+ */
+#ifdef AQUARIUM_TRACING
+#define AQUARIUM_TRACE_ZONE(name) TraceZone AQUARIUM_TRACE_JOIN(traceZone, __LINE__)(name)
+#else
+#define AQUARIUM_TRACE_ZONE(name) ((void)0)
+#endif
+
+#endif //TRACER_H
@@ -21,6 +21,14 @@ enum IDs {
     IDM_ADDFISHANGEL,
     IDM_ADDFISHCARP,
     IDM_ADDDECORCASTLE,
+    IDM_PAUSE,
+    IDM_FRAMESTATS,
+    IDM_TRACE,
+    IDM_SAVETRACE,
+    IDM_ALLOCATIONS,
+    IDM_MEMORYUSAGE,
+    IDM_RECORDINPUT,
+    IDM_SAVEINPUT,
 };
 
 #endif //AQUARIUM_IDS_H
\ No newline at end of file
@@ -0,0 +1,261 @@
+/**
+ * @file AquariumBench.cpp
+ * @author Josh Thomas
+ *
+ * Benchmarks of the per-frame and per-click work on an Aquarium.
+ */
+
+#include <pch.h>
+#include "Population.h"
+#include <Aquarium.h>
+#include <InputReplay.h>
+#include <wx/filefn.h>
+#include <wx/dcmemory.h>
+
+using namespace std;
+
+/// Time step of one frame in seconds
+const double FrameTime = 1.0 / 30;
+
+/// Number of random points the hit test benchmark cycles through
+const int HitPoints = 1024;
+
+/**
+ * One frame of the simulation
+ * @param state Benchmark state
+ */
+static void BM_Update(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    for (auto _ : state)
+    {
+        aquarium.Update(FrameTime);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Update)->Apply(PopulationArgs);
+
+/**
+ * One frame of the simulation with the state hashed as it goes,
+ * to compare against BM_Update
+ * @param state Benchmark state
+ */
+static void BM_UpdateHashed(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+    aquarium.SetStateHashing(true);
+
+    for (auto _ : state)
+    {
+        aquarium.Update(FrameTime);
+        benchmark::DoNotOptimize(aquarium.GetTickHash());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UpdateHashed)->Apply(PopulationArgs);
+
+/**
+ * Finding the item under the mouse
+ * @param state Benchmark state
+ */
+static void BM_HitTest(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    vector<wxPoint> points;
+    for (int i = 0; i < HitPoints; i++)
+    {
+        points.push_back(wxPoint(aquarium.GetRandom()() % aquarium.GetWidth(),
+                                 aquarium.GetRandom()() % aquarium.GetHeight()));
+    }
+
+    int next = 0;
+    for (auto _ : state)
+    {
+        const auto& point = points[next];
+        benchmark::DoNotOptimize(aquarium.HitTest(point.x, point.y));
+        next = (next + 1) % HitPoints;
+    }
+}
+BENCHMARK(BM_HitTest)->Apply(PopulationArgs);
+
+/**
+ * Bringing a clicked item to the front
+ * @param state Benchmark state
+ */
+static void BM_MoveToEnd(benchmark::State& state)
+{
+    Aquarium aquarium;
+    auto items = Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    for (auto _ : state)
+    {
+        aquarium.MoveToEnd(items[aquarium.GetRandom()() % items.size()]);
+    }
+}
+BENCHMARK(BM_MoveToEnd)->Apply(PopulationArgs);
+
+/**
+ * Stretching a rubber band over the left half of the tank,
+ * one frame's selection with the items standing still
+ * @param state Benchmark state
+ */
+static void BM_RubberBand(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    ItemSelection selection;
+    wxRect band(0, 0, aquarium.GetWidth() / 2, aquarium.GetHeight());
+    for (auto _ : state)
+    {
+        selection.Clear();
+        aquarium.Select(band, &selection);
+    }
+
+    state.counters["selected"] = (double)selection.GetCount();
+}
+BENCHMARK(BM_RubberBand)->Apply(PopulationArgs);
+
+/**
+ * One frame of dragging every item at once
+ * @param state Benchmark state
+ */
+static void BM_GroupDrag(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    ItemSelection selection;
+    aquarium.Select(wxRect(0, 0, aquarium.GetWidth(), aquarium.GetHeight()), &selection);
+    double dx = 1;
+    for (auto _ : state)
+    {
+        aquarium.MoveBy(selection, dx, 0);
+        dx = -dx;
+    }
+
+    state.SetItemsProcessed(state.iterations() * selection.GetCount());
+}
+BENCHMARK(BM_GroupDrag)->Apply(PopulationArgs);
+
+/**
+ * Bringing a selection of a tenth of the items to the front
+ * @param state Benchmark state
+ */
+static void BM_MoveSelectionToEnd(benchmark::State& state)
+{
+    Aquarium aquarium;
+    auto items = Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    ItemSelection selection;
+    for (size_t i = 0; i < items.size(); i += 10)
+    {
+        selection.Add(items[i]->GetId());
+    }
+
+    for (auto _ : state)
+    {
+        aquarium.MoveToEnd(selection);
+    }
+}
+BENCHMARK(BM_MoveSelectionToEnd)->Apply(PopulationArgs);
+
+/**
+ * One pull from a Magnemo, which moves every other item
+ * @param state Benchmark state
+ */
+static void BM_PullFishTowards(benchmark::State& state)
+{
+    Aquarium aquarium;
+    auto items = Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    for (auto _ : state)
+    {
+        aquarium.PullFishTowards(items[0].get(), 1.0);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PullFishTowards)->Apply(PopulationArgs);
+
+/**
+ * Drawing a frame into a memory DC
+ * @param state Benchmark state
+ */
+static void BM_OnDraw(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+
+    wxBitmap frame(aquarium.GetWidth(), aquarium.GetHeight());
+    wxMemoryDC dc(frame);
+
+    for (auto _ : state)
+    {
+        aquarium.OnDraw(&dc);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OnDraw)->Apply(PopulationArgs)->Unit(benchmark::kMillisecond);
+
+/**
+ * Replaying a recorded drag of the front item across the tank,
+ * with the simulation stepped as it goes
+ * @param state Benchmark state
+ */
+static void BM_InputReplay(benchmark::State& state)
+{
+    auto filename = BenchmarkFile(L"bench-input.aqin");
+    {
+        Aquarium aquarium;
+        auto items = Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+        int x = (int)items.back()->GetX();
+        int y = (int)items.back()->GetY();
+
+        InputRecorder recorder;
+        recorder.Start(&aquarium, 1);
+        InputEvent event;
+        event.type = (uint16_t)InputEventType::LeftDown;
+        event.buttons = InputEvent::LeftButton;
+        event.x = x;
+        event.y = y;
+        recorder.Add(event);
+
+        // One move a frame for a second
+        event.type = (uint16_t)InputEventType::MouseMove;
+        for (int i = 1; i <= 30; i++)
+        {
+            event.time = (uint32_t)(i * FrameTime * 1000);
+            event.x = (x + i * 10) % aquarium.GetWidth();
+            recorder.Add(event);
+        }
+
+        event.type = (uint16_t)InputEventType::LeftUp;
+        event.buttons = 0;
+        recorder.Add(event);
+        recorder.Save(filename);
+    }
+
+    InputReplay replay;
+    replay.Load(filename);
+
+    Aquarium aquarium;
+    ReplayResult result;
+    for (auto _ : state)
+    {
+        replay.Run(&aquarium, &result);
+    }
+
+    state.counters["pick_ms"] = result.pick.GetAverage();
+    state.counters["drag_ms"] = result.drag.GetAverage();
+    wxRemoveFile(filename);
+}
+BENCHMARK(BM_InputReplay)->Apply(PopulationArgs)->Unit(benchmark::kMillisecond);
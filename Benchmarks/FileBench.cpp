@@ -0,0 +1,57 @@
+/**
+ * @file FileBench.cpp
+ * @author Josh Thomas
+ *
+ * Benchmarks of saving and loading .aqua files.
+ */
+
+#include <pch.h>
+#include "Population.h"
+#include <Aquarium.h>
+#include <wx/filefn.h>
+
+using namespace std;
+
+/**
+ * Saving an aquarium
+ * @param state Benchmark state
+ */
+static void BM_Save(benchmark::State& state)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+    auto filename = BenchmarkFile(L"bench-save.aqua");
+
+    for (auto _ : state)
+    {
+        aquarium.Save(filename);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    wxRemoveFile(filename);
+}
+BENCHMARK(BM_Save)->Apply(PopulationArgs)->Unit(benchmark::kMillisecond);
+
+/**
+ * Loading an aquarium
+ * @param state Benchmark state
+ */
+static void BM_Load(benchmark::State& state)
+{
+    auto filename = BenchmarkFile(L"bench-load.aqua");
+    {
+        Aquarium aquarium;
+        Populate(&aquarium, (int)state.range(0), (SpeciesMix)state.range(1));
+        aquarium.Save(filename);
+    }
+
+    Aquarium aquarium;
+    for (auto _ : state)
+    {
+        aquarium.Load(filename);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    wxRemoveFile(filename);
+}
+BENCHMARK(BM_Load)->Apply(PopulationArgs)->Unit(benchmark::kMillisecond);
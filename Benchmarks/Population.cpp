@@ -0,0 +1,72 @@
+/**
+ * @file Population.cpp
+ * @author Josh Thomas
+ */
+
+#include <pch.h>
+#include "Population.h"
+#include <Aquarium.h>
+#include <SceneGenerator.h>
+#include <wx/filename.h>
+
+using namespace std;
+
+/// Tags of the species in each mix, indexed by SpeciesMix
+const vector<vector<wstring>> MixTags = {
+    {L"beta", L"carp", L"catfish", L"castle"},
+    {L"beta", L"carp", L"catfish"},
+    {L"castle"},
+};
+
+/**
+ * Fill an aquarium with items at random locations.
+ *
+ * The population is a SceneGenerator scene with the default
+ * seed, so every run builds the same population.
+ *
+ * @param aquarium Aquarium to fill
+ * @param count Number of items
+ * @param mix The species to use
+ * @return The items, in the order they were added
+ */
+std::vector<std::shared_ptr<Item>> Populate(Aquarium* aquarium, int count, SpeciesMix mix)
+{
+    const auto& tags = MixTags[(int)mix];
+    int species = (int)tags.size();
+
+    SceneGenerator scene;
+    for (int i = 0; i < species; i++)
+    {
+        scene.SetCount(tags[i], count / species + (i < count % species ? 1 : 0));
+    }
+
+    return scene.Generate(aquarium);
+}
+
+/**
+ * Run a benchmark over every population size from
+ * 10 to 1,000,000 items and every species mix
+ * @param bench The benchmark
+ */
+void PopulationArgs(benchmark::internal::Benchmark* bench)
+{
+    bench->ArgNames({"items", "mix"});
+    bench->ArgsProduct({benchmark::CreateRange(10, 1000000, 10),
+                        {(int)SpeciesMix::All, (int)SpeciesMix::Fish, (int)SpeciesMix::Decor}});
+}
+
+/**
+ * Get a path to a temporary file for a benchmark
+ * @param name Name of the file
+ * @return Full path
+ */
+wxString BenchmarkFile(const wxString& name)
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    return path + L"/" + name;
+}
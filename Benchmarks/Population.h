@@ -0,0 +1,32 @@
+/**
+ * @file Population.h
+ * @author Josh Thomas
+ * @brief Seeded aquarium populations shared by the benchmarks.
+ */
+
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+class Aquarium;
+class Item;
+
+/**
+ * The species a population is made of. The
+ * benchmark argument is the enum value.
+ */
+enum class SpeciesMix
+{
+    All,        ///< Every registered species in turn
+    Fish,       ///< Fish only, so every item animates
+    Decor       ///< Decor only, nothing animates
+};
+
+std::vector<std::shared_ptr<Item>> Populate(Aquarium* aquarium, int count, SpeciesMix mix);
+void PopulationArgs(benchmark::internal::Benchmark* bench);
+wxString BenchmarkFile(const wxString& name);
+
+#endif //POPULATION_H
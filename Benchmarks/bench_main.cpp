@@ -0,0 +1,16 @@
+#include <pch.h>
+#include <benchmark/benchmark.h>
+#include <wx/filefn.h>
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    wxSetWorkingDirectory(L"..");
+    wxInitAllImageHandlers();
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
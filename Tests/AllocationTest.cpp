@@ -0,0 +1,106 @@
+/**
+ * @file AllocationTest.cpp
+ * @author Josh Thomas
+ *
+ * Allocations can only be counted when the library is built with
+ * AQUARIUM_ALLOCATION_TRACKING, which is off by default. The dev
+ * preset turns it on, and is how the tests are meant to be run:
+ *
+ *     cmake --preset dev
+ *     cmake --build --preset dev
+ *     ctest --preset dev
+ *
+ * In other builds these tests are skipped.
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <AllocationTracker.h>
+#include <DrawListRenderer.h>
+#include <memory>
+#include "TestHelpers.h"
+
+using namespace std;
+
+/// Time step of one frame in seconds
+const double TickTime = 1.0 / 30;
+
+/**
+ * Renderer that draws nothing. What a wxDC allocates
+ * inside wxWidgets is not ours to keep steady.
+ */
+class NullRenderer : public DrawListRenderer
+{
+public:
+    /// Commands seen by the last Render
+    size_t mCount = 0;
+
+    /**
+     * Count the commands instead of drawing them
+     * @param list The list to draw
+     */
+    void Render(const DrawList& list) override { mCount = list.GetCount(); }
+};
+
+TEST(AllocationTest, Counts)
+{
+    if (!AllocationTracker::IsBuiltIn())
+    {
+        GTEST_SKIP() << "Built without AQUARIUM_ALLOCATION_TRACKING. Use the dev preset: ctest --preset dev";
+    }
+
+    AllocationTracker::Reset();
+    AllocationTracker::Start();
+    auto before = AllocationTracker::GetCounts();
+    {
+        AllocationScope scope(AllocationSubsystem::File);
+        auto value = make_unique<int[]>(100);
+        ASSERT_NE(nullptr, value.get());
+    }
+    auto made = AllocationTracker::GetCounts() - before;
+    AllocationTracker::Stop();
+
+    const auto& file = made.subsystems[(int)AllocationSubsystem::File];
+    ASSERT_EQ(1u, file.allocations);
+    ASSERT_EQ(100 * sizeof(int), file.bytes);
+    ASSERT_EQ(0u, made.subsystems[(int)AllocationSubsystem::Update].allocations);
+    ASSERT_EQ(1u, made.GetTotal().allocations);
+
+    // Nothing is counted once stopped
+    auto value = make_unique<int>(7);
+    ASSERT_EQ(1u, AllocationTracker::Get(AllocationSubsystem::File).allocations);
+
+    ASSERT_EQ(L"1 allocs, 400 B (File 1)", AllocationTracker::Format(made));
+}
+
+TEST(AllocationTest, SteadyStateTick)
+{
+    if (!AllocationTracker::IsBuiltIn())
+    {
+        GTEST_SKIP() << "Built without AQUARIUM_ALLOCATION_TRACKING. Use the dev preset: ctest --preset dev";
+    }
+
+    Aquarium aquarium;
+    Populate(&aquarium, 400);
+
+    // The first frames size the draw list and build the atlas
+    NullRenderer renderer;
+    for (int i = 0; i < 3; i++)
+    {
+        aquarium.Update(TickTime);
+        aquarium.OnDraw(&renderer);
+    }
+    ASSERT_GT(renderer.mCount, 0u);
+
+    AllocationTracker::Reset();
+    AllocationTracker::Start();
+    for (int i = 0; i < 300; i++)
+    {
+        aquarium.Update(TickTime);
+        aquarium.OnDraw(&renderer);
+    }
+    AllocationTracker::Stop();
+
+    auto counts = AllocationTracker::GetCounts();
+    ASSERT_EQ(0u, counts.GetTotal().allocations) << AllocationTracker::Format(counts);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file AquaXmlReaderTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <AquaXmlReader.h>
+#include <wx/mstream.h>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * Read a document from a string
+ * @param xml The document
+ * @param types Receives the type attribute of each item
+ * @return true if the document was read
+ */
+static bool ReadString(const char* xml, vector<wxString>* types)
+{
+    wxMemoryInputStream stream(xml, strlen(xml));
+    AquaXmlReader reader;
+    return reader.Read(stream, [types](wxXmlNode* node) {
+        types->push_back(node->GetAttribute(L"type"));
+    });
+}
+
+TEST(AquaXmlReaderTest, Items)
+{
+    vector<wxString> types;
+    ASSERT_TRUE(ReadString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                           "<aqua><item x=\"100.000000\" y=\"200.000000\" type=\"beta\"/>"
+                           "<!-- comment --><item type='castle'></item></aqua>\n", &types));
+    ASSERT_EQ(2u, types.size());
+    ASSERT_EQ(L"beta", types[0]);
+    ASSERT_EQ(L"castle", types[1]);
+}
+
+TEST(AquaXmlReaderTest, Empty)
+{
+    vector<wxString> types;
+    ASSERT_TRUE(ReadString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<aqua/>\n", &types));
+    ASSERT_TRUE(types.empty());
+}
+
+TEST(AquaXmlReaderTest, References)
+{
+    vector<wxString> types;
+    ASSERT_TRUE(ReadString("<aqua><item type=\"&lt;&#65;&#x42;&amp;&quot;\"/></aqua>", &types));
+    ASSERT_EQ(L"<AB&\"", types[0]);
+}
+
+TEST(AquaXmlReaderTest, OnlyTopLevelItems)
+{
+    // Items nested inside other elements are not aquarium items
+    vector<wxString> types;
+    ASSERT_TRUE(ReadString("<aqua><group><item type=\"beta\"/></group>"
+                           "<item type=\"carp\"><item type=\"beta\"/></item></aqua>", &types));
+    ASSERT_EQ(1u, types.size());
+    ASSERT_EQ(L"carp", types[0]);
+}
+
+TEST(AquaXmlReaderTest, Malformed)
+{
+    vector<wxString> types;
+    ASSERT_FALSE(ReadString("", &types));
+    ASSERT_FALSE(ReadString("not xml", &types));
+    ASSERT_FALSE(ReadString("<aqua><item type=\"beta\"></aqua>", &types));
+    ASSERT_FALSE(ReadString("<aqua><item type=\"beta\"/>", &types));
+    ASSERT_FALSE(ReadString("<aqua><item x=\"1\" x=\"2\"/></aqua>", &types));
+    ASSERT_FALSE(ReadString("<aqua/><aqua/>", &types));
+    ASSERT_FALSE(ReadString("<aqua><item type=\"&bogus;\"/></aqua>", &types));
+}
+
+TEST(AquaXmlReaderTest, Encoding)
+{
+    vector<wxString> types;
+    ASSERT_TRUE(ReadString("<?xml version=\"1.0\" encoding='utf-8'?><aqua/>", &types));
+    ASSERT_TRUE(ReadString("<?xml version=\"1.0\" encoding=\"US-ASCII\" standalone=\"yes\"?><aqua/>", &types));
+    ASSERT_TRUE(ReadString("<?xml version=\"1.0\"?><?other ignored?><?empty?><aqua/>", &types));
+
+    // Other encodings are read as wxXmlDocument reads them
+    ASSERT_TRUE(ReadString("<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>"
+                           "<aqua><item type=\"caf\xe9\"/></aqua>", &types));
+    ASSERT_TRUE(ReadString("<?xml version=\"1.0\" encoding=\"windows-1252\"?>"
+                           "<aqua><item type=\"\x80\"/></aqua>", &types));
+    ASSERT_EQ(2u, types.size());
+    ASSERT_EQ(L"caf\u00e9", types[0]);
+    ASSERT_EQ(L"\u20ac", types[1]);
+
+    ASSERT_FALSE(ReadString("<?xml version=\"1.0\" encoding=\"no-such-encoding\"?><aqua/>", &types));
+    ASSERT_FALSE(ReadString("<?xml version=\"1.0\" encoding?><aqua/>", &types));
+}
@@ -10,10 +10,13 @@
 #include "FishCatfish.h"
 #include "FishCarp.h"
 #include "DecorCastle.h"
+#include <BackgroundSaver.h>
 #include <regex>
 #include <string>
 #include <fstream>
 #include <streambuf>
+#include <filesystem>
+#include "TestHelpers.h"
 #include <wx/filename.h>
 
 using namespace std;
@@ -23,21 +26,6 @@ const unsigned int RandomSeed = 1238197374;
 class AquariumTest : public ::testing::Test
 {
 protected:
-    /**
-     * Create a path to a place to put temporary files
-     */
-    wxString TempPath()
-    {
-        // Create a temporary filename we can use
-        auto path = wxFileName::GetTempDir() + L"/aquarium";
-        if (!wxFileName::DirExists(path))
-        {
-            wxFileName::Mkdir(path);
-        }
-
-        return path;
-    }
-
     /**
      * Test to ensure an aquarium .aqua file is empty
      */
@@ -250,6 +238,57 @@ TEST_F(AquariumTest, HitTest)
     ASSERT_TRUE(aquarium.HitTest(100, 200) == fish1) << L"Testing fish at 100, 200";
 }
 
+TEST_F(AquariumTest, Animating)
+{
+    Aquarium aquarium;
+    ASSERT_FALSE(aquarium.IsAnimating()) << L"Empty aquarium is static";
+
+    // Decor alone does not animate
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+    ASSERT_FALSE(aquarium.IsAnimating());
+
+    aquarium.Add(make_shared<FishBeta>(&aquarium));
+    ASSERT_TRUE(aquarium.IsAnimating());
+
+    // A paused aquarium is static
+    aquarium.SetPaused(true);
+    ASSERT_FALSE(aquarium.IsAnimating());
+    aquarium.SetPaused(false);
+
+    aquarium.Clear();
+    ASSERT_FALSE(aquarium.IsAnimating());
+}
+
+TEST_F(AquariumTest, Random)
+{
+    Aquarium aquarium;
+    aquarium.Seed(1);
+
+    // Pinned, so a seed makes the same scene with any standard library
+    ASSERT_DOUBLE_EQ(0.417022004702574, aquarium.Random(0, 1));
+
+    for (int i = 0; i < 1000; i++)
+    {
+        auto value = aquarium.Random(20, 50);
+        ASSERT_GE(value, 20);
+        ASSERT_LT(value, 50);
+    }
+
+    // Normal numbers centre on 0 with the given spread
+    double sum = 0;
+    double squares = 0;
+    const int count = 10000;
+    for (int i = 0; i < count; i++)
+    {
+        auto value = aquarium.RandomNormal(3);
+        sum += value;
+        squares += value * value;
+    }
+
+    ASSERT_NEAR(0, sum / count, 0.1);
+    ASSERT_NEAR(3, sqrt(squares / count), 0.1);
+}
+
 TEST(FishBetaTest, HitTestWithOverlappingFish)
 {
     Aquarium aquarium;
@@ -300,6 +339,222 @@ TEST_F(AquariumTest, Save)
     TestAllTypes(file3);
 }
 
+TEST_F(AquariumTest, SaveMatchesXmlDocument)
+{
+    auto path = TempPath();
+    auto domFile = path + L"/test_dom.aqua";
+    auto streamFile = path + L"/test_stream.aqua";
+
+    // An empty aquarium
+    Aquarium aquarium;
+    wxXmlDocument xmlDoc;
+    auto root = new wxXmlNode(wxXML_ELEMENT_NODE, L"aqua");
+    xmlDoc.SetRoot(root);
+
+    aquarium.Save(streamFile);
+    ASSERT_TRUE(xmlDoc.Save(domFile, wxXML_NO_INDENTATION));
+    ASSERT_EQ(ReadFile(domFile), ReadFile(streamFile)) << L"Empty aquarium";
+
+    // One of each type, saved the old way through wxXmlDocument
+    vector<shared_ptr<Item>> items = {make_shared<FishBeta>(&aquarium), make_shared<FishCarp>(&aquarium),
+                                      make_shared<FishCatfish>(&aquarium), make_shared<DecorCastle>(&aquarium)};
+    double location = -12.3456785;
+    for (const auto& item : items)
+    {
+        item->SetLocation(location, location * -7.25);
+        location *= 3.5;
+        aquarium.Add(item);
+
+        ItemRecord record;
+        item->SaveRecord(&record);
+        auto node = new wxXmlNode(wxXML_ELEMENT_NODE, L"item");
+        node->AddAttribute(L"x", wxString::Format(L"%.6f", record.x));
+        node->AddAttribute(L"y", wxString::Format(L"%.6f", record.y));
+        node->AddAttribute(L"type", item->GetType());
+        if (record.flags & ItemRecord::Swims)
+        {
+            node->AddAttribute(L"speedx", wxString::Format(L"%.6f", record.speedX));
+            node->AddAttribute(L"speedy", wxString::Format(L"%.6f", record.speedY));
+        }
+        root->AddChild(node);
+    }
+
+    aquarium.Save(streamFile);
+    ASSERT_TRUE(xmlDoc.Save(domFile, wxXML_NO_INDENTATION));
+    ASSERT_EQ(ReadFile(domFile), ReadFile(streamFile)) << L"One of each type";
+}
+
+TEST_F(AquariumTest, BackgroundSave)
+{
+    auto path = TempPath();
+    auto directFile = path + L"/test_direct.aqua";
+    auto backgroundFile = path + L"/test_background.aqua";
+
+    Aquarium aquarium;
+    auto fish = make_shared<FishCarp>(&aquarium);
+    fish->SetLocation(123, 456);
+    aquarium.Add(fish);
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+    aquarium.Save(directFile);
+
+    AquaSnapshot snapshot;
+    aquarium.TakeSnapshot(&snapshot);
+
+    // Changes after the snapshot is taken are not saved
+    fish->SetLocation(0, 0);
+
+    BackgroundSaver saver;
+    ASSERT_TRUE(saver.Start(backgroundFile, BackgroundSaver::Format::Xml, std::move(snapshot)));
+    saver.Wait();
+    ASSERT_FALSE(saver.IsBusy());
+
+    ASSERT_EQ(ReadFile(directFile), ReadFile(backgroundFile));
+    ASSERT_FALSE(wxFileName::FileExists(backgroundFile + L".saving")) << L"Temporary file is removed";
+
+    // Binary saves load back the same items
+    aquarium.TakeSnapshot(&snapshot);
+    ASSERT_TRUE(BackgroundSaver::WriteFile(backgroundFile, snapshot, BackgroundSaver::Format::Binary));
+
+    Aquarium loaded;
+    loaded.Load(backgroundFile);
+    AquaSnapshot reloaded;
+    loaded.TakeSnapshot(&reloaded);
+    ASSERT_EQ(snapshot.species, reloaded.species);
+    ASSERT_EQ(2u, reloaded.records.size());
+    ASSERT_EQ(0, reloaded.records[0].x);
+    ASSERT_EQ(0, reloaded.records[0].y);
+}
+
+TEST_F(AquariumTest, Journal)
+{
+    auto path = TempPath();
+    auto journalFile = path + L"/test_journal.aqua";
+
+    Aquarium aquarium;
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+    ASSERT_TRUE(aquarium.StartJournal(journalFile));
+    ASSERT_TRUE(aquarium.IsJournaling());
+
+    // Edits after the checkpoint only go to the journal
+    auto carp = make_shared<FishCarp>(&aquarium);
+    carp->SetLocation(100, 200);
+    aquarium.Add(carp);
+    auto catfish = make_shared<FishCatfish>(&aquarium);
+    aquarium.Add(catfish);
+    aquarium.MoveToEnd(carp);
+    aquarium.ToggleState(catfish);
+    carp->SetLocation(300, 400);
+    aquarium.ItemMoved(carp);
+    carp->SetLocation(500, 600);
+    aquarium.ItemMoved(carp);
+
+    AquaSnapshot expected;
+    aquarium.TakeSnapshot(&expected);
+
+    Aquarium recovered;
+    recovered.Load(journalFile);
+    AquaSnapshot actual;
+    recovered.TakeSnapshot(&actual);
+
+    ASSERT_EQ(expected.species, actual.species);
+    ASSERT_EQ(expected.records.size(), actual.records.size());
+    for (size_t i = 0; i < expected.records.size(); i++)
+    {
+        ASSERT_EQ(0, memcmp(&expected.records[i], &actual.records[i], sizeof(ItemRecord))) << L"Record " << i;
+    }
+
+    // A torn write at the end loses only the last edit
+    aquarium.StopJournal();
+    auto journalPath = journalFile.ToStdString();
+    filesystem::resize_file(journalPath, filesystem::file_size(journalPath) - 8);
+
+    Aquarium torn;
+    torn.Load(journalFile);
+    torn.TakeSnapshot(&actual);
+    ASSERT_EQ(3u, actual.records.size());
+    ASSERT_EQ(300, actual.records[2].x);
+    ASSERT_EQ(400, actual.records[2].y);
+}
+
+TEST_F(AquariumTest, JournalCheckpoint)
+{
+    auto journalFile = TempPath() + L"/test_journal_checkpoint.aqua";
+
+    Aquarium aquarium;
+    auto carp = make_shared<FishCarp>(&aquarium);
+    aquarium.Add(carp);
+    ASSERT_TRUE(aquarium.StartJournal(journalFile));
+
+    // Enough edits to outgrow the checkpoint, so a new one is written
+    // in the background while the edits after it keep arriving
+    for (int i = 0; i < 2000; i++)
+    {
+        carp->SetLocation(i, i * 2);
+        aquarium.ItemMoved(carp);
+        if (i % 100 == 0)
+        {
+            aquarium.Update(0);
+        }
+    }
+
+    aquarium.StopJournal();
+    ASSERT_FALSE(wxFileExists(journalFile + TempSaveSuffix));
+    ASSERT_LT(filesystem::file_size(journalFile.ToStdString()), 2000 * sizeof(JournalEntry));
+
+    Aquarium recovered;
+    ASSERT_TRUE(recovered.Load(journalFile));
+    AquaSnapshot actual;
+    recovered.TakeSnapshot(&actual);
+    ASSERT_EQ(1u, actual.records.size());
+    ASSERT_EQ(1999, actual.records[0].x);
+    ASSERT_EQ(3998, actual.records[0].y);
+}
+
+TEST_F(AquariumTest, JournalGroup)
+{
+    auto journalFile = TempPath() + L"/test_journal_group.aqua";
+
+    // Every third item is selected
+    Aquarium aquarium;
+    ItemSelection selection;
+    for (int i = 0; i < 40; i++)
+    {
+        auto carp = make_shared<FishCarp>(&aquarium);
+        carp->SetLocation(i * 10, i * 5);
+        aquarium.Add(carp);
+        if (i % 3 == 0)
+        {
+            selection.Add(carp->GetId());
+        }
+    }
+
+    ASSERT_TRUE(aquarium.StartJournal(journalFile));
+    auto before = filesystem::file_size(journalFile.ToStdString());
+
+    // Bring the selection to the front and drag it
+    aquarium.MoveToEnd(selection);
+    aquarium.MoveBy(selection, 50, 25);
+    aquarium.ItemsMoved(selection);
+
+    // One entry for each item moved to the front and each item dropped
+    auto entries = selection.GetCount() * 2;
+    ASSERT_EQ(before + entries * sizeof(JournalEntry), filesystem::file_size(journalFile.ToStdString()));
+
+    AquaSnapshot expected;
+    aquarium.TakeSnapshot(&expected);
+    aquarium.StopJournal();
+
+    Aquarium recovered;
+    ASSERT_TRUE(recovered.Load(journalFile));
+    AquaSnapshot actual;
+    recovered.TakeSnapshot(&actual);
+    ASSERT_EQ(expected.records.size(), actual.records.size());
+    for (size_t i = 0; i < expected.records.size(); i++)
+    {
+        ASSERT_EQ(0, memcmp(&expected.records[i], &actual.records[i], sizeof(ItemRecord))) << L"Record " << i;
+    }
+}
+
 TEST_F(AquariumTest, Clear)
 {
     Aquarium aquarium;
@@ -386,3 +641,52 @@ TEST_F(AquariumTest, Load)
     TestAllTypesForLoad(file3);  // Test after load
 }
 
+TEST_F(AquariumTest, LoadBinary)
+{
+    auto path = TempPath();
+
+    // Save all types in the binary format
+    Aquarium aquarium;
+    PopulateAllTypes(&aquarium);
+    auto binary = path + L"/test_binary.aqua";
+    aquarium.SaveBinary(binary);
+
+    // Load detects the format, then save as XML to check what we got
+    Aquarium aquarium2;
+    aquarium2.Load(binary);
+    auto xml = path + L"/test_binary_check.aqua";
+    aquarium2.Save(xml);
+    TestAllTypes(xml);
+
+    // A binary file round trips per-species state too
+    AquaSnapshot before;
+    AquaSnapshot after;
+    aquarium.TakeSnapshot(&before);
+    aquarium2.TakeSnapshot(&after);
+    ASSERT_EQ(before.species, after.species);
+    ASSERT_EQ(before.records.size(), after.records.size());
+    for (size_t i = 0; i < before.records.size(); i++)
+    {
+        ASSERT_EQ(0, memcmp(&before.records[i], &after.records[i], sizeof(ItemRecord)));
+    }
+}
+
+
+TEST_F(AquariumTest, LoadMissing)
+{
+    // A file that cannot be read is reported, and the aquarium is left alone
+    Aquarium aquarium;
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+    ASSERT_FALSE(aquarium.Load(TempPath() + L"/missing.aqua"));
+    ASSERT_EQ(1u, aquarium.GetItemCount());
+}
+
+TEST_F(AquariumTest, SaveFailure)
+{
+    // A file that cannot be written is reported to the caller
+    Aquarium aquarium;
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+    ASSERT_FALSE(aquarium.Save(TempPath() + L"/missing/test.aqua"));
+    ASSERT_FALSE(aquarium.SaveBinary(TempPath() + L"/missing/test.aqb"));
+    ASSERT_TRUE(aquarium.Save(TempPath() + L"/test_save_ok.aqua"));
+}
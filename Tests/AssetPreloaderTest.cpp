@@ -0,0 +1,88 @@
+/**
+ * @file AssetPreloaderTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <AssetPreloader.h>
+#include <SpriteLibrary.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace std;
+
+/**
+ * Wait for the preloader to finish, or give up after a while
+ * @return true if it finished
+ */
+static bool WaitForPreload()
+{
+    for (int i = 0; i < 500 && AssetPreloader::Get().IsBusy(); i++)
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+
+    return !AssetPreloader::Get().IsBusy();
+}
+
+TEST(AssetPreloaderTest, Manifest)
+{
+    auto files = AssetPreloader::ReadManifest(AssetManifestName);
+    ASSERT_FALSE(files.empty());
+
+    // Every image the aquarium ships is in the manifest
+    for (const auto& entry : filesystem::directory_iterator("images"))
+    {
+        if (entry.path().extension() != ".png")
+        {
+            continue;
+        }
+
+        auto name = L"images/" + entry.path().filename().wstring();
+        ASSERT_NE(find(files.begin(), files.end(), name), files.end()) << name;
+    }
+
+    // And everything in the manifest exists
+    for (const auto& file : files)
+    {
+        ASSERT_TRUE(filesystem::exists(file)) << file;
+    }
+
+    ASSERT_TRUE(AssetPreloader::ReadManifest(L"images/missing.txt").empty());
+}
+
+TEST(AssetPreloaderTest, Preload)
+{
+    auto files = AssetPreloader::ReadManifest(AssetManifestName);
+    AssetPreloader::Get().Start(files, 2);
+    ASSERT_TRUE(WaitForPreload());
+
+    for (const auto& file : files)
+    {
+        wxImage image;
+        ASSERT_EQ(AssetPreloader::State::Ready, AssetPreloader::Get().Take(file, &image)) << file;
+        ASSERT_EQ(image.GetWidth(), wxImage(file).GetWidth());
+        ASSERT_EQ(image.GetHeight(), wxImage(file).GetHeight());
+    }
+
+    // A sprite library uses the preloaded images
+    SpriteLibrary sprites;
+    auto carp = sprites.Load(L"images/carp.png");
+    ASSERT_TRUE(carp->ready);
+    ASSERT_TRUE(sprites.IsReady());
+    ASSERT_EQ(wxImage(L"images/carp.png").GetWidth(), carp->width);
+
+    // Files that are not in the manifest are not preloaded
+    wxImage image;
+    ASSERT_EQ(AssetPreloader::State::Unknown, AssetPreloader::Get().Take(L"images/missing.png", &image));
+
+    AssetPreloader::Get().Stop();
+    ASSERT_EQ(AssetPreloader::State::Unknown, AssetPreloader::Get().Take(files[0], &image));
+
+    // Without the preloader, images still load on the spot
+    SpriteLibrary direct;
+    ASSERT_TRUE(direct.Load(L"images/carp.png")->ready);
+    ASSERT_EQ(carp->width, direct.Load(L"images/carp.png")->width);
+}
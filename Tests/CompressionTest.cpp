@@ -0,0 +1,79 @@
+/**
+ * @file CompressionTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(CompressionTest, RoundTrip)
+{
+    auto plainFile = TempPath() + L"/test_plain.aqua";
+    auto compressedFile = TempPath() + L"/test_compressed.aqua.gz";
+
+    Aquarium aquarium;
+    Populate(&aquarium, 200);
+    aquarium.Save(plainFile);
+    aquarium.Save(compressedFile);
+
+    // The extension picks gzip, and it is worth it
+    ifstream file(compressedFile.ToStdString(), ios::binary);
+    ASSERT_EQ(0x1f, file.get());
+    ASSERT_EQ(0x8b, file.get());
+    ASSERT_LT(filesystem::file_size(compressedFile.ToStdString()), filesystem::file_size(plainFile.ToStdString()));
+
+    AquaSnapshot expected;
+    aquarium.TakeSnapshot(&expected);
+
+    Aquarium loaded;
+    loaded.Load(compressedFile);
+    AquaSnapshot actual;
+    loaded.TakeSnapshot(&actual);
+
+    ASSERT_EQ(expected.species, actual.species);
+    ASSERT_EQ(expected.records.size(), actual.records.size());
+    for (size_t i = 0; i < expected.records.size(); i++)
+    {
+        ASSERT_EQ(expected.records[i].x, actual.records[i].x);
+        ASSERT_EQ(expected.records[i].y, actual.records[i].y);
+        ASSERT_EQ(expected.records[i].speedX, actual.records[i].speedX);
+    }
+}
+
+/**
+ * File size and save and load times of 100,000 items, plain XML
+ * against gzip. Run with --gtest_also_run_disabled_tests.
+ */
+TEST(CompressionTest, DISABLED_Benchmark)
+{
+    const int Items = 100000;
+
+    Aquarium aquarium;
+    Populate(&aquarium, Items);
+
+    for (auto filename : {TempPath() + L"/bench.aqua", TempPath() + L"/bench.aqua.gz"})
+    {
+        auto start = chrono::steady_clock::now();
+        aquarium.Save(filename);
+        auto saved = chrono::steady_clock::now();
+
+        Aquarium loaded;
+        loaded.Load(filename);
+        auto done = chrono::steady_clock::now();
+
+        AquaSnapshot snapshot;
+        loaded.TakeSnapshot(&snapshot);
+        ASSERT_EQ((size_t)Items, snapshot.records.size());
+
+        cout << filename << ": " << filesystem::file_size(filename.ToStdString()) << " bytes, save "
+             << chrono::duration<double, milli>(saved - start).count() << " ms, load "
+             << chrono::duration<double, milli>(done - saved).count() << " ms" << endl;
+    }
+}
@@ -0,0 +1,88 @@
+/**
+ * @file DrawListTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+#include <DrawList.h>
+
+using namespace std;
+
+TEST(DrawListTest, Empty)
+{
+    Aquarium aquarium;
+    const auto& list = aquarium.RecordDrawList();
+
+    // Only the background
+    ASSERT_EQ(1u, list.GetCount());
+    ASSERT_EQ(1u, list.GetBatches().size());
+    ASSERT_EQ(0, list.GetCommands()[0].x);
+    ASSERT_EQ(0, list.GetCommands()[0].y);
+}
+
+TEST(DrawListTest, BatchSeparated)
+{
+    Aquarium aquarium;
+
+    // Beta, castle, beta with nothing overlapping. The second
+    // beta can safely be drawn in the same batch as the first.
+    auto beta1 = make_shared<FishBeta>(&aquarium);
+    beta1->SetLocation(100, 100);
+    aquarium.Add(beta1);
+
+    auto castle = make_shared<DecorCastle>(&aquarium);
+    castle->SetLocation(600, 500);
+    aquarium.Add(castle);
+
+    auto beta2 = make_shared<FishBeta>(&aquarium);
+    beta2->SetLocation(100, 400);
+    aquarium.Add(beta2);
+
+    const auto& list = aquarium.RecordDrawList();
+    ASSERT_EQ(4u, list.GetCount());
+    ASSERT_EQ(3u, list.GetBatches().size());
+
+    const auto& batch = list.GetBatches()[1];
+    ASSERT_EQ(beta1->GetSprite()->id, batch.sprite);
+    ASSERT_EQ(2u, batch.count);
+}
+
+TEST(DrawListTest, BatchKeepsOverlapOrder)
+{
+    Aquarium aquarium;
+
+    // The castle overlaps the second beta, so the
+    // second beta must still be drawn after it
+    auto beta1 = make_shared<FishBeta>(&aquarium);
+    beta1->SetLocation(100, 100);
+    aquarium.Add(beta1);
+
+    auto castle = make_shared<DecorCastle>(&aquarium);
+    castle->SetLocation(400, 400);
+    aquarium.Add(castle);
+
+    auto beta2 = make_shared<FishBeta>(&aquarium);
+    beta2->SetLocation(400, 400);
+    aquarium.Add(beta2);
+
+    const auto& list = aquarium.RecordDrawList();
+    ASSERT_EQ(4u, list.GetBatches().size());
+    ASSERT_EQ(3u, list.GetCommands().back().z);
+}
+
+TEST(DrawListTest, Compare)
+{
+    Aquarium aquarium;
+    auto beta = make_shared<FishBeta>(&aquarium);
+    beta->SetLocation(100, 100);
+    aquarium.Add(beta);
+
+    DrawList first = aquarium.RecordDrawList();
+    ASSERT_TRUE(first == aquarium.RecordDrawList()) << L"Nothing changed";
+
+    beta->SetLocation(110, 100);
+    ASSERT_FALSE(first == aquarium.RecordDrawList()) << L"Beta moved";
+}
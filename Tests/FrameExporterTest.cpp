@@ -0,0 +1,41 @@
+/**
+ * @file FrameExporterTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <DecorCastle.h>
+#include <FrameExporter.h>
+#include <wx/filename.h>
+
+using namespace std;
+
+TEST(FrameExporterTest, ExportPng)
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium/frames";
+
+    Aquarium aquarium;
+    auto fish = make_shared<FishBeta>(&aquarium);
+    fish->SetLocation(300, 300);
+    aquarium.Add(fish);
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+
+    FrameExporter exporter(&aquarium);
+    exporter.SetThreads(2);
+    ASSERT_TRUE(exporter.ExportPng(path, 5));
+
+    for (int frame = 0; frame < 5; frame++)
+    {
+        auto filename = FrameExporter::FrameFilename(path, frame);
+        ASSERT_TRUE(wxFileName::FileExists(filename)) << filename;
+
+        wxImage image(filename, wxBITMAP_TYPE_PNG);
+        ASSERT_EQ(aquarium.GetWidth(), image.GetWidth());
+        ASSERT_EQ(aquarium.GetHeight(), image.GetHeight());
+    }
+
+    // The fish moved while we were exporting
+    ASSERT_NE(300, fish->GetX());
+}
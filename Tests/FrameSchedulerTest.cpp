@@ -0,0 +1,78 @@
+/**
+ * @file FrameSchedulerTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <FrameScheduler.h>
+
+TEST(FrameSchedulerTest, Construct)
+{
+    FrameScheduler scheduler(50);
+    ASSERT_NEAR(50, scheduler.GetFrameRate(), 0.0001);
+    ASSERT_NEAR(20, scheduler.GetEffectiveInterval(), 0.0001);
+}
+
+TEST(FrameSchedulerTest, IdleWhenStatic)
+{
+    FrameScheduler scheduler(50);
+
+    // The first frame is always wanted
+    ASSERT_TRUE(scheduler.RequestRepaint(false));
+    scheduler.BeginFrame(0);
+    scheduler.EndFrame(2);
+
+    // Nothing moving and nothing invalidated, so no more frames
+    ASSERT_EQ(-1, scheduler.NextDelay(5, false));
+    ASSERT_FALSE(scheduler.RequestRepaint(false));
+
+    // Invalidating asks for one more frame
+    scheduler.Invalidate();
+    ASSERT_EQ(15, scheduler.NextDelay(5, false));
+    ASSERT_TRUE(scheduler.RequestRepaint(false));
+}
+
+TEST(FrameSchedulerTest, Coalesce)
+{
+    FrameScheduler scheduler(50);
+
+    ASSERT_TRUE(scheduler.RequestRepaint(true));
+
+    // A repaint is already queued, so do not queue another
+    scheduler.Invalidate();
+    ASSERT_FALSE(scheduler.RequestRepaint(true));
+
+    scheduler.BeginFrame(0);
+    scheduler.EndFrame(5);
+    ASSERT_TRUE(scheduler.RequestRepaint(true));
+}
+
+TEST(FrameSchedulerTest, HoldRate)
+{
+    FrameScheduler scheduler(50);
+
+    // Frames are measured from their start, so a frame
+    // that costs 5ms waits 15ms for the next one
+    scheduler.BeginFrame(100);
+    scheduler.EndFrame(105);
+    ASSERT_EQ(15, scheduler.NextDelay(105, true));
+    ASSERT_FALSE(scheduler.IsOverrunning());
+}
+
+TEST(FrameSchedulerTest, BackOff)
+{
+    FrameScheduler scheduler(50);
+
+    // Frames that take 40ms can't hold 50 fps
+    long time = 0;
+    for (int i = 0; i < 50; i++)
+    {
+        scheduler.BeginFrame(time);
+        time += 40;
+        scheduler.EndFrame(time);
+    }
+
+    ASSERT_TRUE(scheduler.IsOverrunning());
+    ASSERT_GT(scheduler.GetEffectiveInterval(), 40);
+    ASSERT_GT(scheduler.NextDelay(time, true), 0);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file FrameStatsTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <FrameStats.h>
+
+TEST(FrameStatsTest, Empty)
+{
+    FrameStats stats;
+    ASSERT_EQ(0u, stats.GetCount());
+    ASSERT_EQ(0, stats.GetFramesPerSecond());
+    ASSERT_EQ(0, stats.GetFramePercentile(50));
+    ASSERT_FALSE(stats.IsNearBudget(33));
+}
+
+TEST(FrameStatsTest, Percentiles)
+{
+    FrameStats stats(100);
+
+    // Frame times 1 to 100 ms, in a shuffled order, 20 ms apart
+    for (int i = 0; i < 100; i++)
+    {
+        double frame = (i * 37) % 100 + 1;
+        stats.AddFrame(i * 20.0, 0.5, 1.5, frame, 42);
+    }
+
+    ASSERT_EQ(100u, stats.GetCount());
+    ASSERT_EQ(42u, stats.GetItemCount());
+    ASSERT_DOUBLE_EQ(50, stats.GetFramePercentile(50));
+    ASSERT_DOUBLE_EQ(99, stats.GetFramePercentile(99));
+    ASSERT_DOUBLE_EQ(100, stats.GetFramePercentile(100));
+    ASSERT_DOUBLE_EQ(0.5, stats.GetAverageUpdate());
+    ASSERT_DOUBLE_EQ(1.5, stats.GetAverageDraw());
+    ASSERT_NEAR(50, stats.GetFramesPerSecond(), 0.001);
+    ASSERT_TRUE(stats.IsNearBudget(100));
+    ASSERT_FALSE(stats.IsNearBudget(1000));
+}
+
+TEST(FrameStatsTest, Window)
+{
+    FrameStats stats(10);
+
+    // Slow frames that then fall out of the window
+    for (int i = 0; i < 10; i++)
+    {
+        stats.AddFrame(i * 100.0, 0, 0, 90, 1);
+    }
+
+    for (int i = 10; i < 30; i++)
+    {
+        stats.AddFrame(1000 + (i - 10) * 10.0, 0, 0, 5, 1);
+    }
+
+    ASSERT_EQ(10u, stats.GetCount());
+    ASSERT_DOUBLE_EQ(5, stats.GetFramePercentile(99));
+    ASSERT_NEAR(100, stats.GetFramesPerSecond(), 0.001);
+    ASSERT_FALSE(stats.IsNearBudget(33));
+
+    stats.Clear();
+    ASSERT_EQ(0u, stats.GetCount());
+}
+
+TEST(FrameStatsTest, InputLatency)
+{
+    FrameStats stats(10);
+    ASSERT_EQ(0u, stats.GetLatencyCount());
+    ASSERT_EQ(0, stats.GetLatencyPercentile(99));
+
+    // Slow inputs that then fall out of the window
+    for (int i = 0; i < 10; i++)
+    {
+        stats.AddInputLatency(80);
+    }
+
+    for (int i = 1; i <= 10; i++)
+    {
+        stats.AddInputLatency(i);
+    }
+
+    ASSERT_EQ(10u, stats.GetLatencyCount());
+    ASSERT_DOUBLE_EQ(5, stats.GetLatencyPercentile(50));
+    ASSERT_DOUBLE_EQ(10, stats.GetLatencyPercentile(99));
+
+    // Frame percentiles are kept apart from the latencies
+    stats.AddFrame(0, 0, 0, 40, 1);
+    ASSERT_DOUBLE_EQ(40, stats.GetFramePercentile(50));
+    ASSERT_DOUBLE_EQ(5, stats.GetLatencyPercentile(50));
+
+    stats.Clear();
+    ASSERT_EQ(0u, stats.GetLatencyCount());
+}
@@ -0,0 +1,209 @@
+/**
+ * @file InputReplayTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <AquariumInput.h>
+#include <DecorCastle.h>
+#include <InputReplay.h>
+#include <SceneGenerator.h>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+
+using namespace std;
+
+/**
+ * Make an input event
+ * @param time Time in milliseconds
+ * @param type What happened
+ * @param x Mouse X
+ * @param y Mouse Y
+ * @param leftDown True if the left button is down
+ * @return The event
+ */
+static InputEvent Event(uint32_t time, InputEventType type, int x, int y, bool leftDown)
+{
+    InputEvent event;
+    event.time = time;
+    event.type = (uint16_t)type;
+    event.buttons = leftDown ? InputEvent::LeftButton : 0;
+    event.x = x;
+    event.y = y;
+    return event;
+}
+
+/**
+ * Record swimming fish and a castle dragged from 300,300 to 500,350
+ * @param filename File to save the recording to
+ * @param seed Seed to record with
+ */
+static void RecordDrag(const wxString& filename, uint32_t seed)
+{
+    SceneGenerator scene;
+    scene.SetCount(L"beta", 20);
+    scene.SetCount(L"catfish", 20);
+
+    Aquarium aquarium;
+    scene.Generate(&aquarium);
+    auto castle = make_shared<DecorCastle>(&aquarium);
+    castle->SetLocation(300, 300);
+    aquarium.Add(castle);
+    ASSERT_EQ(castle, aquarium.HitTest(300, 300));
+
+    InputRecorder recorder;
+    recorder.Start(&aquarium, seed);
+    ASSERT_EQ(seed, aquarium.GetSeed());
+
+    recorder.Add(Event(100, InputEventType::LeftDown, 300, 300, true));
+    for (int i = 1; i <= 20; i++)
+    {
+        recorder.Add(Event(100 + i * 10, InputEventType::MouseMove, 300 + i * 10, 300 + i * 5 / 2, true));
+    }
+    recorder.Add(Event(320, InputEventType::LeftUp, 500, 350, false));
+    recorder.Add(Event(600, InputEventType::LeftDClick, 10, 10, false));
+    recorder.Stop();
+
+    ASSERT_EQ(23u, recorder.GetEventCount());
+    ASSERT_EQ(600u, recorder.GetDuration());
+    ASSERT_TRUE(recorder.Save(filename));
+}
+
+TEST(InputReplayTest, Deterministic)
+{
+    auto filename = wxFileName::GetTempDir() + L"/aquarium-input.aqin";
+    RecordDrag(filename, 1234);
+
+    InputReplay replay;
+    ASSERT_TRUE(replay.Load(filename));
+    ASSERT_EQ(23u, replay.GetEventCount());
+    ASSERT_EQ(1234u, replay.GetSeed());
+    ASSERT_EQ(600u, replay.GetDuration());
+
+    Aquarium first;
+    ReplayResult firstResult;
+    ASSERT_TRUE(replay.Run(&first, &firstResult));
+    ASSERT_EQ(23u, firstResult.events);
+    ASSERT_EQ(3u, firstResult.pick.GetCount());
+    ASSERT_GT(firstResult.drag.GetCount(), 0u);
+    ASSERT_LT(firstResult.drag.GetCount(), 20u) << L"Moves between steps are applied together";
+    ASSERT_GE(firstResult.ticks, 36);
+
+    // The castle was brought to the front and dropped where the mouse let go
+    AquaSnapshot snapshot;
+    first.TakeSnapshot(&snapshot);
+    ASSERT_EQ(41u, snapshot.records.size());
+    ASSERT_EQ(L"castle", snapshot.species[snapshot.records.back().species]);
+    ASSERT_EQ(500, snapshot.records.back().x);
+    ASSERT_EQ(350, snapshot.records.back().y);
+
+    // A second replay, even into an aquarium that already has items, ends the same
+    Aquarium second;
+    second.Add(make_shared<DecorCastle>(&second));
+    ReplayResult secondResult;
+    ASSERT_TRUE(replay.Run(&second, &secondResult));
+    ASSERT_EQ(firstResult.checksum, secondResult.checksum);
+    ASSERT_EQ(firstResult.ticks, secondResult.ticks);
+
+    // So does a replay from a fresh load
+    InputReplay reloaded;
+    ASSERT_TRUE(reloaded.Load(filename));
+    Aquarium third;
+    ReplayResult thirdResult;
+    ASSERT_TRUE(reloaded.Run(&third, &thirdResult));
+    ASSERT_EQ(firstResult.checksum, thirdResult.checksum);
+    wxRemoveFile(filename);
+
+    // The fish do something different with another seed
+    RecordDrag(filename, 4321);
+    ASSERT_TRUE(reloaded.Load(filename));
+    ASSERT_TRUE(reloaded.Run(&third, &thirdResult));
+    ASSERT_NE(firstResult.checksum, thirdResult.checksum);
+    wxRemoveFile(filename);
+}
+
+TEST(InputReplayTest, Input)
+{
+    Aquarium aquarium;
+    auto castle = make_shared<DecorCastle>(&aquarium);
+    castle->SetLocation(200, 200);
+    aquarium.Add(castle);
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+
+    AquariumInput input(&aquarium);
+    ASSERT_FALSE(input.MouseMove(210, 210, true));
+
+    input.LeftDown(200, 200);
+    ASSERT_TRUE(input.IsDragging());
+    ASSERT_TRUE(input.MouseMove(250, 220, true));
+    ASSERT_EQ(250, castle->GetX());
+    ASSERT_EQ(220, castle->GetY());
+
+    // Moving with the button up drops the item where it was
+    ASSERT_TRUE(input.MouseMove(300, 300, false));
+    ASSERT_FALSE(input.IsDragging());
+    ASSERT_EQ(250, castle->GetX());
+}
+
+TEST(InputReplayTest, CoalescedDrag)
+{
+    Aquarium aquarium;
+    auto castle = make_shared<DecorCastle>(&aquarium);
+    castle->SetLocation(200, 200);
+    aquarium.Add(castle);
+
+    AquariumInput input(&aquarium);
+    wxRect dirty;
+    ASSERT_FALSE(input.QueueMove(210, 210, true, &dirty));
+
+    input.LeftDown(200, 200);
+    auto start = castle->GetBounds();
+
+    // A burst of moves leaves the castle alone until the frame applies the last
+    wxRect frame;
+    for (int i = 1; i <= 50; i++)
+    {
+        ASSERT_TRUE(input.QueueMove(200 + i, 200 + i * 2, true, &dirty));
+        frame.Union(dirty);
+    }
+    ASSERT_TRUE(input.IsMovePending());
+    ASSERT_EQ(200, castle->GetX());
+
+    ASSERT_TRUE(input.ApplyMove());
+    ASSERT_FALSE(input.ApplyMove());
+    ASSERT_EQ(250, castle->GetX());
+    ASSERT_EQ(300, castle->GetY());
+
+    // The area to repaint covers where the castle was and where it is now
+    ASSERT_TRUE(frame.Contains(start));
+    ASSERT_TRUE(frame.Contains(castle->GetBounds()));
+    ASSERT_TRUE(dirty.Contains(castle->GetBounds()));
+
+    // Letting go drops the castle at the last queued move
+    input.QueueMove(260, 310, true, &dirty);
+    ASSERT_TRUE(input.QueueMove(400, 400, false, &dirty));
+    ASSERT_FALSE(input.IsDragging());
+    ASSERT_FALSE(input.IsMovePending());
+    ASSERT_EQ(260, castle->GetX());
+    ASSERT_EQ(310, castle->GetY());
+    ASSERT_TRUE(dirty.Contains(castle->GetBounds()));
+}
+
+TEST(InputReplayTest, BadFile)
+{
+    auto filename = wxFileName::GetTempDir() + L"/aquarium-input.aqua";
+
+    SceneGenerator scene;
+    scene.SetCount(L"castle", 2);
+    ASSERT_TRUE(scene.Export(filename));
+
+    InputReplay replay;
+    ASSERT_FALSE(replay.Load(filename));
+    ASSERT_FALSE(replay.Load(filename + L".missing"));
+
+    Aquarium aquarium;
+    ReplayResult result;
+    ASSERT_FALSE(replay.Run(&aquarium, &result));
+    wxRemoveFile(filename);
+}
@@ -11,6 +11,9 @@
 /// Fish filename
 const std::wstring FishBetaImageName = L"images/beta.png";
 
+/// Species of the mock, which can be saved but not created
+static const SpeciesId MockSpecies = SpeciesRegistry::Get().Register(L"mock", nullptr);
+
 /** Mock class for testing the class Item */
 class ItemMock : public Item
 {
@@ -21,14 +24,14 @@ public:
 
     void Draw(wxDC *dc)  {}
     /**
- * @brief Returns the type of the item.
- * @return A wide string representing the type.
+ * @brief Returns the species of the item.
+ * @return The species id.
  *
- * This mock returns "mock" as its type.
+ * This mock has the "mock" species.
  */
-    std::wstring GetType() const override
+    SpeciesId GetSpecies() const override
     {
-        return L"mock";
+        return MockSpecies;
     }
 
 };
@@ -0,0 +1,70 @@
+/**
+ * @file MemoryReportTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <SceneGenerator.h>
+#include <SpeciesRegistry.h>
+
+using namespace std;
+
+TEST(MemoryReportTest, Species)
+{
+    SceneGenerator scene;
+    scene.SetCount(L"beta", 30);
+    scene.SetCount(L"castle", 10);
+
+    Aquarium aquarium;
+    scene.Generate(&aquarium);
+
+    auto report = aquarium.GetMemoryReport();
+    ASSERT_EQ(2u, report.species.size());
+
+    // Species come in registry order, so find them by tag
+    size_t entities = 0;
+    for (const auto& memory : report.species)
+    {
+        ASSERT_EQ(memory.tag == L"beta" ? 30u : 10u, memory.count);
+        ASSERT_EQ(memory.count * memory.itemBytes, memory.bytes);
+        entities += memory.bytes;
+    }
+    ASSERT_EQ(entities, report.entities);
+
+    auto beta = SpeciesRegistry::Get().Find(L"beta");
+    ASSERT_EQ(sizeof(FishBeta), SpeciesRegistry::Get().GetSize(beta));
+
+    // Every part of the report adds up to the total
+    ASSERT_GT(report.sprites, 0u);
+    ASSERT_GT(report.containers, 0u);
+    ASSERT_EQ(report.sprites + report.entities + report.containers + report.atlas + report.drawList + report.pack,
+              report.GetTotal());
+}
+
+TEST(MemoryReportTest, Scales)
+{
+    Aquarium small;
+    Aquarium large;
+
+    SceneGenerator scene;
+    scene.SetCount(L"beta", 100);
+    scene.Generate(&small);
+    scene.SetCount(L"beta", 1100);
+    scene.Generate(&large);
+
+    // Sprites are shared, so only entities and containers grow
+    auto smallReport = small.GetMemoryReport();
+    auto largeReport = large.GetMemoryReport();
+    ASSERT_EQ(smallReport.sprites, largeReport.sprites);
+    ASSERT_EQ(smallReport.entities * 11, largeReport.entities);
+    ASSERT_GE(largeReport.containers - smallReport.containers, 1000 * sizeof(shared_ptr<Item>));
+}
+
+TEST(MemoryReportTest, FormatBytes)
+{
+    ASSERT_EQ(L"512 B", MemoryReport::FormatBytes(512));
+    ASSERT_EQ(L"1.50 KB", MemoryReport::FormatBytes(1536));
+    ASSERT_EQ(L"12.0 MB", MemoryReport::FormatBytes(12.0 * 1024 * 1024));
+}
@@ -0,0 +1,205 @@
+/**
+ * @file PerformanceTest.cpp
+ * @author Josh Thomas
+ *
+ * PerformanceTest runs a fixed, seeded scenario and checks it against
+ * the budgets in PerformanceBaseline.txt. ctest runs it separately from
+ * the other tests under the "performance" label. The perf preset builds
+ * optimized with allocation counting, so both time and allocations are
+ * checked:
+ *
+ *     cmake --preset perf
+ *     cmake --build --preset perf
+ *     ctest --preset perf
+ *
+ * In a build that can measure neither, the scenario is skipped.
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <AllocationTracker.h>
+#include <PerformanceBudget.h>
+#include <SceneGenerator.h>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+#include <wx/ffile.h>
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+using namespace std;
+
+/// Number of fish in the scenario
+const int ScenarioFish = 10000;
+
+/// Number of update ticks
+const int ScenarioTicks = 1000;
+
+/// Number of hit tests
+const int ScenarioHitTests = 100;
+
+/// Time step of one tick in seconds
+const double ScenarioTickTime = 1.0 / 30;
+
+/// Wall time is only compared in optimized builds. A debug
+/// build is too slow for its times to mean anything.
+#ifdef NDEBUG
+const bool CheckWallTime = true;
+#else
+const bool CheckWallTime = false;
+#endif
+
+/**
+ * Measure one phase of the scenario against the budget.
+ *
+ * Records name_ms for the wall time and, when allocation tracking
+ * is built in, name_allocs and name_bytes for the heap allocations.
+ *
+ * @param budget Budget to measure against
+ * @param name Name of the phase
+ * @param phase The work to measure
+ */
+static void MeasurePhase(PerformanceBudget* budget, const std::string& name, const function<void()>& phase)
+{
+    AllocationTracker::Start();
+    auto before = AllocationTracker::GetCounts();
+    auto start = chrono::steady_clock::now();
+
+    phase();
+
+    auto end = chrono::steady_clock::now();
+    auto allocated = (AllocationTracker::GetCounts() - before).GetTotal();
+    AllocationTracker::Stop();
+
+    if (CheckWallTime)
+    {
+        budget->Measure(name + "_ms", chrono::duration<double, milli>(end - start).count());
+    }
+
+    if (AllocationTracker::IsBuiltIn())
+    {
+        budget->Measure(name + "_allocs", (double)allocated.allocations);
+        budget->Measure(name + "_bytes", (double)allocated.bytes);
+    }
+}
+
+TEST(PerformanceBudgetTest, Compare)
+{
+    PerformanceBudget budget;
+    budget.SetTolerance(0.5);
+    budget.SetBudget("time", 10);
+    budget.SetBudget("allocs", 0);
+
+    ASSERT_EQ(10, budget.GetBudget("time"));
+    ASSERT_EQ(-1, budget.GetBudget("missing"));
+
+    // Within the tolerance
+    ASSERT_TRUE(budget.Measure("time", 14.9));
+    ASSERT_TRUE(budget.Measure("allocs", 0));
+    ASSERT_TRUE(budget.Measure("missing", 1e9));
+    ASSERT_TRUE(budget.IsWithinBudget());
+
+    // A zero budget allows nothing
+    ASSERT_FALSE(budget.Measure("allocs", 1));
+    ASSERT_FALSE(budget.IsWithinBudget());
+
+    auto diff = budget.FormatDiff();
+    ASSERT_NE(wxNOT_FOUND, diff.Find(L"OVER"));
+    ASSERT_NE(wxNOT_FOUND, diff.Find(L"no budget"));
+    ASSERT_NE(wxNOT_FOUND, diff.Find(L"+49.0%"));
+}
+
+TEST(PerformanceBudgetTest, Load)
+{
+    auto filename = wxFileName::GetTempDir() + L"/aquarium-baseline.txt";
+    {
+        wxFFile file(filename, L"w");
+        ASSERT_TRUE(file.IsOpened());
+        file.Write(L"# A comment\n\ntolerance 0.1\nupdate_ms   250.5\nupdate_allocs 0\n");
+    }
+
+    PerformanceBudget budget;
+    ASSERT_TRUE(budget.Load(filename));
+    ASSERT_DOUBLE_EQ(0.1, budget.GetTolerance());
+    ASSERT_DOUBLE_EQ(250.5, budget.GetBudget("update_ms"));
+    ASSERT_EQ(0, budget.GetBudget("update_allocs"));
+
+    budget.Measure("update_ms", 100);
+    ASSERT_EQ(L"tolerance 0.1\nupdate_ms 100\n", budget.FormatBaseline());
+
+    wxRemoveFile(filename);
+    ASSERT_FALSE(budget.Load(filename));
+}
+
+TEST(PerformanceTest, Scenario)
+{
+    if (!CheckWallTime && !AllocationTracker::IsBuiltIn())
+    {
+        GTEST_SKIP() << "Nothing to measure: a debug build without allocation tracking. "
+                        "Use the perf preset: ctest --preset perf";
+    }
+
+    PerformanceBudget budget;
+    ASSERT_TRUE(budget.Load(PERFORMANCE_BASELINE)) << "Unable to read " << PERFORMANCE_BASELINE;
+
+    auto filename = wxFileName::GetTempDir() + L"/aquarium-performance.aqua";
+
+    SceneGenerator scene;
+    scene.SetCount(L"beta", ScenarioFish / 3 + 1);
+    scene.SetCount(L"carp", ScenarioFish / 3);
+    scene.SetCount(L"catfish", ScenarioFish / 3);
+
+    Aquarium aquarium;
+    MeasurePhase(&budget, "populate", [&aquarium, &scene]() {
+        scene.Generate(&aquarium);
+    });
+    ASSERT_EQ((size_t)ScenarioFish, aquarium.GetItemCount());
+
+    MeasurePhase(&budget, "update", [&aquarium]() {
+        for (int i = 0; i < ScenarioTicks; i++)
+        {
+            aquarium.Update(ScenarioTickTime);
+        }
+    });
+
+    vector<wxPoint> points;
+    for (int i = 0; i < ScenarioHitTests; i++)
+    {
+        points.push_back(wxPoint(aquarium.GetRandom()() % aquarium.GetWidth(),
+                                 aquarium.GetRandom()() % aquarium.GetHeight()));
+    }
+
+    int hits = 0;
+    MeasurePhase(&budget, "hittest", [&aquarium, &points, &hits]() {
+        for (const auto& point : points)
+        {
+            hits += aquarium.HitTest(point.x, point.y) != nullptr ? 1 : 0;
+        }
+    });
+    ASSERT_GT(hits, 0);
+
+    bool saved = false;
+    MeasurePhase(&budget, "save", [&aquarium, &filename, &saved]() {
+        saved = aquarium.Save(filename);
+    });
+    ASSERT_TRUE(saved) << "Unable to write " << filename.ToStdString();
+
+    Aquarium loaded;
+    bool read = false;
+    MeasurePhase(&budget, "load", [&loaded, &filename, &read]() {
+        read = loaded.Load(filename);
+    });
+    ASSERT_TRUE(read) << "Unable to read " << filename.ToStdString();
+    ASSERT_EQ(aquarium.GetItemCount(), loaded.GetItemCount());
+    wxRemoveFile(filename);
+
+    cout << budget.FormatDiff().ToStdString();
+    if (!CheckWallTime)
+    {
+        cout << "Wall time not checked in a debug build" << endl;
+    }
+
+    ASSERT_TRUE(budget.IsWithinBudget())
+        << "Over budget. If the change is intended, update " << PERFORMANCE_BASELINE << " to:\n"
+        << budget.FormatBaseline().ToStdString();
+}
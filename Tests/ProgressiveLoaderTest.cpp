@@ -0,0 +1,152 @@
+/**
+ * @file ProgressiveLoaderTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <ProgressiveLoader.h>
+#include <chrono>
+#include <thread>
+#include "TestHelpers.h"
+
+using namespace std;
+
+/// How far a value can move when saved to XML with six decimal places
+const double XmlTolerance = 1e-6;
+
+class ProgressiveLoaderTest : public ::testing::Test
+{
+protected:
+    /**
+     * Load a file progressively, a small batch at a time, and
+     * make sure we end up with the same items we saved.
+     * @param aquarium The aquarium that was saved
+     * @param filename The file it was saved to
+     * @param tolerance How far a loaded speed can be from the saved one
+     */
+    void TestLoad(Aquarium* aquarium, const wxString& filename, double tolerance = 0)
+    {
+        ProgressiveLoader loader;
+        ASSERT_TRUE(ProgressiveLoader::CanLoad(filename));
+        ASSERT_TRUE(loader.Start(filename));
+
+        Aquarium loaded;
+        loaded.BeginLoad();
+
+        int batches = 0;
+        while (loader.IsLoading())
+        {
+            AquaSnapshot batch;
+            if (loader.Take(500, &batch) == 0)
+            {
+                this_thread::sleep_for(chrono::milliseconds(1));
+                continue;
+            }
+
+            ASSERT_LE(batch.records.size(), 500u);
+            loaded.AddRecords(batch.species, batch.records.data(), batch.records.size());
+            batches++;
+        }
+        loaded.EndLoad();
+
+        ASSERT_FALSE(loader.Failed());
+        ASSERT_EQ(100, loader.GetPercent());
+        ASSERT_GT(batches, 1) << L"Items arrived a batch at a time";
+
+        AquaSnapshot expected;
+        aquarium->TakeSnapshot(&expected);
+        AquaSnapshot actual;
+        loaded.TakeSnapshot(&actual);
+
+        ASSERT_EQ(expected.species, actual.species);
+        ASSERT_EQ(expected.records.size(), actual.records.size());
+        for (size_t i = 0; i < expected.records.size(); i++)
+        {
+            ASSERT_EQ(expected.records[i].x, actual.records[i].x);
+            ASSERT_EQ(expected.records[i].y, actual.records[i].y);
+            ASSERT_NEAR(expected.records[i].speedX, actual.records[i].speedX, tolerance);
+            ASSERT_EQ(expected.records[i].flags, actual.records[i].flags);
+        }
+    }
+};
+
+TEST_F(ProgressiveLoaderTest, Xml)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, 3000);
+
+    auto filename = TempPath() + L"/test_progressive.aqua";
+    // XML keeps six decimal places
+    aquarium.Save(filename);
+    TestLoad(&aquarium, filename, XmlTolerance);
+
+    auto compressed = TempPath() + L"/test_progressive.aqua.gz";
+    aquarium.Save(compressed);
+    TestLoad(&aquarium, compressed, XmlTolerance);
+}
+
+TEST_F(ProgressiveLoaderTest, Binary)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, 3000);
+
+    auto filename = TempPath() + L"/test_progressive_binary.aqua";
+    aquarium.SaveBinary(filename);
+    TestLoad(&aquarium, filename);
+}
+
+TEST_F(ProgressiveLoaderTest, Cancel)
+{
+    Aquarium aquarium;
+    Populate(&aquarium, 3000);
+
+    auto filename = TempPath() + L"/test_progressive_cancel.aqua";
+    aquarium.Save(filename);
+
+    ProgressiveLoader loader;
+    ASSERT_TRUE(loader.Start(filename));
+    loader.Cancel();
+    ASSERT_FALSE(loader.Failed()) << L"Cancelling is not a failure";
+
+    // Starting again discards what the cancelled load left behind
+    ASSERT_TRUE(loader.Start(filename));
+    size_t total = 0;
+    while (loader.IsLoading())
+    {
+        AquaSnapshot batch;
+        total += loader.Take(100000, &batch);
+    }
+    ASSERT_EQ(3000u, total);
+}
+
+TEST_F(ProgressiveLoaderTest, Backpressure)
+{
+    // More records than the loader will hold for a UI that is not taking them
+    const int Items = 100000;
+    Aquarium aquarium;
+    Populate(&aquarium, Items);
+
+    auto filename = TempPath() + L"/test_progressive_backpressure.aqua";
+    aquarium.SaveBinary(filename);
+
+    ProgressiveLoader loader;
+    ASSERT_TRUE(loader.Start(filename));
+    this_thread::sleep_for(chrono::milliseconds(200));
+    ASSERT_LT(loader.GetPercent(), 100) << L"The worker waits for the UI";
+
+    // Cancelling wakes a waiting worker
+    loader.Cancel();
+    ASSERT_FALSE(loader.Failed());
+
+    ASSERT_TRUE(loader.Start(filename));
+    size_t total = 0;
+    AquaSnapshot batch;
+    while (loader.IsLoading())
+    {
+        total += loader.Take(5000, &batch);
+    }
+    ASSERT_FALSE(loader.Failed());
+    ASSERT_EQ((size_t)Items, total);
+    ASSERT_EQ(4u, batch.species.size());
+}
@@ -0,0 +1,117 @@
+/**
+ * @file SceneGeneratorTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <SceneGenerator.h>
+#include <wx/filename.h>
+#include <wx/filefn.h>
+
+using namespace std;
+
+TEST(SceneGeneratorTest, Counts)
+{
+    SceneGenerator scene;
+    ASSERT_TRUE(scene.Parse(L"beta=5,carp=3, castle=1"));
+    ASSERT_EQ(5, scene.GetCount(L"beta"));
+    ASSERT_EQ(3, scene.GetCount(L"carp"));
+    ASSERT_EQ(1, scene.GetCount(L"castle"));
+    ASSERT_EQ(0, scene.GetCount(L"catfish"));
+    ASSERT_EQ(9, scene.GetTotal());
+
+    ASSERT_FALSE(scene.Parse(L"shark=4"));
+    ASSERT_FALSE(scene.Parse(L"beta=lots"));
+    ASSERT_FALSE(scene.Parse(L"beta=-1"));
+
+    Aquarium aquarium;
+    auto items = scene.Generate(&aquarium);
+    ASSERT_EQ(9u, items.size());
+    ASSERT_EQ(9u, aquarium.GetItemCount());
+
+    // Species are interleaved in the order they were given
+    ASSERT_EQ(L"beta", items[0]->GetType());
+    ASSERT_EQ(L"carp", items[1]->GetType());
+    ASSERT_EQ(L"castle", items[2]->GetType());
+    ASSERT_EQ(L"beta", items[3]->GetType());
+    ASSERT_EQ(L"beta", items[8]->GetType());
+}
+
+TEST(SceneGeneratorTest, Reproducible)
+{
+    SceneGenerator scene;
+    scene.SetCount(L"beta", 50);
+    scene.SetCount(L"catfish", 50);
+    scene.SetLayout(SceneLayout::Clustered);
+
+    Aquarium first;
+    Aquarium second;
+    auto a = scene.Generate(&first);
+    auto b = scene.Generate(&second);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        ASSERT_EQ(a[i]->GetX(), b[i]->GetX());
+        ASSERT_EQ(a[i]->GetY(), b[i]->GetY());
+    }
+
+    // The fish go on behaving the same
+    first.Update(0.5);
+    second.Update(0.5);
+    ASSERT_EQ(a[17]->GetX(), b[17]->GetX());
+
+    // A different seed makes a different scene
+    scene.SetSeed(7);
+    Aquarium third;
+    auto c = scene.Generate(&third);
+    ASSERT_NE(a[0]->GetX(), c[0]->GetX());
+}
+
+TEST(SceneGeneratorTest, Layouts)
+{
+    SceneGenerator scene;
+    scene.SetCount(L"castle", 200);
+    scene.SetSize(1000, 500);
+
+    SceneLayout layout;
+    ASSERT_TRUE(SceneGenerator::ParseLayout(L"Corner", &layout));
+    ASSERT_EQ(SceneLayout::Corner, layout);
+    ASSERT_FALSE(SceneGenerator::ParseLayout(L"diagonal", &layout));
+
+    for (auto layout : {SceneLayout::Uniform, SceneLayout::Clustered, SceneLayout::Corner})
+    {
+        scene.SetLayout(layout);
+        Aquarium aquarium;
+        for (const auto& item : scene.Generate(&aquarium))
+        {
+            ASSERT_GE(item->GetX(), 0);
+            ASSERT_LE(item->GetX(), 1000);
+            ASSERT_GE(item->GetY(), 0);
+            ASSERT_LE(item->GetY(), 500);
+            if (layout == SceneLayout::Corner)
+            {
+                ASSERT_LT(item->GetX(), 100);
+                ASSERT_LT(item->GetY(), 50);
+            }
+        }
+    }
+}
+
+TEST(SceneGeneratorTest, Export)
+{
+    auto filename = wxFileName::GetTempDir() + L"/aquarium-scene.aqua";
+
+    SceneGenerator scene;
+    scene.SetCount(L"beta", 20);
+    scene.SetCount(L"castle", 4);
+    ASSERT_TRUE(scene.Export(filename));
+
+    Aquarium aquarium;
+    aquarium.Load(filename);
+    ASSERT_EQ(24u, aquarium.GetItemCount());
+    wxRemoveFile(filename);
+
+    // Failing to write is reported, not judged by whether a file is there
+    ASSERT_FALSE(scene.Export(wxFileName::GetTempDir() + L"/aquarium-missing/scene.aqua"));
+}
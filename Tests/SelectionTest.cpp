@@ -0,0 +1,232 @@
+/**
+ * @file SelectionTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <AquariumInput.h>
+#include <DecorCastle.h>
+#include <ItemSelection.h>
+#include <SceneGenerator.h>
+#include <SpatialGrid.h>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Add a castle to an aquarium
+ * @param aquarium Aquarium to add to
+ * @param x X location
+ * @param y Y location
+ * @return The castle
+ */
+static shared_ptr<Item> AddCastle(Aquarium* aquarium, int x, int y)
+{
+    auto castle = make_shared<DecorCastle>(aquarium);
+    castle->SetLocation(x, y);
+    aquarium->Add(castle);
+    return castle;
+}
+
+TEST(SelectionTest, Bits)
+{
+    ItemSelection selection;
+    ASSERT_TRUE(selection.IsEmpty());
+    ASSERT_FALSE(selection.Contains(1000));
+
+    selection.Add(0);
+    selection.Add(63);
+    selection.Add(64);
+    selection.Add(20000);
+    selection.Add(64);
+    ASSERT_EQ(4u, selection.GetCount());
+    ASSERT_TRUE(selection.Contains(63));
+    ASSERT_TRUE(selection.Contains(64));
+    ASSERT_TRUE(selection.Contains(20000));
+    ASSERT_FALSE(selection.Contains(1));
+    ASSERT_FALSE(selection.Contains(19999));
+
+    selection.Remove(63);
+    selection.Remove(63);
+    selection.Remove(100000);
+    ASSERT_EQ(3u, selection.GetCount());
+    ASSERT_FALSE(selection.Contains(63));
+
+    // The memory is kept for the next selection
+    auto bytes = selection.GetMemorySize();
+    selection.Clear();
+    ASSERT_TRUE(selection.IsEmpty());
+    ASSERT_FALSE(selection.Contains(20000));
+    ASSERT_EQ(bytes, selection.GetMemorySize());
+}
+
+TEST(SelectionTest, Ids)
+{
+    Aquarium aquarium;
+    auto first = AddCastle(&aquarium, 10, 10);
+    auto second = AddCastle(&aquarium, 20, 20);
+    ASSERT_EQ(0u, first->GetId());
+    ASSERT_EQ(1u, second->GetId());
+
+    // Bringing an item to the front does not change its id
+    aquarium.MoveToEnd(first);
+    ASSERT_EQ(0u, first->GetId());
+
+    aquarium.Clear();
+    ASSERT_EQ(0u, AddCastle(&aquarium, 10, 10)->GetId());
+}
+
+TEST(SelectionTest, Grid)
+{
+    Aquarium aquarium;
+    SceneGenerator scene;
+    scene.SetCount(L"beta", 1000);
+    scene.SetCount(L"castle", 200);
+    auto items = scene.Generate(&aquarium);
+
+    // Some far outside the tank, past the edge cells
+    items[3]->SetLocation(-5000, 40);
+    items[4]->SetLocation(100000, 100000);
+
+    SpatialGrid grid;
+    grid.Build(items);
+    ASSERT_EQ(items.size(), grid.GetCount());
+
+    const wxRect rects[] = {
+        wxRect(0, 0, 300, 200), wxRect(250, 180, 64, 64), wxRect(-6000, 0, 1100, 100),
+        wxRect(500, 300, 1, 1), wxRect(99990, 99990, 20, 20), wxRect(0, 0, aquarium.GetWidth(), aquarium.GetHeight()),
+    };
+
+    // The grid finds exactly what looking at every item finds
+    for (const auto& rect : rects)
+    {
+        vector<uint32_t> expected;
+        for (const auto& item : items)
+        {
+            if (item->GetBounds().Intersects(rect))
+            {
+                expected.push_back(item->GetId());
+            }
+        }
+
+        vector<uint32_t> found;
+        grid.Query(rect, &found);
+        sort(found.begin(), found.end());
+        ASSERT_EQ(expected, found);
+    }
+
+    vector<uint32_t> found;
+    grid.Query(wxRect(), &found);
+    ASSERT_TRUE(found.empty());
+}
+
+TEST(SelectionTest, RubberBand)
+{
+    Aquarium aquarium;
+    auto a = AddCastle(&aquarium, 100, 100);
+    auto b = AddCastle(&aquarium, 300, 100);
+    auto c = AddCastle(&aquarium, 900, 600);
+    auto bounds = a->GetBounds();
+
+    AquariumInput input(&aquarium);
+
+    // Pressing over nothing starts a band, which selects what it touches
+    int x = bounds.GetLeft() - 20;
+    int y = bounds.GetTop() - 20;
+    ASSERT_EQ(nullptr, aquarium.HitTest(x, y));
+    input.LeftDown(x, y);
+    ASSERT_TRUE(input.IsBanding());
+    ASSERT_TRUE(input.IsDragging());
+
+    wxRect dirty;
+    ASSERT_TRUE(input.QueueMove(bounds.GetLeft() + 1, bounds.GetTop() + 1, true, &dirty));
+    ASSERT_TRUE(dirty.IsEmpty());
+    input.ApplyMove();
+    ASSERT_EQ(1u, input.GetSelection().GetCount());
+    ASSERT_TRUE(input.GetSelection().Contains(a->GetId()));
+
+    // The band is reselected as it stretches, and can be pulled back
+    input.MouseMove(b->GetX(), b->GetY(), true);
+    ASSERT_EQ(2u, input.GetSelection().GetCount());
+    input.MouseMove(bounds.GetLeft() + 1, bounds.GetTop() + 1, true);
+    ASSERT_EQ(1u, input.GetSelection().GetCount());
+    input.MouseMove(b->GetX(), b->GetY(), true);
+
+    ASSERT_TRUE(input.LeftUp(b->GetX(), b->GetY()));
+    ASSERT_FALSE(input.IsDragging());
+    ASSERT_EQ(2u, input.GetSelection().GetCount());
+    ASSERT_FALSE(input.GetSelection().Contains(c->GetId()));
+    ASSERT_EQ(a->GetBounds().Union(b->GetBounds()), aquarium.GetBounds(input.GetSelection()));
+
+    // Pressing over an unselected item drags just that item
+    ASSERT_TRUE(input.LeftDown(900, 600));
+    ASSERT_TRUE(input.GetSelection().IsEmpty());
+    input.LeftUp(900, 600);
+}
+
+TEST(SelectionTest, GroupDrag)
+{
+    Aquarium aquarium;
+    auto size = DecorCastle(&aquarium).GetBounds();
+    int w = size.GetWidth();
+    int h = size.GetHeight();
+
+    // Even castles in a top row, odd ones in a bottom row, none overlapping
+    vector<shared_ptr<Item>> castles;
+    for (int i = 0; i < 10; i++)
+    {
+        castles.push_back(AddCastle(&aquarium, w + i * (w / 2 + 10), h + (i % 2) * h * 3));
+    }
+
+    AquariumInput input(&aquarium);
+
+    // Band the top row
+    input.LeftDown(-w, -h);
+    input.MouseMove(w * 10, h * 2, true);
+    input.LeftUp(w * 10, h * 2);
+    ASSERT_EQ(5u, input.GetSelection().GetCount());
+
+    // Grabbing one brings them all to the front, in the order they were
+    int x = (int)castles[2]->GetX();
+    int y = (int)castles[2]->GetY();
+    ASSERT_TRUE(input.LeftDown(x, y));
+    AquaSnapshot snapshot;
+    aquarium.TakeSnapshot(&snapshot);
+    for (int i = 0; i < 10; i++)
+    {
+        auto castle = castles[i < 5 ? i * 2 + 1 : (i - 5) * 2];
+        ASSERT_EQ(castle->GetX(), snapshot.records[i].x);
+        ASSERT_EQ(castle->GetY(), snapshot.records[i].y);
+    }
+
+    // However many moves arrive, the selection moves once, by the total
+    wxRect dirty;
+    for (int i = 1; i <= 40; i++)
+    {
+        ASSERT_TRUE(input.QueueMove(x + i, y + i * 2, true, &dirty));
+    }
+    ASSERT_EQ(w, castles[0]->GetX());
+    ASSERT_TRUE(input.ApplyMove());
+    ASSERT_FALSE(input.ApplyMove());
+
+    for (int i = 0; i < 10; i++)
+    {
+        bool selected = i % 2 == 0;
+        ASSERT_EQ(w + i * (w / 2 + 10) + (selected ? 40 : 0), castles[i]->GetX());
+        ASSERT_EQ(h + (i % 2) * h * 3 + (selected ? 80 : 0), castles[i]->GetY());
+    }
+
+    // Letting go keeps the selection where the last move put it
+    input.QueueMove(x + 10, y + 30, true, &dirty);
+    ASSERT_TRUE(input.QueueMove(0, 0, false, &dirty));
+    ASSERT_FALSE(input.IsDragging());
+    ASSERT_EQ(w + 10, castles[0]->GetX());
+    ASSERT_EQ(h + 30, castles[0]->GetY());
+    ASSERT_EQ(5u, input.GetSelection().GetCount());
+
+    // The moved items are found where they went
+    ItemSelection found;
+    ASSERT_EQ(1u, aquarium.Select(wxRect(w + 10, h + 30, 1, 1), &found));
+    ASSERT_TRUE(found.Contains(castles[0]->GetId()));
+}
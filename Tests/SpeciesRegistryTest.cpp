@@ -0,0 +1,65 @@
+/**
+ * @file SpeciesRegistryTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SpeciesRegistry.h>
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <FishCarp.h>
+#include <FishCatfish.h>
+#include <DecorCastle.h>
+
+using namespace std;
+
+TEST(SpeciesRegistryTest, Registered)
+{
+    auto& registry = SpeciesRegistry::Get();
+
+    ASSERT_EQ(FishBeta::Species, registry.Find(L"beta"));
+    ASSERT_EQ(FishCarp::Species, registry.Find(L"carp"));
+    ASSERT_EQ(FishCatfish::Species, registry.Find(L"catfish"));
+    ASSERT_EQ(DecorCastle::Species, registry.Find(L"castle"));
+    ASSERT_EQ(L"carp", registry.GetTag(FishCarp::Species));
+    ASSERT_EQ(UnknownSpecies, registry.Find(L"shark"));
+
+    Aquarium aquarium;
+    auto item = registry.Create(FishCatfish::Species, &aquarium);
+    ASSERT_NE(nullptr, dynamic_pointer_cast<FishCatfish>(item));
+    ASSERT_EQ(FishCatfish::Species, item->GetSpecies());
+    ASSERT_EQ(L"catfish", item->GetType());
+
+    ASSERT_EQ(nullptr, registry.Create(UnknownSpecies, &aquarium));
+}
+
+/// A species that has a tag but no way to create it
+static const SpeciesId NoFactorySpecies = SpeciesRegistry::Get().Register(L"test-no-factory", nullptr);
+
+TEST(SpeciesRegistryTest, NoFactory)
+{
+    auto& registry = SpeciesRegistry::Get();
+
+    ASSERT_EQ(NoFactorySpecies, registry.Find(L"test-no-factory"));
+    ASSERT_EQ(L"test-no-factory", registry.GetTag(NoFactorySpecies));
+
+    Aquarium aquarium;
+    ASSERT_EQ(nullptr, registry.Create(NoFactorySpecies, &aquarium));
+
+    // Looking up a tag never adds it
+    auto count = registry.GetCount();
+    ASSERT_EQ(UnknownSpecies, registry.Find(L"test-never-registered"));
+    ASSERT_EQ(count, registry.GetCount());
+}
+
+TEST(SpeciesRegistryTest, TagHash)
+{
+    auto& registry = SpeciesRegistry::Get();
+
+    // The hash depends only on the tag, so it is the same on every
+    // platform and whatever order species registered in
+    ASSERT_EQ(0xb5615a90e87b59c3ull, SpeciesRegistry::HashTag(L"carp"));
+    ASSERT_EQ(SpeciesRegistry::HashTag(L"carp"), registry.GetTagHash(FishCarp::Species));
+    ASSERT_EQ(SpeciesRegistry::HashTag(L"test-no-factory"), registry.GetTagHash(NoFactorySpecies));
+    ASSERT_NE(registry.GetTagHash(FishBeta::Species), registry.GetTagHash(FishCarp::Species));
+}
@@ -0,0 +1,159 @@
+/**
+ * @file SpriteAtlasTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <FishCarp.h>
+#include <DecorCastle.h>
+#include <SpriteAtlas.h>
+#include <AtlasRenderer.h>
+#include <DcRenderer.h>
+#include <wx/dcmemory.h>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+TEST(SpriteAtlasTest, Pack)
+{
+    vector<wxSize> sizes = {{200, 93}, {125, 117}, {0, 0}, {245, 300}, {200, 117}, {3000, 10}, {200, 82}};
+    for (int i = 0; i < 50; i++)
+    {
+        sizes.push_back(wxSize(20 + i * 7 % 90, 10 + i * 13 % 70));
+    }
+
+    vector<wxSize> pages;
+    auto regions = SpriteAtlas::Pack(sizes, 512, &pages);
+    ASSERT_EQ(sizes.size(), regions.size());
+
+    // Empty rectangles are not placed
+    ASSERT_EQ(-1, regions[2].page);
+
+    // Too wide for a page, so it gets its own
+    ASSERT_EQ(3000, pages[regions[5].page].GetWidth());
+    ASSERT_EQ(10, pages[regions[5].page].GetHeight());
+
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+        if (regions[i].page < 0)
+        {
+            continue;
+        }
+
+        const auto& rect = regions[i].rect;
+        const auto& page = pages[regions[i].page];
+        ASSERT_EQ(sizes[i].GetWidth(), rect.GetWidth());
+        ASSERT_EQ(sizes[i].GetHeight(), rect.GetHeight());
+        ASSERT_GE(rect.GetLeft(), 0);
+        ASSERT_GE(rect.GetTop(), 0);
+        ASSERT_LE(rect.GetLeft() + rect.GetWidth(), page.GetWidth());
+        ASSERT_LE(rect.GetTop() + rect.GetHeight(), page.GetHeight());
+
+        for (size_t j = 0; j < i; j++)
+        {
+            if (regions[j].page != regions[i].page)
+            {
+                continue;
+            }
+
+            const auto& other = regions[j].rect;
+            bool apart = rect.GetLeft() + rect.GetWidth() <= other.GetLeft() ||
+                         other.GetLeft() + other.GetWidth() <= rect.GetLeft() ||
+                         rect.GetTop() + rect.GetHeight() <= other.GetTop() ||
+                         other.GetTop() + other.GetHeight() <= rect.GetTop();
+            ASSERT_TRUE(apart) << i << " overlaps " << j;
+        }
+    }
+}
+
+TEST(SpriteAtlasTest, Build)
+{
+    Aquarium aquarium;
+    aquarium.Add(make_shared<FishBeta>(&aquarium));
+    aquarium.Add(make_shared<DecorCastle>(&aquarium));
+
+    auto& sprites = aquarium.GetSprites();
+    const auto& atlas = sprites.GetAtlas();
+
+    // Everything fits on one page
+    ASSERT_EQ(1, atlas.GetPageCount());
+    ASSERT_GT(atlas.GetUtilization(), 0.5);
+    ASSERT_LE(atlas.GetUtilization(), 1.0);
+
+    for (int id = 0; id < sprites.GetCount(); id++)
+    {
+        for (bool mirror : {false, true})
+        {
+            const auto& region = atlas.GetRegion(id, mirror);
+            ASSERT_EQ(0, region.page);
+            ASSERT_EQ(sprites.Get(id)->width, region.rect.GetWidth());
+            ASSERT_EQ(sprites.Get(id)->height, region.rect.GetHeight());
+        }
+    }
+
+    // A new species is added to the atlas
+    aquarium.Add(make_shared<FishCarp>(&aquarium));
+    auto carp = sprites.Load(L"images/carp.png");
+    ASSERT_EQ(carp->width, sprites.GetAtlas().GetRegion(carp->id, true).rect.GetWidth());
+}
+
+TEST(SpriteAtlasTest, DISABLED_Benchmark)
+{
+    const int Items = 2000;
+    const int Frames = 50;
+
+    Aquarium aquarium;
+    auto& random = aquarium.GetRandom();
+    for (int i = 0; i < Items; i++)
+    {
+        shared_ptr<Item> item;
+        switch (i % 3)
+        {
+        case 0:
+            item = make_shared<FishBeta>(&aquarium);
+            break;
+
+        case 1:
+            item = make_shared<FishCarp>(&aquarium);
+            break;
+
+        default:
+            item = make_shared<DecorCastle>(&aquarium);
+            break;
+        }
+
+        item->SetLocation(random() % aquarium.GetWidth(), random() % aquarium.GetHeight());
+        item->SetMirror(random() % 2 == 0);
+        aquarium.Add(item);
+    }
+
+    const auto& list = aquarium.RecordDrawList();
+    const auto& atlas = aquarium.GetSprites().GetAtlas();
+
+    wxBitmap frame(aquarium.GetWidth(), aquarium.GetHeight());
+    wxMemoryDC dc(frame);
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < Frames; i++)
+    {
+        DcRenderer renderer(&dc, &aquarium.GetSprites());
+        renderer.Render(list);
+    }
+    auto bitmaps = chrono::steady_clock::now();
+
+    for (int i = 0; i < Frames; i++)
+    {
+        AtlasRenderer renderer(&dc, &atlas);
+        renderer.Render(list);
+    }
+    auto done = chrono::steady_clock::now();
+
+    double perBitmap = chrono::duration<double, milli>(bitmaps - start).count() / Frames;
+    double perAtlas = chrono::duration<double, milli>(done - bitmaps).count() / Frames;
+    cout << "Atlas: " << atlas.GetPageCount() << " pages, " << atlas.GetUtilization() * 100 << "% used" << endl;
+    cout << Items << " items: bitmaps " << perBitmap << " ms/frame, atlas " << perAtlas
+         << " ms/frame, speedup " << perBitmap / perAtlas << "x" << endl;
+}
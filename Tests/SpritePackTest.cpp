@@ -0,0 +1,112 @@
+/**
+ * @file SpritePackTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <SpritePack.h>
+#include <SpriteLibrary.h>
+#include <AssetPreloader.h>
+#include <filesystem>
+#include "TestHelpers.h"
+
+using namespace std;
+
+TEST(SpritePackTest, Pack)
+{
+    auto files = AssetPreloader::ReadManifest(AssetManifestName);
+    auto filename = TempPath() + L"/sprites.pack";
+    ASSERT_TRUE(SpritePack::Write(files, filename));
+
+    SpritePack pack;
+    ASSERT_TRUE(pack.Open(filename));
+
+    for (const auto& file : files)
+    {
+        wxImage image(file);
+        if (!image.HasAlpha())
+        {
+            image.InitAlpha();
+        }
+
+        auto entry = pack.Find(file);
+        ASSERT_NE(nullptr, entry) << file;
+        ASSERT_EQ(image.GetWidth(), (int)entry->width);
+        ASSERT_EQ(image.GetHeight(), (int)entry->height);
+
+        int width = image.GetWidth();
+        auto pixels = pack.GetPixels(entry, false);
+        auto mirrored = pack.GetPixels(entry, true);
+        auto mask = pack.GetMask(entry);
+        for (int y = 0; y < image.GetHeight(); y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                // Premultiplied, and the same pixel in the mirrored copy
+                auto a = image.GetAlpha(x, y);
+                auto pixel = pixels + (y * width + x) * 4;
+                ASSERT_EQ(a, pixel[3]);
+                ASSERT_EQ((image.GetRed(x, y) * a + 127) / 255, pixel[0]);
+                ASSERT_EQ(0, memcmp(pixel, mirrored + (y * width + width - 1 - x) * 4, 4));
+
+                bool opaque = (mask[y * SpritePack::MaskRowBytes(width) + x / 8] & (1 << (x % 8))) != 0;
+                ASSERT_EQ(!image.IsTransparent(x, y), opaque);
+            }
+        }
+    }
+
+    ASSERT_EQ(nullptr, pack.Find(L"images/missing.png"));
+
+    // A sprite library builds its sprites from the pack
+    SpriteLibrary sprites;
+    ASSERT_TRUE(sprites.OpenPack(filename));
+    auto carp = sprites.Load(L"images/carp.png");
+    ASSERT_TRUE(carp->ready);
+    ASSERT_NE(nullptr, carp->mask);
+    ASSERT_EQ(wxImage(L"images/carp.png").GetWidth(), carp->width);
+    ASSERT_TRUE(carp->bitmap.IsOk());
+    ASSERT_TRUE(carp->mirror.IsOk());
+}
+
+TEST(SpritePackTest, Stale)
+{
+    // Pack a copy of an image, then change the copy
+    auto image = TempPath() + L"/sprite.png";
+    filesystem::copy_file(L"images/carp.png", image.ToStdWstring(), filesystem::copy_options::overwrite_existing);
+
+    auto filename = TempPath() + L"/stale.pack";
+    ASSERT_TRUE(SpritePack::Write({image.ToStdWstring()}, filename));
+
+    SpritePack pack;
+    ASSERT_TRUE(pack.Open(filename));
+    ASSERT_NE(nullptr, pack.Find(image.ToStdWstring()));
+
+    filesystem::copy_file(L"images/beta.png", image.ToStdWstring(), filesystem::copy_options::overwrite_existing);
+    ASSERT_EQ(nullptr, pack.Find(image.ToStdWstring()));
+
+    // The library falls back to the image itself
+    SpriteLibrary sprites;
+    ASSERT_TRUE(sprites.OpenPack(filename));
+    auto sprite = sprites.Load(image.ToStdWstring());
+    ASSERT_TRUE(sprite->ready);
+    ASSERT_EQ(nullptr, sprite->mask);
+    ASSERT_EQ(wxImage(L"images/beta.png").GetWidth(), sprite->width);
+
+    pack.Close();
+    wxRemoveFile(filename);
+    wxRemoveFile(image);
+}
+
+TEST(SpritePackTest, Missing)
+{
+    SpritePack pack;
+    ASSERT_FALSE(pack.Open(TempPath() + L"/missing.pack"));
+
+    // Not a pack at all
+    ASSERT_FALSE(pack.Open(L"images/carp.png"));
+    ASSERT_FALSE(pack.IsOpen());
+
+    SpriteLibrary sprites;
+    ASSERT_FALSE(sprites.OpenPack(TempPath() + L"/missing.pack"));
+    ASSERT_TRUE(sprites.Load(L"images/carp.png")->ready);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file StateHashTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Aquarium.h>
+#include <DecorCastle.h>
+#include <DivergenceFinder.h>
+#include <SceneGenerator.h>
+#include <StateHash.h>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Generate the test scene
+ * @param aquarium Aquarium to add to
+ * @return The items
+ */
+static vector<shared_ptr<Item>> Generate(Aquarium* aquarium)
+{
+    SceneGenerator scene;
+    scene.SetCount(L"beta", 30);
+    scene.SetCount(L"carp", 30);
+    scene.SetCount(L"catfish", 30);
+    scene.SetCount(L"castle", 5);
+    return scene.Generate(aquarium);
+}
+
+TEST(StateHashTest, OrderIndependent)
+{
+    Aquarium a;
+    Generate(&a);
+
+    // The same items in the opposite order
+    AquaSnapshot snapshot;
+    a.TakeSnapshot(&snapshot);
+    reverse(snapshot.records.begin(), snapshot.records.end());
+    Aquarium b;
+    b.BeginLoad();
+    b.AddRecords(snapshot.species, snapshot.records.data(), snapshot.records.size());
+    b.EndLoad();
+
+    ASSERT_EQ(95u, b.GetItemCount());
+    ASSERT_EQ(a.GetStateHash(), b.GetStateHash());
+
+    // One fewer item is a different state
+    Aquarium c;
+    snapshot.records.pop_back();
+    c.AddRecords(snapshot.species, snapshot.records.data(), snapshot.records.size());
+    ASSERT_NE(a.GetStateHash(), c.GetStateHash());
+}
+
+TEST(StateHashTest, Quantized)
+{
+    Aquarium aquarium;
+    auto items = Generate(&aquarium);
+    auto hash = aquarium.GetStateHash();
+
+    // Far below the quantum, as a different rounding would give
+    items[7]->SetLocation(items[7]->GetX() + PositionQuantum / 1000, items[7]->GetY());
+    ASSERT_EQ(hash, aquarium.GetStateHash());
+
+    items[7]->SetLocation(items[7]->GetX() + PositionQuantum * 2, items[7]->GetY());
+    ASSERT_NE(hash, aquarium.GetStateHash());
+
+    // Behavior timers count as well as positions
+    ItemRecord record;
+    record.state[1] = 0.5;
+    auto carp = SpeciesRegistry::HashTag(L"carp");
+    auto timer = StateHash::HashItem(carp, record);
+    record.state[1] = 0.25;
+    ASSERT_NE(timer, StateHash::HashItem(carp, record));
+    ASSERT_NE(timer, StateHash::HashItem(SpeciesRegistry::HashTag(L"catfish"), record));
+}
+
+TEST(StateHashTest, Incremental)
+{
+    Aquarium aquarium;
+    Generate(&aquarium);
+    aquarium.SetStateHashing(true);
+
+    for (int i = 0; i < 30; i++)
+    {
+        aquarium.Update(0.05);
+        ASSERT_EQ(aquarium.GetStateHash(), aquarium.GetTickHash());
+    }
+}
+
+TEST(StateHashTest, NoDivergence)
+{
+    Aquarium a;
+    Aquarium b;
+    Generate(&a);
+    Generate(&b);
+
+    DivergenceFinder finder;
+    finder.SetTicks(120);
+    Divergence divergence;
+    ASSERT_TRUE(finder.Run(&a, &b, &divergence));
+    ASSERT_FALSE(divergence.found);
+}
+
+TEST(StateHashTest, Divergence)
+{
+    Aquarium a;
+    Aquarium b;
+    Generate(&a);
+    Generate(&b);
+
+    // The same tank with different random numbers goes its own way
+    b.Seed(99);
+    DivergenceFinder finder;
+    Divergence divergence;
+    ASSERT_FALSE(finder.Run(&a, &b, &divergence));
+    ASSERT_TRUE(divergence.found);
+    ASSERT_GE(divergence.tick, 1);
+    ASSERT_NE(divergence.hash[0], divergence.hash[1]);
+    ASSERT_EQ(95u, divergence.count[0]);
+    ASSERT_NE(NoItem, divergence.index[0]);
+    ASSERT_NE(NoItem, divergence.index[1]);
+    ASSERT_NE(L"castle", divergence.species[0]);
+
+    // An extra item shows at once, and only on one side
+    Aquarium c;
+    Aquarium d;
+    Generate(&c);
+    Generate(&d);
+    auto castle = make_shared<DecorCastle>(&d);
+    castle->SetLocation(123, 45);
+    d.Add(castle);
+    ASSERT_FALSE(finder.Run(&c, &d, &divergence));
+    ASSERT_EQ(0, divergence.tick);
+    ASSERT_EQ(NoItem, divergence.index[0]);
+    ASSERT_EQ(95u, divergence.index[1]);
+    ASSERT_EQ(L"castle", divergence.species[1]);
+    ASSERT_EQ(123, divergence.record[1].x);
+}
@@ -0,0 +1,67 @@
+/**
+ * @file TestHelpers.h
+ * @author Josh Thomas
+ * @brief Helpers shared by the tests that write files or need a full aquarium.
+ */
+
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+#include <Aquarium.h>
+#include <FishBeta.h>
+#include <FishCarp.h>
+#include <FishCatfish.h>
+#include <DecorCastle.h>
+#include <wx/filename.h>
+#include <memory>
+
+/**
+ * Create a path to a place to put temporary files
+ * @return Directory name
+ */
+inline wxString TempPath()
+{
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    return path;
+}
+
+/**
+ * Fill an aquarium with items of every type at distinct locations
+ * @param aquarium Aquarium to fill
+ * @param count Number of items to add
+ */
+inline void Populate(Aquarium* aquarium, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        std::shared_ptr<Item> item;
+        switch (i % 4)
+        {
+        case 0:
+            item = std::make_shared<FishBeta>(aquarium);
+            break;
+
+        case 1:
+            item = std::make_shared<FishCarp>(aquarium);
+            break;
+
+        case 2:
+            item = std::make_shared<FishCatfish>(aquarium);
+            break;
+
+        default:
+            item = std::make_shared<DecorCastle>(aquarium);
+            break;
+        }
+
+        item->SetLocation(i % 1024 + 0.25, i / 1024 + 0.5);
+        aquarium->Add(item);
+    }
+}
+
+#endif //TESTHELPERS_H
@@ -0,0 +1,176 @@
+/**
+ * @file TracerTest.cpp
+ * @author Josh Thomas
+ */
+#include <pch.h>
+#include "gtest/gtest.h"
+#include <Tracer.h>
+#include <wx/filename.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+/**
+ * Count the zones with a name
+ * @param events Events from the tracer
+ * @param name Zone name
+ * @return Number of zones
+ */
+static int CountZones(const vector<TraceEvent>& events, const char* name)
+{
+    int count = 0;
+    for (const auto& event : events)
+    {
+        if (strcmp(event.name, name) == 0)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+TEST(TracerTest, Disabled)
+{
+    Tracer::Get().Start();
+    Tracer::Get().Stop();
+    ASSERT_FALSE(Tracer::IsEnabled());
+
+    {
+        TraceZone zone("Disabled");
+    }
+
+    ASSERT_EQ(0, CountZones(Tracer::Get().GetEvents(), "Disabled"));
+}
+
+TEST(TracerTest, Threads)
+{
+    Tracer::Get().Start();
+
+    {
+        TraceZone outer("Outer");
+        TraceZone inner("Inner");
+    }
+
+    thread worker([] {
+        for (int i = 0; i < 10; i++)
+        {
+            TraceZone zone("Worker");
+        }
+    });
+    worker.join();
+
+    Tracer::Get().Stop();
+
+    vector<int> threads;
+    auto events = Tracer::Get().GetEvents(&threads);
+    ASSERT_EQ(1, CountZones(events, "Outer"));
+    ASSERT_EQ(1, CountZones(events, "Inner"));
+    ASSERT_EQ(10, CountZones(events, "Worker"));
+
+    // In the order they were entered, and on their own threads
+    int outer = -1;
+    int worker_thread = -1;
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        if (strcmp(events[i].name, "Outer") == 0)
+        {
+            outer = threads[i];
+            ASSERT_EQ(0, strcmp(events[i + 1].name, "Inner"));
+            ASSERT_GE(events[i].duration, events[i + 1].duration);
+        }
+        else if (strcmp(events[i].name, "Worker") == 0)
+        {
+            worker_thread = threads[i];
+        }
+
+        if (i > 0)
+        {
+            ASSERT_GE(events[i].start, events[i - 1].start);
+        }
+    }
+    ASSERT_NE(outer, worker_thread);
+
+    // Starting again discards the old recording
+    Tracer::Get().Start();
+    Tracer::Get().Stop();
+    ASSERT_TRUE(Tracer::Get().GetEvents().empty());
+}
+
+TEST(TracerTest, Ring)
+{
+    Tracer::Get().Start();
+    for (size_t i = 0; i < TraceBufferSize + 100; i++)
+    {
+        TraceZone zone("Ring");
+    }
+    Tracer::Get().Stop();
+
+    // Only the newest zones are kept
+    ASSERT_EQ((int)TraceBufferSize, CountZones(Tracer::Get().GetEvents(), "Ring"));
+}
+
+TEST(TracerTest, Write)
+{
+    Tracer::Get().Start();
+    {
+        TraceZone zone("Aquarium::\"Quoted\"");
+    }
+    Tracer::Get().Stop();
+
+    auto path = wxFileName::GetTempDir() + L"/aquarium";
+    if (!wxFileName::DirExists(path))
+    {
+        wxFileName::Mkdir(path);
+    }
+
+    auto filename = path + L"/trace.json";
+    ASSERT_TRUE(Tracer::Get().Write(filename));
+
+    ifstream file(filename.ToStdString());
+    stringstream json;
+    json << file.rdbuf();
+    auto text = json.str();
+
+    ASSERT_EQ(0u, text.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    ASSERT_NE(string::npos, text.find("\"name\":\"Aquarium::\\\"Quoted\\\"\",\"cat\":\"aquarium\",\"ph\":\"X\",\"ts\":0.000"));
+    ASSERT_NE(string::npos, text.find("\"ph\":\"M\""));
+    ASSERT_EQ(text.size() - 4, text.rfind("\n]}\n"));
+
+    wxRemoveFile(filename);
+}
+
+TEST(TracerTest, Reuse)
+{
+    Tracer::Get().Start();
+
+    // One thread after another shares one ring, rather than each
+    // leaving a ring of its own behind
+    for (int i = 0; i < 20; i++)
+    {
+        thread worker([] { TraceZone zone("Reuse"); });
+        worker.join();
+    }
+
+    Tracer::Get().Stop();
+
+    vector<int> threads;
+    auto events = Tracer::Get().GetEvents(&threads);
+    ASSERT_EQ(20, CountZones(events, "Reuse"));
+
+    int reused = -1;
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        if (strcmp(events[i].name, "Reuse") == 0)
+        {
+            if (reused < 0)
+            {
+                reused = threads[i];
+            }
+            ASSERT_EQ(reused, threads[i]);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file CompareRuns.cpp
+ * @author Josh Thomas
+ *
+ * Runs two aquariums side by side and reports the first tick
+ * their states differ, and the item responsible.
+ *
+ * Usage: CompareRuns [--ticks n] [--step seconds] [--seed n] a b
+ *
+ * Each of a and b is an aquarium file in any format the aquarium
+ * loads, or scene:spec to generate a scene, such as scene:beta=100.
+ * Both runs are given the same seed after loading.
+ *
+ * Exits with 0 if the runs match, 3 if they diverge.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <Aquarium.h>
+#include <DivergenceFinder.h>
+#include <SceneGenerator.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+/// Prefix of an argument that generates a scene instead of loading a file
+const char ScenePrefix[] = "scene:";
+
+/**
+ * Set up one side of the comparison
+ * @param aquarium Aquarium to set up
+ * @param source File name, or scene:spec
+ * @param seed Seed to give the aquarium
+ * @return false if the scene is not valid or the file cannot be loaded
+ */
+static bool Setup(Aquarium* aquarium, const char* source, unsigned int seed)
+{
+    if (strncmp(source, ScenePrefix, strlen(ScenePrefix)) == 0)
+    {
+        SceneGenerator scene;
+        if (!scene.Parse(wxString::FromUTF8(source + strlen(ScenePrefix))))
+        {
+            return false;
+        }
+        scene.Generate(aquarium);
+    }
+    else if (!aquarium->Load(wxString::FromUTF8(source)))
+    {
+        return false;
+    }
+
+    aquarium->Seed(seed);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "CompareRuns: could not initialize wxWidgets\n");
+        return 1;
+    }
+
+    DivergenceFinder finder;
+    unsigned int seed = DefaultSceneSeed;
+    const char* sources[2] = {nullptr, nullptr};
+    int count = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            finder.SetTicks(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--step") == 0 && i + 1 < argc)
+        {
+            finder.SetStep(atof(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        }
+        else if (count < 2)
+        {
+            sources[count++] = argv[i];
+        }
+        else
+        {
+            count = 3;
+        }
+    }
+
+    if (count != 2)
+    {
+        fprintf(stderr, "usage: CompareRuns [--ticks n] [--step seconds] [--seed n] a b\n");
+        return 2;
+    }
+
+    wxInitAllImageHandlers();
+
+    Aquarium a;
+    Aquarium b;
+    for (int run = 0; run < 2; run++)
+    {
+        if (!Setup(run == 0 ? &a : &b, sources[run], seed))
+        {
+            fprintf(stderr, "CompareRuns: unable to load %s\n", sources[run]);
+            return 2;
+        }
+    }
+
+    Divergence divergence;
+    bool same = finder.Run(&a, &b, &divergence);
+    printf("%s", (const char*)divergence.Format().ToUTF8());
+    return same ? 0 : 3;
+}
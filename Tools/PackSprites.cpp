@@ -0,0 +1,51 @@
+/**
+ * @file PackSprites.cpp
+ * @author Josh Thomas
+ *
+ * Decodes the images listed in an asset manifest into a sprite pack.
+ *
+ * Usage: PackSprites manifest pack
+ *
+ * Filenames in the manifest are relative to the working directory
+ * and are stored in the pack as written.
+ */
+
+#include "pch.h"
+#include <wx/init.h>
+#include <AssetPreloader.h>
+#include <SpritePack.h>
+#include <cstdio>
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        fprintf(stderr, "PackSprites: could not initialize wxWidgets\n");
+        return 1;
+    }
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: PackSprites manifest pack\n");
+        return 2;
+    }
+
+    wxInitAllImageHandlers();
+
+    auto files = AssetPreloader::ReadManifest(argv[1]);
+    if (files.empty())
+    {
+        fprintf(stderr, "PackSprites: no images listed in %s\n", argv[1]);
+        return 1;
+    }
+
+    if (!SpritePack::Write(files, argv[2]))
+    {
+        fprintf(stderr, "PackSprites: could not write %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("Packed %d images into %s\n", (int)files.size(), argv[2]);
+    return 0;
+}